@@ -0,0 +1,118 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file main.cpp
+ * Compares orderedTrieRoot() with the map-based trieRootOver() on blocks of many transactions,
+ * and sha3_many() with hashing the same items one by one.
+ * Usage: hash_benchmark [entries = 10000] [rounds = 20]
+ */
+
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieHash.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+
+namespace {
+
+double seconds_since( chrono::steady_clock::time_point _start ) {
+    return chrono::duration< double >( chrono::steady_clock::now() - _start ).count();
+}
+
+void report( char const* _what, size_t _count, double _seconds ) {
+    cout << _what << ": " << _count << " in " << _seconds << " s, " << _count / _seconds
+         << " per second" << endl;
+}
+
+// random items of _minSize.._maxSize bytes, as receipts or transactions are
+vector< bytes > randomItems( size_t _count, size_t _minSize, size_t _maxSize ) {
+    mt19937 random( 13 );
+    uniform_int_distribution< size_t > sizes( _minSize, _maxSize );
+    vector< bytes > ret( _count );
+    for ( bytes& item : ret ) {
+        item.resize( sizes( random ) );
+        for ( auto& b : item )
+            b = uint8_t( random() );
+    }
+    return ret;
+}
+
+void compareTrieRoots( char const* _what, vector< bytes > const& _items, size_t _rounds ) {
+    cout << _what << endl;
+
+    h256 mapRoot;
+    auto start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < _rounds; ++i )
+        mapRoot = trieRootOver(
+            _items.size(), []( unsigned _i ) { return rlp( _i ); },
+            [&_items]( unsigned _i ) { return _items[_i]; } );
+    report( "  trieRootOver", _rounds, seconds_since( start ) );
+
+    h256 orderedRoot;
+    start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < _rounds; ++i )
+        orderedRoot = orderedTrieRoot( _items );
+    report( "  orderedTrieRoot", _rounds, seconds_since( start ) );
+
+    if ( mapRoot != orderedRoot )
+        cout << "  ERROR roots differ: " << mapRoot << " " << orderedRoot << endl;
+}
+
+void compareSha3( char const* _what, vector< bytes > const& _items, size_t _rounds ) {
+    cout << _what << endl;
+
+    vector< bytesConstRef > refs;
+    for ( bytes const& item : _items )
+        refs.emplace_back( &item );
+    vector< h256 > single( refs.size() );
+    auto start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < _rounds; ++i )
+        for ( size_t j = 0; j < refs.size(); ++j )
+            single[j] = sha3( refs[j] );
+    report( "  sha3", _rounds * refs.size(), seconds_since( start ) );
+
+    vector< h256 > many( refs.size() );
+    start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < _rounds; ++i )
+        sha3_many( refs, many.data() );
+    report( "  sha3_many", _rounds * refs.size(), seconds_since( start ) );
+
+    if ( single != many )
+        cout << "  ERROR hashes differ" << endl;
+}
+
+}  // namespace
+
+int main( int argc, char** argv ) {
+    size_t const entries = argc > 1 ? stoul( argv[1] ) : 10000;
+    size_t const rounds = argc > 2 ? stoul( argv[2] ) : 20;
+
+    compareTrieRoots( "Receipts root", randomItems( entries, 200, 600 ), rounds );
+    compareTrieRoots( "Transactions root", randomItems( entries, 110, 300 ), rounds );
+    compareSha3( "Hashes of 32 bytes", randomItems( entries, 32, 32 ), rounds );
+    compareSha3( "Hashes of 100 bytes", randomItems( entries, 100, 100 ), rounds );
+    compareSha3( "Hashes of 110..300 bytes", randomItems( entries, 110, 300 ), rounds );
+    return 0;
+}
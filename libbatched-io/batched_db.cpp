@@ -9,25 +9,29 @@ batched_db::~batched_db() {
     assert( !m_batch );
 }
 
-db_operations_face* db_splitter::new_interface() {
+db_operations_face* db_splitter::new_interface(
+    std::shared_ptr< const dev::db::ValueCodec > _codec ) {
     assert( this->m_interfaces.size() < 256 );
+    assert( _codec );
 
     unsigned char prefix = this->m_interfaces.size();
 
-    db_face* pdb = new prefixed_db( prefix, m_backend );
+    db_face* pdb = new prefixed_db( prefix, m_backend, _codec );
     m_interfaces.emplace_back( pdb );
 
     return pdb;
 }
 
-db_splitter::prefixed_db::prefixed_db( char _prefix, std::shared_ptr< db_face > _backend )
-    : prefix( _prefix ), backend( _backend ) {}
+db_splitter::prefixed_db::prefixed_db( char _prefix, std::shared_ptr< db_face > _backend,
+    std::shared_ptr< const dev::db::ValueCodec > _codec )
+    : prefix( _prefix ), backend( _backend ), codec( _codec ) {}
 
 void db_splitter::prefixed_db::insert( dev::db::Slice _key, dev::db::Slice _value ) {
     std::vector< char > key2 = _key.toVector();
     key2.insert( key2.begin(), prefix );
 
-    backend->insert( dev::ref( key2 ), _value );
+    std::string const stored = codec->encode( _key, _value );
+    backend->insert( dev::ref( key2 ), dev::db::Slice( stored ) );
 }
 void db_splitter::prefixed_db::kill( dev::db::Slice _key ) {
     std::vector< char > key2 = _key.toVector();
@@ -41,7 +45,7 @@ std::string db_splitter::prefixed_db::lookup( dev::db::Slice _key ) const {
 
     std::vector< char > key2 = _key.toVector();
     key2.insert( key2.begin(), prefix );
-    return backend->lookup( dev::ref( key2 ) );
+    return codec->decode( _key, backend->lookup( dev::ref( key2 ) ) );
 }
 bool db_splitter::prefixed_db::exists( dev::db::Slice _key ) const {
     std::vector< char > key2 = _key.toVector();
@@ -55,7 +59,8 @@ void db_splitter::prefixed_db::forEach(
         if ( _key[0] != this->prefix )
             return true;
         dev::db::Slice key_short = dev::db::Slice( _key.data() + 1, _key.size() - 1 );
-        return f( key_short, _val );
+        std::string const value = codec->decode( key_short, _val.toString() );
+        return f( key_short, dev::db::Slice( value ) );
     } );
 }
 
@@ -65,7 +70,8 @@ void db_splitter::prefixed_db::forEachWithPrefix(
         if ( _key[0] != this->prefix )
             return true;
         dev::db::Slice key_short = dev::db::Slice( _key.data() + 1, _key.size() - 1 );
-        return f( key_short, _val );
+        std::string const value = codec->decode( key_short, _val.toString() );
+        return f( key_short, dev::db::Slice( value ) );
     } );
 }
 
@@ -4,6 +4,7 @@
 #include "batched_io.h"
 
 #include <libdevcore/LevelDB.h>
+#include <libdevcore/ValueCodec.h>
 
 #include <shared_mutex>
 
@@ -90,7 +91,9 @@ private:
 
 public:
     db_splitter( std::shared_ptr< db_face > _backend ) : m_backend( _backend ) {}
-    db_operations_face* new_interface();
+    // values written through the interface are encoded with _codec, and read ones are decoded,
+    // so it is needed even when no family is compressed now
+    db_operations_face* new_interface( std::shared_ptr< const dev::db::ValueCodec > _codec );
     db_face* backend() const { return m_backend.get(); }
 
 private:
@@ -98,9 +101,11 @@ private:
     private:
         char prefix;
         std::shared_ptr< db_face > backend;
+        std::shared_ptr< const dev::db::ValueCodec > codec;
 
     public:
-        prefixed_db( char _prefix, std::shared_ptr< db_face > _backend );
+        prefixed_db( char _prefix, std::shared_ptr< db_face > _backend,
+            std::shared_ptr< const dev::db::ValueCodec > _codec );
         virtual void insert( dev::db::Slice _key, dev::db::Slice _value );
         virtual void kill( dev::db::Slice _key );
         virtual void revert() { backend->revert(); }
@@ -1,5 +1,6 @@
 #include "batched_rotating_db_io.h"
 
+#include <libdevcore/ArchiveSegment.h>
 #include <libdevcore/LevelDB.h>
 
 namespace batched_io {
@@ -11,9 +12,12 @@ const std::string current_piece_mark_key =
     "ead48ec575aaa7127384dee432fc1c02d9f6a22950234e5ecf59f35ed9f6e78d";
 }
 
-rotating_db_io::rotating_db_io(
-    const boost::filesystem::path& _path, size_t _nPieces, bool _archiveMode )
-    : base_path( _path ), n_pieces( _nPieces ), archive_mode( _archiveMode ) {
+rotating_db_io::rotating_db_io( const boost::filesystem::path& _path, size_t _nPieces,
+    bool _archiveMode, bool _freezeArchive )
+    : base_path( _path ),
+      n_pieces( _nPieces ),
+      archive_mode( _archiveMode ),
+      freeze_archive( _archiveMode && _freezeArchive ) {
     // open all
     for ( size_t i = 0; i < n_pieces; ++i ) {
         boost::filesystem::path path = base_path / ( std::to_string( i ) + ".db" );
@@ -54,13 +58,21 @@ rotating_db_io::rotating_db_io(
     // open archive
     if ( archive_mode ) {
         for ( size_t i = 0;; ++i ) {
-            boost::filesystem::path path =
-                base_path / ( "archive-" + ( std::to_string( i ) + ".db" ) );
-
-            if ( !boost::filesystem::exists( path ) )
+            boost::filesystem::path path = archive_path( i, ".db" );
+            boost::filesystem::path segment_path = archive_path( i, ".seg" );
+            // left by freezing interrupted by a crash
+            boost::filesystem::remove( archive_path( i, ".seg.tmp" ) );
+
+            DatabaseFace* db;
+            if ( boost::filesystem::exists( segment_path ) ) {
+                // the segment is complete, but the piece was not removed
+                boost::filesystem::remove_all( path );
+                db = new ArchiveSegment( segment_path );
+            } else if ( boost::filesystem::exists( path ) )
+                db = new LevelDB( path );
+            else
                 break;
 
-            DatabaseFace* db = new LevelDB( path );
             pieces.emplace_back( db );
         }  // for
     }      // archive_mode
@@ -75,8 +87,7 @@ void rotating_db_io::rotate() {
     int new_archive_db_no = pieces.size() - n_pieces;
 
     boost::filesystem::path oldest_path = base_path / ( std::to_string( oldest_db_no ) + ".db" );
-    boost::filesystem::path new_archive_path =
-        base_path / ( "archive-" + ( std::to_string( new_archive_db_no ) + ".db" ) );
+    boost::filesystem::path new_archive_path = archive_path( new_archive_db_no, ".db" );
 
     pieces.erase( pieces.begin() + n_pieces - 1 );  // will delete here
 
@@ -127,6 +138,33 @@ void rotating_db_io::recover() {
     }          // for
 }
 
+const DatabaseFace* rotating_db_io::archive_piece_to_freeze( size_t& _archiveNo ) const {
+    if ( !freeze_archive )
+        return nullptr;
+    for ( size_t i = n_pieces; i < pieces.size(); ++i ) {
+        if ( dynamic_cast< const LevelDB* >( pieces[i].get() ) ) {
+            _archiveNo = i - n_pieces;
+            return pieces[i].get();
+        }
+    }
+    return nullptr;
+}
+
+bool rotating_db_io::write_archive_segment( size_t _archiveNo, const DatabaseFace& _piece,
+    const std::function< bool() >& _isCancelled ) const {
+    return ArchiveSegment::write( _piece, archive_path( _archiveNo, ".seg" ), _isCancelled );
+}
+
+boost::filesystem::path rotating_db_io::replace_with_segment( size_t _archiveNo ) {
+    pieces[n_pieces + _archiveNo].reset( new ArchiveSegment( archive_path( _archiveNo, ".seg" ) ) );
+    return archive_path( _archiveNo, ".db" );
+}
+
+boost::filesystem::path rotating_db_io::archive_path(
+    size_t _archiveNo, const std::string& _ext ) const {
+    return base_path / ( "archive-" + std::to_string( _archiveNo ) + _ext );
+}
+
 rotating_db_io::~rotating_db_io() {}
 
 }  // namespace batched_io
@@ -8,6 +8,7 @@
 #include <boost/filesystem.hpp>
 
 #include <deque>
+#include <functional>
 
 namespace batched_io {
 
@@ -19,16 +20,31 @@ private:
     size_t n_pieces;
 
     bool archive_mode;
+    // convert archive pieces to dev::db::ArchiveSegment files
+    bool freeze_archive;
     std::deque< std::unique_ptr< dev::db::DatabaseFace > > archive_pieces;
 
+    boost::filesystem::path archive_path( size_t _archiveNo, const std::string& _ext ) const;
+
 public:
     using const_iterator = std::deque< std::unique_ptr< dev::db::DatabaseFace > >::const_iterator;
 
-    rotating_db_io( const boost::filesystem::path& _path, size_t _nPieces, bool _archiveMode );
+    rotating_db_io( const boost::filesystem::path& _path, size_t _nPieces, bool _archiveMode,
+        bool _freezeArchive = false );
     const_iterator begin() const { return pieces.begin(); }
     const_iterator end() const { return pieces.end(); }
     size_t pieces_count() const { return n_pieces; }
     void rotate();
+
+    // Archive pieces are frozen one at a time: the segment is written from the LevelDB piece
+    // without locks, as rotate() never removes archive pieces, then the piece is replaced.
+    // @returns archive piece kept as LevelDB, nullptr if none or freezing is off
+    const dev::db::DatabaseFace* archive_piece_to_freeze( size_t& _archiveNo ) const;
+    // @returns false if cancelled
+    bool write_archive_segment( size_t _archiveNo, const dev::db::DatabaseFace& _piece,
+        const std::function< bool() >& _isCancelled ) const;
+    // @returns path of the replaced LevelDB, to be removed by the caller
+    boost::filesystem::path replace_with_segment( size_t _archiveNo );
     virtual void revert() { /* no need - as all write is in rotate() */
     }
     virtual void commit(
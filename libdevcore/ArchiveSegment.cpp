@@ -0,0 +1,374 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ArchiveSegment.h"
+
+#include <secp256k1_sha256.h>
+#include <zstd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File layout, integers are little-endian:
+//   blocks: zstd frames of entries {u32 key size, u32 value size, key, value}
+//   index:  u64 offset of record of every block, relative to the index start,
+//           then records {u64 block offset, u32 block size, u32 key size, first key}
+//   footer: u64 index offset, u64 blocks count, 8 bytes of c_magic
+
+namespace dev::db {
+
+namespace {
+const char c_magic[8] = { 'S', 'K', 'S', 'E', 'G', '0', '0', '1' };
+const size_t c_footerSize = 8 + 8 + sizeof( c_magic );
+// plain size of a block, values larger than that get a block of their own
+const size_t c_blockSize = 64 * 1024;
+const size_t c_maxBlockSize = size_t( 1 ) << 30;
+
+void putU32( std::string& _out, uint32_t _x ) {
+    for ( size_t i = 0; i < 4; ++i )
+        _out.push_back( char( _x >> ( 8 * i ) ) );
+}
+
+void putU64( std::string& _out, uint64_t _x ) {
+    for ( size_t i = 0; i < 8; ++i )
+        _out.push_back( char( _x >> ( 8 * i ) ) );
+}
+
+uint64_t getLE( char const* _p, size_t _bytes ) {
+    uint64_t x = 0;
+    for ( size_t i = 0; i < _bytes; ++i )
+        x |= uint64_t( uint8_t( _p[i] ) ) << ( 8 * i );
+    return x;
+}
+
+[[noreturn]] void throwCorrupted( boost::filesystem::path const& _path ) {
+    BOOST_THROW_EXCEPTION(
+        DatabaseError() << errinfo_comment( "corrupted archive segment " + _path.string() ) );
+}
+
+class SegmentWriter {
+public:
+    SegmentWriter( boost::filesystem::path const& _path, int _zstdLevel )
+        : m_path( _path ), m_zstdLevel( _zstdLevel ) {
+        m_file = std::fopen( _path.c_str(), "wb" );
+        if ( !m_file )
+            BOOST_THROW_EXCEPTION(
+                DatabaseError() << errinfo_comment( "cannot create " + _path.string() ) );
+    }
+    ~SegmentWriter() {
+        if ( m_file )
+            std::fclose( m_file );
+    }
+
+    void add( Slice _key, Slice _value ) {
+        if ( m_block.empty() )
+            m_blockFirstKey = _key.toString();
+        putU32( m_block, _key.size() );
+        putU32( m_block, _value.size() );
+        m_block.append( _key.data(), _key.size() );
+        m_block.append( _value.data(), _value.size() );
+        if ( m_block.size() >= c_blockSize )
+            flushBlock();
+    }
+
+    void finish() {
+        flushBlock();
+        uint64_t const indexOffset = m_offset;
+        std::string index;
+        for ( uint64_t recordOffset : m_recordOffsets )
+            putU64( index, m_recordOffsets.size() * 8 + recordOffset );
+        index += m_records;
+        std::string footer;
+        putU64( footer, indexOffset );
+        putU64( footer, m_recordOffsets.size() );
+        footer.append( c_magic, sizeof( c_magic ) );
+        writeRaw( index );
+        writeRaw( footer );
+
+        if ( std::fflush( m_file ) != 0 || ::fsync( ::fileno( m_file ) ) != 0 ||
+             std::fclose( m_file ) != 0 ) {
+            m_file = nullptr;
+            throwWriteError();
+        }
+        m_file = nullptr;
+    }
+
+private:
+    void flushBlock() {
+        if ( m_block.empty() )
+            return;
+        std::string compressed( ZSTD_compressBound( m_block.size() ), '\0' );
+        size_t const size = ZSTD_compress(
+            &compressed[0], compressed.size(), m_block.data(), m_block.size(), m_zstdLevel );
+        if ( ZSTD_isError( size ) )
+            BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment(
+                                       std::string( "zstd: " ) + ZSTD_getErrorName( size ) ) );
+        compressed.resize( size );
+
+        m_recordOffsets.push_back( m_records.size() );
+        putU64( m_records, m_offset );
+        putU32( m_records, compressed.size() );
+        putU32( m_records, m_blockFirstKey.size() );
+        m_records += m_blockFirstKey;
+
+        writeRaw( compressed );
+        m_block.clear();
+    }
+
+    void writeRaw( std::string const& _data ) {
+        if ( std::fwrite( _data.data(), 1, _data.size(), m_file ) != _data.size() )
+            throwWriteError();
+        m_offset += _data.size();
+    }
+
+    [[noreturn]] void throwWriteError() const {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment(
+                                   "cannot write " + m_path.string() + ": " + strerror( errno ) ) );
+    }
+
+    boost::filesystem::path const m_path;
+    int const m_zstdLevel;
+    std::FILE* m_file = nullptr;
+    uint64_t m_offset = 0;
+
+    std::string m_block;
+    std::string m_blockFirstKey;
+    std::vector< uint64_t > m_recordOffsets;
+    std::string m_records;
+};
+}  // namespace
+
+ArchiveSegment::ArchiveSegment( boost::filesystem::path const& _path ) : m_path( _path ) {
+    int const fd = ::open( _path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        BOOST_THROW_EXCEPTION(
+            DatabaseError() << errinfo_comment( "cannot open " + _path.string() ) );
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0 || size_t( st.st_size ) < c_footerSize ) {
+        ::close( fd );
+        throwCorrupted( _path );
+    }
+    m_size = st.st_size;
+    void* data = ::mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+    // the mapping does not need the descriptor
+    ::close( fd );
+    if ( data == MAP_FAILED )
+        BOOST_THROW_EXCEPTION(
+            DatabaseError() << errinfo_comment( "cannot map " + _path.string() ) );
+    m_data = static_cast< char const* >( data );
+    // lookups touch a few pages each
+    ::madvise( data, m_size, MADV_RANDOM );
+
+    char const* footer = m_data + m_size - c_footerSize;
+    m_indexOffset = getLE( footer, 8 );
+    m_blocksCount = getLE( footer + 8, 8 );
+    if ( std::memcmp( footer + 16, c_magic, sizeof( c_magic ) ) != 0 ||
+         m_indexOffset > m_size - c_footerSize ||
+         m_blocksCount > ( m_size - c_footerSize - m_indexOffset ) / 8 ) {
+        ::munmap( data, m_size );
+        throwCorrupted( _path );
+    }
+}
+
+ArchiveSegment::~ArchiveSegment() {
+    ::munmap( const_cast< char* >( m_data ), m_size );
+}
+
+bool ArchiveSegment::write( DatabaseFace const& _source, boost::filesystem::path const& _path,
+    std::function< bool() > const& _isCancelled, int _zstdLevel ) {
+    boost::filesystem::path const tmpPath = _path.string() + ".tmp";
+    bool cancelled = false;
+    {
+        SegmentWriter writer( tmpPath, _zstdLevel );
+        _source.forEach( [&]( Slice _key, Slice _value ) {
+            if ( _isCancelled && _isCancelled() ) {
+                cancelled = true;
+                return false;
+            }
+            writer.add( _key, _value );
+            return true;
+        } );
+        if ( !cancelled )
+            writer.finish();
+    }
+    if ( cancelled ) {
+        boost::filesystem::remove( tmpPath );
+        return false;
+    }
+    boost::filesystem::rename( tmpPath, _path );
+    return true;
+}
+
+std::string ArchiveSegment::lookup( Slice _key ) const {
+    std::string_view const key( _key.data(), _key.size() );
+    size_t const block = findBlock( key );
+    std::string value;
+    if ( block == m_blocksCount )
+        return value;
+    // the key cannot be in the next blocks, their first keys are greater
+    forEachFrom( block, [&]( std::string_view _k, std::string_view _v ) {
+        if ( _k == key )
+            value = _v;
+        return _k < key;
+    } );
+    return value;
+}
+
+bool ArchiveSegment::exists( Slice _key ) const {
+    std::string_view const key( _key.data(), _key.size() );
+    size_t const block = findBlock( key );
+    bool found = false;
+    if ( block == m_blocksCount )
+        return found;
+    forEachFrom( block, [&]( std::string_view _k, std::string_view ) {
+        found = _k == key;
+        return _k < key;
+    } );
+    return found;
+}
+
+void ArchiveSegment::kill( Slice ) {
+    BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "archive segment is read-only" ) );
+}
+
+void ArchiveSegment::insert( Slice, Slice ) {
+    BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "archive segment is read-only" ) );
+}
+
+std::unique_ptr< WriteBatchFace > ArchiveSegment::createWriteBatch() const {
+    BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "archive segment is read-only" ) );
+}
+
+void ArchiveSegment::commit( std::unique_ptr< WriteBatchFace > ) {
+    BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "archive segment is read-only" ) );
+}
+
+void ArchiveSegment::forEach( std::function< bool( Slice, Slice ) > f ) const {
+    forEachFrom( 0, [&]( std::string_view _key, std::string_view _value ) {
+        return f( Slice( _key.data(), _key.size() ), Slice( _value.data(), _value.size() ) );
+    } );
+}
+
+void ArchiveSegment::forEachWithPrefix(
+    std::string& _prefix, std::function< bool( Slice, Slice ) > f ) const {
+    std::string_view const prefix( _prefix );
+    size_t block = findBlock( prefix );
+    if ( block == m_blocksCount )
+        block = 0;
+    forEachFrom( block, [&]( std::string_view _key, std::string_view _value ) {
+        if ( _key < prefix )
+            return true;
+        if ( _key.substr( 0, prefix.size() ) != prefix )
+            return false;
+        return f( Slice( _key.data(), _key.size() ), Slice( _value.data(), _value.size() ) );
+    } );
+}
+
+h256 ArchiveSegment::hashBase() const {
+    secp256k1_sha256_t ctx;
+    secp256k1_sha256_initialize( &ctx );
+    forEachFrom( 0, [&]( std::string_view _key, std::string_view _value ) {
+        // skipped by LevelDB::hashBase() too
+        if ( _key == "pieceUsageBytes" )
+            return true;
+        secp256k1_sha256_write(
+            &ctx, reinterpret_cast< uint8_t const* >( _key.data() ), _key.size() );
+        secp256k1_sha256_write(
+            &ctx, reinterpret_cast< uint8_t const* >( _value.data() ), _value.size() );
+        return true;
+    } );
+    h256 hash;
+    secp256k1_sha256_finalize( &ctx, hash.data() );
+    return hash;
+}
+
+std::string_view ArchiveSegment::blockFirstKey( size_t _block ) const {
+    uint64_t const recordOffset = getLE( m_data + m_indexOffset + 8 * _block, 8 );
+    uint64_t const indexSize = m_size - c_footerSize - m_indexOffset;
+    if ( recordOffset > indexSize || indexSize - recordOffset < 16 )
+        throwCorrupted( m_path );
+    char const* record = m_data + m_indexOffset + recordOffset;
+    uint64_t const keySize = getLE( record + 12, 4 );
+    if ( indexSize - recordOffset - 16 < keySize )
+        throwCorrupted( m_path );
+    return std::string_view( record + 16, keySize );
+}
+
+size_t ArchiveSegment::findBlock( std::string_view _key ) const {
+    // first block whose first key is greater than _key
+    size_t low = 0, high = m_blocksCount;
+    while ( low < high ) {
+        size_t const middle = ( low + high ) / 2;
+        if ( blockFirstKey( middle ) <= _key )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low == 0 ? m_blocksCount : low - 1;
+}
+
+std::string ArchiveSegment::readBlock( size_t _block ) const {
+    // the record is checked by blockFirstKey()
+    blockFirstKey( _block );
+    char const* record = m_data + m_indexOffset + getLE( m_data + m_indexOffset + 8 * _block, 8 );
+    uint64_t const offset = getLE( record, 8 );
+    uint64_t const size = getLE( record + 8, 4 );
+    if ( offset > m_indexOffset || m_indexOffset - offset < size )
+        throwCorrupted( m_path );
+
+    unsigned long long const plainSize = ZSTD_getFrameContentSize( m_data + offset, size );
+    if ( plainSize == ZSTD_CONTENTSIZE_ERROR || plainSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+         plainSize > c_maxBlockSize )
+        throwCorrupted( m_path );
+    std::string plain( plainSize, '\0' );
+    size_t const n = ZSTD_decompress( &plain[0], plain.size(), m_data + offset, size );
+    if ( ZSTD_isError( n ) || n != plainSize )
+        throwCorrupted( m_path );
+    return plain;
+}
+
+void ArchiveSegment::forEachFrom( size_t _firstBlock,
+    std::function< bool( std::string_view, std::string_view ) > _fn ) const {
+    for ( size_t block = _firstBlock; block < m_blocksCount; ++block ) {
+        std::string const plain = readBlock( block );
+        for ( size_t pos = 0; pos < plain.size(); ) {
+            if ( plain.size() - pos < 8 )
+                throwCorrupted( m_path );
+            uint64_t const keySize = getLE( plain.data() + pos, 4 );
+            uint64_t const valueSize = getLE( plain.data() + pos + 4, 4 );
+            pos += 8;
+            if ( plain.size() - pos < keySize + valueSize )
+                throwCorrupted( m_path );
+            std::string_view const key( plain.data() + pos, keySize );
+            std::string_view const value( plain.data() + pos + keySize, valueSize );
+            pos += keySize + valueSize;
+            if ( !_fn( key, value ) )
+                return;
+        }
+    }
+}
+
+}  // namespace dev::db
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Immutable compressed file of database entries.
+ */
+
+#pragma once
+
+#include "db.h"
+
+#include <boost/filesystem.hpp>
+
+#include <functional>
+#include <string_view>
+
+namespace dev::db {
+
+/// Read-only database in one immutable file, the cold tier of rotated database pieces.
+/// Entries are sorted by key and grouped into zstd-compressed blocks of about 64 KiB. A sparse
+/// index holds the first key of every block. The file is memory-mapped, so an open segment
+/// holds no file descriptor and no caches besides the page cache.
+class ArchiveSegment : public DatabaseFace {
+public:
+    explicit ArchiveSegment( boost::filesystem::path const& _path );
+    ~ArchiveSegment();
+
+    /// Writes all entries of _source to _path. _source must iterate keys in bytewise order,
+    /// as LevelDB does. The file appears at _path only when it is complete.
+    /// @returns false if _isCancelled returned true, nothing is written then
+    static bool write( DatabaseFace const& _source, boost::filesystem::path const& _path,
+        std::function< bool() > const& _isCancelled = {}, int _zstdLevel = 3 );
+
+    std::string lookup( Slice _key ) const override;
+    bool exists( Slice _key ) const override;
+    /// Modifications throw DatabaseError, a segment is immutable
+    void kill( Slice _key ) override;
+    void insert( Slice _key, Slice _value ) override;
+    std::unique_ptr< WriteBatchFace > createWriteBatch() const override;
+    void commit( std::unique_ptr< WriteBatchFace > _batch ) override;
+
+    void forEach( std::function< bool( Slice, Slice ) > f ) const override;
+    void forEachWithPrefix(
+        std::string& _prefix, std::function< bool( Slice, Slice ) > f ) const override;
+
+    /// The same as LevelDB::hashBase() of the source database
+    h256 hashBase() const override;
+
+private:
+    std::string_view blockFirstKey( size_t _block ) const;
+    // @returns index of the last block whose first key is not greater than _key, or
+    // blocks count if there is no such block
+    size_t findBlock( std::string_view _key ) const;
+    std::string readBlock( size_t _block ) const;
+    // calls _fn( key, value ) for entries of blocks starting from _firstBlock until it
+    // returns false
+    void forEachFrom(
+        size_t _firstBlock, std::function< bool( std::string_view, std::string_view ) > _fn ) const;
+
+    boost::filesystem::path const m_path;
+    char const* m_data = nullptr;
+    size_t m_size = 0;
+    uint64_t m_indexOffset = 0;
+    uint64_t m_blocksCount = 0;
+};
+
+}  // namespace dev::db
@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "KeyFilter.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+
+namespace dev::db {
+
+namespace {
+// 10 bits per key give 1% false positives, each next stage gets 2 bits more and halves that
+const size_t c_bitsPerKey = 10;
+const size_t c_bitsPerKeyIncrement = 2;
+
+uint64_t mix( uint64_t _x ) {
+    _x ^= _x >> 33;
+    _x *= 0xff51afd7ed558ccdULL;
+    _x ^= _x >> 33;
+    return _x;
+}
+
+// calls _fn( word, mask ) for every bit of _hash in _words
+template < class Words, class Fn >
+void forEachBit( Words& _words, unsigned _probes, uint64_t _hash, Fn&& _fn ) {
+    uint64_t const bits = _words.size() * 64;
+    uint64_t const step = mix( _hash ) | 1;
+    uint64_t h = _hash;
+    for ( unsigned i = 0; i < _probes; ++i, h += step ) {
+        uint64_t const bit = h % bits;
+        _fn( _words[bit / 64], uint64_t( 1 ) << ( bit % 64 ) );
+    }
+}
+}  // namespace
+
+KeyFilter::KeyFilter( size_t _initialCapacity ) {
+    addStage( std::max< size_t >( _initialCapacity, 64 ) );
+}
+
+uint64_t KeyFilter::hash( Slice _key ) {
+    return mix( std::hash< std::string_view >()( std::string_view( _key.data(), _key.size() ) ) );
+}
+
+void KeyFilter::add( uint64_t _hash ) {
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    if ( m_stages.back().count >= m_stages.back().capacity )
+        addStage( m_stages.back().capacity * 2 );
+    Stage& stage = m_stages.back();
+    forEachBit( stage.words, stage.probes, _hash,
+        []( uint64_t& _word, uint64_t _mask ) { _word |= _mask; } );
+    ++stage.count;
+}
+
+bool KeyFilter::mayContain( uint64_t _hash ) const {
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    for ( Stage const& stage : m_stages ) {
+        bool all = true;
+        forEachBit( stage.words, stage.probes, _hash,
+            [&all]( uint64_t const& _word, uint64_t _mask ) { all = all && ( _word & _mask ); } );
+        if ( all )
+            return true;
+    }
+    return false;
+}
+
+size_t KeyFilter::memoryUsage() const {
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    size_t size = 0;
+    for ( Stage const& stage : m_stages )
+        size += stage.words.size() * sizeof( uint64_t );
+    return size;
+}
+
+// must be called under unique lock of m_mutex or from constructor
+void KeyFilter::addStage( size_t _capacity ) {
+    size_t const bitsPerKey = c_bitsPerKey + c_bitsPerKeyIncrement * m_stages.size();
+    Stage stage;
+    stage.words.resize( ( _capacity * bitsPerKey + 63 ) / 64 );
+    // optimal count of probes is bits per key * ln 2
+    stage.probes = bitsPerKey * 69 / 100;
+    stage.capacity = _capacity;
+    m_stages.push_back( std::move( stage ) );
+}
+
+}  // namespace dev::db
@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * In-memory membership filter of database keys.
+ */
+
+#pragma once
+
+#include "db.h"
+
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+namespace dev::db {
+
+/// Bloom filter of keys that grows with the count of added ones: when a stage is full, a twice
+/// larger and a bit more precise stage is added, so false positive rate stays within 2% for any
+/// count of keys.
+/// Keys are never removed, so the filter of a database with killed keys is a superset.
+/// Thread-safe.
+class KeyFilter {
+public:
+    explicit KeyFilter( size_t _initialCapacity = 1 << 16 );
+
+    static uint64_t hash( Slice _key );
+
+    void add( uint64_t _hash );
+    void add( Slice _key ) { add( hash( _key ) ); }
+    /// false means the key was never added
+    bool mayContain( uint64_t _hash ) const;
+    bool mayContain( Slice _key ) const { return mayContain( hash( _key ) ); }
+
+    size_t memoryUsage() const;
+
+private:
+    struct Stage {
+        std::vector< uint64_t > words;
+        unsigned probes;
+        size_t capacity;
+        size_t count = 0;
+    };
+
+    void addStage( size_t _capacity );
+
+    mutable std::shared_mutex m_mutex;
+    std::vector< Stage > m_stages;
+};
+
+}  // namespace dev::db
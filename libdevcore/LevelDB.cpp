@@ -344,7 +344,8 @@ h256 LevelDB::hashBaseWithPrefix( char _prefix ) const {
     return hash;
 }
 
-bool LevelDB::hashBasePartially( secp256k1_sha256_t* ctx, std::string& lastHashedKey ) const {
+bool LevelDB::hashBasePartially( secp256k1_sha256_t* ctx, std::string& lastHashedKey,
+    std::function< void( std::string& ) > const& _normalizeValue ) const {
     SharedDBGuard lock( *this );
     std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
     if ( it == nullptr ) {
@@ -364,6 +365,8 @@ bool LevelDB::hashBasePartially( secp256k1_sha256_t* ctx, std::string& lastHashe
         // TODO Move this logic to separate compatiliblity layer
         if ( keyTmp == "pieceUsageBytes" )
             continue;
+        if ( _normalizeValue )
+            _normalizeValue( valueTmp );
         std::string keyValue = keyTmp + valueTmp;
         const std::vector< uint8_t > usc( keyValue.begin(), keyValue.end() );
         bytesConstRef strKeyValue( usc.data(), usc.size() );
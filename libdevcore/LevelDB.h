@@ -61,7 +61,9 @@ public:
     h256 hashBase() const override;
     h256 hashBaseWithPrefix( char _prefix ) const;
 
-    bool hashBasePartially( secp256k1_sha256_t* ctx, std::string& lastHashedKey ) const;
+    /// _normalizeValue is applied to values before they are hashed
+    bool hashBasePartially( secp256k1_sha256_t* ctx, std::string& lastHashedKey,
+        std::function< void( std::string& ) > const& _normalizeValue = nullptr ) const;
 
     void doCompaction() const;
 
@@ -1,26 +1,91 @@
 #include "ManuallyRotatingLevelDB.h"
 
+#include "Log.h"
+
 #include <secp256k1_sha256.h>
 
+#include <algorithm>
+
 namespace dev {
 namespace db {
 
 using namespace batched_io;
 
-ManuallyRotatingLevelDB::ManuallyRotatingLevelDB( std::shared_ptr< rotating_db_io > _io_backend )
-    : io_backend( _io_backend ) {}
+namespace {
+// remembers inserted keys to add them to the filter of the current piece on commit
+class FilteredWriteBatch : public WriteBatchFace {
+public:
+    explicit FilteredWriteBatch( std::unique_ptr< WriteBatchFace > _batch )
+        : batch( std::move( _batch ) ) {}
+
+    void insert( Slice _key, Slice _value ) override {
+        keyHashes.push_back( KeyFilter::hash( _key ) );
+        batch->insert( _key, _value );
+    }
+    void kill( Slice _key ) override { batch->kill( _key ); }
+
+    std::unique_ptr< WriteBatchFace > batch;
+    std::vector< uint64_t > keyHashes;
+};
+
+// memory usage of a filter being built is checked once per this many keys
+const size_t c_filterMemoryCheckInterval = 4096;
+}  // namespace
+
+// about 1 byte per key
+const size_t ManuallyRotatingLevelDB::c_defaultMaxArchiveFiltersMemory = size_t( 512 ) << 20;
+
+ManuallyRotatingLevelDB::ManuallyRotatingLevelDB(
+    std::shared_ptr< rotating_db_io > _io_backend, size_t _maxArchiveFiltersMemory )
+    : io_backend( _io_backend ), m_maxArchiveFiltersMemory( _maxArchiveFiltersMemory ) {
+    for ( auto it = io_backend->begin(); it != io_backend->end(); ++it )
+        filters.push_back( std::make_shared< PieceFilter >() );
+    m_backgroundThread = std::thread( &ManuallyRotatingLevelDB::backgroundThread, this );
+}
+
+ManuallyRotatingLevelDB::~ManuallyRotatingLevelDB() {
+    {
+        std::lock_guard< std::mutex > lock( m_backgroundMutex );
+        m_stopBackground = true;
+    }
+    m_backgroundCondition.notify_one();
+    m_backgroundThread.join();
+}
 
 void ManuallyRotatingLevelDB::rotate() {
+    m_rotationWaiting = true;
     std::unique_lock< std::shared_mutex > lock( m_mutex );
+    m_rotationWaiting = false;
     assert( this->batch_cache.empty() );
     io_backend->rotate();
+    {
+        std::lock_guard< std::mutex > backgroundLock( m_backgroundMutex );
+        m_rotated = true;
+    }
+    m_backgroundCondition.notify_one();
+
+    // the same as rotating_db_io::rotate(): the oldest piece is removed or moved to the end
+    // as an archive one, and a new empty piece becomes the first
+    size_t const oldest = io_backend->pieces_count() - 1;
+    std::shared_ptr< PieceFilter > oldestFilter = filters[oldest];
+    filters.erase( filters.begin() + oldest );
+    if ( filters.size() + 1 < size_t( io_backend->end() - io_backend->begin() ) )
+        filters.push_back( oldestFilter );
+    auto newFilter = std::make_shared< PieceFilter >();
+    newFilter->ready = true;
+    filters.push_front( newFilter );
+    assert( filters.size() == size_t( io_backend->end() - io_backend->begin() ) );
 }
 
 std::string ManuallyRotatingLevelDB::lookup( Slice _key ) const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
 
-    for ( const auto& p : *io_backend ) {
-        const std::string& v = p->lookup( _key );
+    uint64_t const keyHash = KeyFilter::hash( _key );
+    size_t i = 0;
+    for ( auto it = io_backend->begin(); it != io_backend->end(); ++it, ++i ) {
+        if ( !mayContain( i, keyHash ) )
+            continue;
+        const std::string& v = ( *it )->lookup( _key );
         if ( !v.empty() )
             return v;
     }
@@ -30,8 +95,10 @@ std::string ManuallyRotatingLevelDB::lookup( Slice _key ) const {
 bool ManuallyRotatingLevelDB::exists( Slice _key ) const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
 
-    for ( const auto& p : *io_backend ) {
-        if ( p->exists( _key ) )
+    uint64_t const keyHash = KeyFilter::hash( _key );
+    size_t i = 0;
+    for ( auto it = io_backend->begin(); it != io_backend->end(); ++it, ++i ) {
+        if ( mayContain( i, keyHash ) && ( *it )->exists( _key ) )
             return true;
     }
     return false;
@@ -39,25 +106,40 @@ bool ManuallyRotatingLevelDB::exists( Slice _key ) const {
 
 void ManuallyRotatingLevelDB::insert( Slice _key, Slice _value ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
+    // before the key can be found in the piece
+    filters.front()->keys.add( _key );
     currentPiece()->insert( _key, _value );
 }
 
 void ManuallyRotatingLevelDB::kill( Slice _key ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
-    for ( const auto& p : *io_backend )
-        p->kill( _key );
+    uint64_t const keyHash = KeyFilter::hash( _key );
+    size_t i = 0;
+    for ( auto it = io_backend->begin(); it != io_backend->end(); ++it, ++i ) {
+        // frozen archive pieces are read-only and throw, so only those having the key are
+        // touched
+        if ( i < io_backend->pieces_count() ||
+             ( mayContain( i, keyHash ) && ( *it )->exists( _key ) ) )
+            ( *it )->kill( _key );
+    }
 }
 
 std::unique_ptr< WriteBatchFace > ManuallyRotatingLevelDB::createWriteBatch() const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
-    std::unique_ptr< WriteBatchFace > wbf = currentPiece()->createWriteBatch();
+    std::unique_ptr< WriteBatchFace > wbf =
+        std::make_unique< FilteredWriteBatch >( currentPiece()->createWriteBatch() );
     batch_cache.insert( wbf.get() );
     return wbf;
 }
 void ManuallyRotatingLevelDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
     batch_cache.erase( _batch.get() );
-    currentPiece()->commit( std::move( _batch ) );
+    auto* filtered = dynamic_cast< FilteredWriteBatch* >( _batch.get() );
+    assert( filtered );
+    // before the keys can be found in the piece
+    for ( uint64_t keyHash : filtered->keyHashes )
+        filters.front()->keys.add( keyHash );
+    currentPiece()->commit( std::move( filtered->batch ) );
 }
 
 void ManuallyRotatingLevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
@@ -75,6 +157,123 @@ void ManuallyRotatingLevelDB::forEachWithPrefix(
     }
 }
 
+void ManuallyRotatingLevelDB::doCompaction() const {
+    // the lock keeps pieces from being replaced by frozen ones meanwhile
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    for ( const auto& p : *io_backend ) {
+        if ( auto ldb = dynamic_cast< const LevelDB* >( p.get() ) )
+            ldb->doCompaction();
+    }
+}
+
+void ManuallyRotatingLevelDB::backgroundThread() {
+    setThreadName( "rotdbBackground" );
+    try {
+        buildFilters();
+        for ( ;; ) {
+            freezeArchivePieces();
+            std::unique_lock< std::mutex > lock( m_backgroundMutex );
+            m_backgroundCondition.wait( lock, [this]() { return m_stopBackground || m_rotated; } );
+            if ( m_stopBackground )
+                return;
+            m_rotated = false;
+        }
+    } catch ( std::exception const& ex ) {
+        // pieces without filters are probed on every lookup, not frozen ones stay LevelDB
+        cwarn << "Background work of rotating DB has failed: " << ex.what();
+    }
+}
+
+void ManuallyRotatingLevelDB::buildFilters() {
+    size_t archiveFiltersMemory = 0;
+    // archive filters that did not fit into m_maxArchiveFiltersMemory
+    std::set< PieceFilter const* > skipped;
+    while ( !m_stopBackground ) {
+        std::shared_lock< std::shared_mutex > lock( m_mutex );
+        auto it = std::find_if( filters.begin(), filters.end(),
+            [&skipped]( std::shared_ptr< PieceFilter > const& _filter ) {
+                return !_filter->ready && !skipped.count( _filter.get() );
+            } );
+        if ( it == filters.end() )
+            return;
+
+        std::shared_ptr< PieceFilter > const filter = *it;
+        size_t const index = it - filters.begin();
+        DatabaseFace const* piece = ( io_backend->begin() + index )->get();
+        // archive pieces are never removed by rotate(), and are replaced by this thread only,
+        // so they are scanned without the lock. The other pieces are scanned under it until
+        // rotation waits, and scanned again later
+        bool const isArchive = index >= io_backend->pieces_count();
+        if ( isArchive )
+            lock.unlock();
+
+        bool overLimit = false;
+        size_t count = 0;
+        piece->forEach( [&]( Slice _key, Slice ) {
+            filter->keys.add( _key );
+            if ( isArchive && ++count % c_filterMemoryCheckInterval == 0 &&
+                 archiveFiltersMemory + filter->keys.memoryUsage() > m_maxArchiveFiltersMemory )
+                overLimit = true;
+            return !overLimit && !m_stopBackground && ( isArchive || !m_rotationWaiting );
+        } );
+        if ( m_stopBackground )
+            return;
+
+        if ( isArchive && !overLimit ) {
+            overLimit =
+                archiveFiltersMemory + filter->keys.memoryUsage() > m_maxArchiveFiltersMemory;
+        }
+        if ( overLimit ) {
+            // keys added so far are dropped, the piece is always probed
+            std::unique_lock< std::shared_mutex > writeLock( m_mutex );
+            auto skippedIt = std::find( filters.begin(), filters.end(), filter );
+            *skippedIt = std::make_shared< PieceFilter >();
+            skipped.insert( skippedIt->get() );
+            writeLock.unlock();
+            clog( VerbosityInfo, "rotating-db" )
+                << "Archive piece " << index - io_backend->pieces_count()
+                << " is left without key filter, filters take "
+                << archiveFiltersMemory << " bytes";
+            continue;
+        }
+        if ( !isArchive && m_rotationWaiting ) {
+            lock.unlock();
+            while ( m_rotationWaiting && !m_stopBackground )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            continue;
+        }
+
+        filter->ready = true;
+        if ( isArchive )
+            archiveFiltersMemory += filter->keys.memoryUsage();
+    }
+}
+
+void ManuallyRotatingLevelDB::freezeArchivePieces() {
+    while ( !m_stopBackground ) {
+        size_t archiveNo;
+        const DatabaseFace* piece;
+        {
+            std::shared_lock< std::shared_mutex > lock( m_mutex );
+            piece = io_backend->archive_piece_to_freeze( archiveNo );
+        }
+        if ( !piece )
+            return;
+
+        // may take minutes, so it runs without the lock
+        clog( VerbosityInfo, "rotating-db" ) << "Freezing archive piece " << archiveNo;
+        if ( !io_backend->write_archive_segment(
+                 archiveNo, *piece, [this]() { return m_stopBackground.load(); } ) )
+            return;
+
+        boost::filesystem::path oldPath;
+        {
+            std::unique_lock< std::shared_mutex > lock( m_mutex );
+            oldPath = io_backend->replace_with_segment( archiveNo );
+        }
+        boost::filesystem::remove_all( oldPath );
+    }
+}
 
 h256 ManuallyRotatingLevelDB::hashBase() const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
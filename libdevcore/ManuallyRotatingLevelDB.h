@@ -1,26 +1,63 @@
 #ifndef ROTATINGLEVELDB_H
 #define ROTATINGLEVELDB_H
 
+#include "KeyFilter.h"
 #include "LevelDB.h"
 
 #include <libbatched-io/batched_rotating_db_io.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
+#include <thread>
 
 namespace dev {
 namespace db {
 
+/// Every piece has an in-memory filter of its keys, so lookups and exists() skip pieces that
+/// cannot have the key, and a miss usually costs no LevelDB reads. Filters of pieces found on
+/// disk are built by a background thread, until then such pieces are always probed.
+/// Archive pieces get filters while these take less than a memory limit, the rest are probed.
+/// The same thread freezes archive pieces, if enabled in rotating_db_io.
 class ManuallyRotatingLevelDB : public DatabaseFace {
 private:
+    struct PieceFilter {
+        KeyFilter keys;
+        std::atomic< bool > ready{ false };
+    };
+
     std::shared_ptr< batched_io::rotating_db_io > io_backend;
+    // in the order of io_backend pieces
+    std::deque< std::shared_ptr< PieceFilter > > filters;
 
     mutable std::set< WriteBatchFace* > batch_cache;
     mutable std::shared_mutex m_mutex;
+    // rotate() is waiting for m_mutex, scans of pieces holding it should stop
+    std::atomic< bool > m_rotationWaiting{ false };
+    size_t const m_maxArchiveFiltersMemory;
+
+    std::atomic< bool > m_stopBackground{ false };
+    std::mutex m_backgroundMutex;
+    std::condition_variable m_backgroundCondition;
+    bool m_rotated = false;
+    std::thread m_backgroundThread;
+
+    void backgroundThread();
+    void buildFilters();
+    void freezeArchivePieces();
+    bool mayContain( size_t _piece, uint64_t _keyHash ) const {
+        return !filters[_piece]->ready || filters[_piece]->keys.mayContain( _keyHash );
+    }
 
 public:
-    ManuallyRotatingLevelDB( std::shared_ptr< batched_io::rotating_db_io > _io_backend );
+    static const size_t c_defaultMaxArchiveFiltersMemory;
+
+    ManuallyRotatingLevelDB( std::shared_ptr< batched_io::rotating_db_io > _io_backend,
+        size_t _maxArchiveFiltersMemory = c_defaultMaxArchiveFiltersMemory );
+    virtual ~ManuallyRotatingLevelDB();
     void rotate();
     size_t piecesCount() const { return io_backend->pieces_count(); }
     DatabaseFace* currentPiece() const { return io_backend->begin()->get(); }
@@ -45,6 +82,9 @@ public:
         std::string& _prefix, std::function< bool( Slice, Slice ) > f ) const;
 
     virtual h256 hashBase() const;
+
+    /// Compacts pieces kept as LevelDB, frozen archive pieces need no compaction
+    void doCompaction() const;
 };
 
 }  // namespace db
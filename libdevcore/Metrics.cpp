@@ -0,0 +1,193 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+namespace dev::metrics {
+
+constexpr std::array< double, 19 > Histogram::c_bounds;
+
+const size_t Registry::c_maxSeriesPerMetric = 1000;
+
+void Histogram::observe( double _seconds ) {
+    size_t const index =
+        std::lower_bound( c_bounds.begin(), c_bounds.end(), _seconds ) - c_bounds.begin();
+    m_buckets[index].fetch_add( 1, std::memory_order_relaxed );
+    m_count.fetch_add( 1, std::memory_order_relaxed );
+    if ( _seconds > 0 )
+        m_sumNanoseconds.fetch_add(
+            static_cast< uint64_t >( _seconds * 1e9 ), std::memory_order_relaxed );
+}
+
+std::array< uint64_t, Histogram::c_bounds.size() + 1 > Histogram::buckets() const {
+    std::array< uint64_t, c_bounds.size() + 1 > result;
+    for ( size_t i = 0; i < result.size(); ++i )
+        result[i] = m_buckets[i].load( std::memory_order_relaxed );
+    return result;
+}
+
+double Histogram::sum() const {
+    return m_sumNanoseconds.load( std::memory_order_relaxed ) / 1e9;
+}
+
+Registry& Registry::instance() {
+    static Registry registry;
+    return registry;
+}
+
+std::string Registry::formatLabels( Labels const& _labels ) {
+    if ( _labels.empty() )
+        return {};
+    std::string result = "{";
+    for ( auto const& [name, value] : _labels ) {
+        if ( result.size() > 1 )
+            result += ',';
+        result += name + "=\"";
+        for ( char c : value ) {
+            if ( c == '\\' || c == '"' )
+                result += '\\';
+            if ( c == '\n' )
+                result += "\\n";
+            else
+                result += c;
+        }
+        result += '"';
+    }
+    return result + "}";
+}
+
+Registry::Series& Registry::findOrAddSeries(
+    std::string const& _name, std::string const& _help, Type _type, Labels const& _labels ) {
+    {
+        std::shared_lock< std::shared_mutex > lock( m_mutex );
+        auto itFamily = m_families.find( _name );
+        if ( itFamily != m_families.end() ) {
+            auto itSeries = itFamily->second.series.find( formatLabels( _labels ) );
+            if ( itSeries != itFamily->second.series.end() )
+                return itSeries->second;
+        }
+    }
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    return addSeries( _name, _help, _type, _labels );
+}
+
+Registry::Series& Registry::addSeries(
+    std::string const& _name, std::string const& _help, Type _type, Labels const& _labels ) {
+    Family& family = m_families[_name];
+    if ( family.series.empty() ) {
+        family.type = _type;
+        family.help = _help;
+    }
+    std::string key = formatLabels( _labels );
+    if ( family.series.count( key ) == 0 && family.series.size() >= c_maxSeriesPerMetric ) {
+        Labels other = _labels;
+        for ( auto& label : other )
+            label.second = "other";
+        key = formatLabels( other );
+    }
+    Series& series = family.series[key];
+    // created under the exclusive lock, so readers never see a series without its object
+    if ( _type == Type::Counter && !series.counter )
+        series.counter.reset( new Counter );
+    if ( _type == Type::Histogram && !series.histogram )
+        series.histogram.reset( new Histogram );
+    return series;
+}
+
+Counter& Registry::counter(
+    std::string const& _name, std::string const& _help, Labels const& _labels ) {
+    return *findOrAddSeries( _name, _help, Type::Counter, _labels ).counter;
+}
+
+Histogram& Registry::histogram(
+    std::string const& _name, std::string const& _help, Labels const& _labels ) {
+    return *findOrAddSeries( _name, _help, Type::Histogram, _labels ).histogram;
+}
+
+void Registry::gauge( std::string const& _name, std::string const& _help, Labels const& _labels,
+    std::function< double() > _value ) {
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    addSeries( _name, _help, Type::Gauge, _labels ).gauge = std::move( _value );
+}
+
+void Registry::counterFunction( std::string const& _name, std::string const& _help,
+    Labels const& _labels, std::function< double() > _value ) {
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    Series& series = addSeries( _name, _help, Type::Counter, _labels );
+    series.counter.reset();
+    series.gauge = std::move( _value );
+}
+
+void Registry::removeGauge( std::string const& _name, Labels const& _labels ) {
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    auto itFamily = m_families.find( _name );
+    if ( itFamily == m_families.end() )
+        return;
+    auto itSeries = itFamily->second.series.find( formatLabels( _labels ) );
+    // counters and histograms may be referenced by callers, they are never removed
+    if ( itSeries == itFamily->second.series.end() || !itSeries->second.gauge )
+        return;
+    itFamily->second.series.erase( itSeries );
+    if ( itFamily->second.series.empty() )
+        m_families.erase( itFamily );
+}
+
+std::string Registry::exposition() const {
+    std::ostringstream out;
+    out.precision( 10 );
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    for ( auto const& [name, family] : m_families ) {
+        char const* type = family.type == Type::Counter ? "counter" :
+                           family.type == Type::Gauge   ? "gauge" :
+                                                          "histogram";
+        out << "# HELP " << name << ' ' << family.help << '\n';
+        out << "# TYPE " << name << ' ' << type << '\n';
+        for ( auto const& [labels, series] : family.series ) {
+            if ( series.counter )
+                out << name << labels << ' ' << series.counter->value() << '\n';
+            else if ( series.gauge )
+                out << name << labels << ' ' << series.gauge() << '\n';
+            else if ( series.histogram ) {
+                // le label goes after the series own labels
+                std::string const prefix =
+                    labels.empty() ? "{" : labels.substr( 0, labels.size() - 1 ) + ",";
+                auto const buckets = series.histogram->buckets();
+                uint64_t cumulative = 0;
+                for ( size_t i = 0; i < Histogram::c_bounds.size(); ++i ) {
+                    cumulative += buckets[i];
+                    out << name << "_bucket" << prefix << "le=\"" << Histogram::c_bounds[i]
+                        << "\"} " << cumulative << '\n';
+                }
+                cumulative += buckets.back();
+                out << name << "_bucket" << prefix << "le=\"+Inf\"} " << cumulative << '\n';
+                out << name << "_sum" << labels << ' ' << series.histogram->sum() << '\n';
+                out << name << "_count" << labels << ' ' << cumulative << '\n';
+            }
+        }
+    }
+    return out.str();
+}
+
+}  // namespace dev::metrics
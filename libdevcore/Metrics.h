@@ -0,0 +1,125 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Process-wide registry of metrics exposed in Prometheus text format.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dev::metrics {
+
+using Labels = std::vector< std::pair< std::string, std::string > >;
+
+class Counter {
+public:
+    void inc( uint64_t _n = 1 ) { m_value.fetch_add( _n, std::memory_order_relaxed ); }
+    uint64_t value() const { return m_value.load( std::memory_order_relaxed ); }
+
+private:
+    std::atomic< uint64_t > m_value{ 0 };
+};
+
+/// Latency histogram with fixed 1-2-5 bucket bounds from 50 us to 60 s.
+/// Bounds are fixed so that rates of buckets can be compared between scrapes.
+class Histogram {
+public:
+    static constexpr std::array< double, 19 > c_bounds = { 0.00005, 0.0001, 0.0002, 0.0005,
+        0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 30, 60 };
+
+    void observe( double _seconds );
+
+    /// @returns count of observations in each bucket (not cumulative), the last one is +Inf
+    std::array< uint64_t, c_bounds.size() + 1 > buckets() const;
+    uint64_t count() const { return m_count.load( std::memory_order_relaxed ); }
+    double sum() const;
+
+private:
+    std::array< std::atomic< uint64_t >, c_bounds.size() + 1 > m_buckets{};
+    std::atomic< uint64_t > m_count{ 0 };
+    std::atomic< uint64_t > m_sumNanoseconds{ 0 };
+};
+
+/// Counters and histograms are created once and live until the end of the process, so
+/// references returned by the registry can be cached by callers. Lookups take a shared lock,
+/// hot paths should cache. A metric name must always be used with the same type.
+/// Each metric name holds at most c_maxSeriesPerMetric label sets, further ones are merged
+/// into a series whose label values are all "other".
+class Registry {
+public:
+    static Registry& instance();
+
+    Counter& counter(
+        std::string const& _name, std::string const& _help, Labels const& _labels = {} );
+    Histogram& histogram(
+        std::string const& _name, std::string const& _help, Labels const& _labels = {} );
+    /// _value is called on every scrape, it must stay valid until removeGauge()
+    void gauge( std::string const& _name, std::string const& _help, Labels const& _labels,
+        std::function< double() > _value );
+    /// The same as gauge() for a monotonic value that is counted elsewhere
+    void counterFunction( std::string const& _name, std::string const& _help,
+        Labels const& _labels, std::function< double() > _value );
+    /// Removes a series registered by gauge() or counterFunction()
+    void removeGauge( std::string const& _name, Labels const& _labels = {} );
+
+    /// @returns all metrics in Prometheus text exposition format
+    std::string exposition() const;
+
+    static const size_t c_maxSeriesPerMetric;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        std::unique_ptr< Counter > counter;
+        std::unique_ptr< Histogram > histogram;
+        std::function< double() > gauge;
+    };
+
+    struct Family {
+        Type type;
+        std::string help;
+        // key is formatted label set, e.g. {method="eth_call"}
+        std::map< std::string, Series > series;
+    };
+
+    Registry() = default;
+
+    Series& findOrAddSeries(
+        std::string const& _name, std::string const& _help, Type _type, Labels const& _labels );
+    // must be called under the exclusive lock
+    Series& addSeries(
+        std::string const& _name, std::string const& _help, Type _type, Labels const& _labels );
+
+    static std::string formatLabels( Labels const& _labels );
+
+    mutable std::shared_mutex m_mutex;
+    std::map< std::string, Family > m_families;
+};
+
+}  // namespace dev::metrics
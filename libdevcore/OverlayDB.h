@@ -56,6 +56,9 @@ public:
 
     bytes lookupAux( h256 const& _h ) const;
 
+    /// Persistent database shared by all copies of this overlay.
+    std::shared_ptr< db::DatabaseFace > const& backingDB() const { return m_db; }
+
     void setCommitOnEveryInsert( bool _value ) {
         commit();
         m_commitOnEveryInsert = _value;
@@ -24,7 +24,187 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+
 namespace dev {
+
+namespace {
+
+/// Keccak-256 absorbs input by blocks of this size
+size_t const c_rate = 136;
+
+size_t blocksCount( bytesConstRef _input ) {
+    // the last block holds padding, so it is never empty
+    return _input.size() / c_rate + 1;
+}
+
+/// Kernel hashing several inputs of the same blocks count at once
+struct MultiLaneKeccak {
+    size_t lanes = 1;
+    void ( *hash )( bytesConstRef const* _inputs, h256* const* _outputs ) = nullptr;
+};
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+
+uint64_t const c_roundConstants[24] = { 0x0000000000000001ULL, 0x0000000000008082ULL,
+    0x800000000000808aULL, 0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL, 0x0000000000000088ULL,
+    0x0000000080008009ULL, 0x000000008000000aULL, 0x000000008000808bULL, 0x800000000000008bULL,
+    0x8000000000008089ULL, 0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL, 0x8000000000008080ULL,
+    0x0000000080000001ULL, 0x8000000080008008ULL };
+
+// rotation and destination of words in rho and pi steps, in the order pi visits them
+unsigned const c_rotations[24] = { 1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25,
+    43, 62, 18, 39, 61, 20, 44 };
+unsigned const c_piLanes[24] = { 10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2,
+    20, 14, 22, 9, 6, 1 };
+
+// every word of Words holds one 64-bit word of several independent Keccak states
+typedef uint64_t Words4 __attribute__( ( vector_size( 32 ) ) );
+typedef uint64_t Words8 __attribute__( ( vector_size( 64 ) ) );
+
+// Keccak-f[1600] permutation of several states at once
+template < class Words >
+inline __attribute__( ( always_inline ) ) void keccakF( Words* _a ) {
+    // fully unrolled, so lane indices and rotation counts are constants
+    for ( unsigned round = 0; round < 24; ++round ) {
+        // theta
+        Words c[5];
+#pragma GCC unroll 5
+        for ( unsigned x = 0; x < 5; ++x )
+            c[x] = _a[x] ^ _a[x + 5] ^ _a[x + 10] ^ _a[x + 15] ^ _a[x + 20];
+#pragma GCC unroll 5
+        for ( unsigned x = 0; x < 5; ++x ) {
+            Words const& next = c[( x + 1 ) % 5];
+            Words const d = c[( x + 4 ) % 5] ^ ( next << 1 ) ^ ( next >> 63 );
+#pragma GCC unroll 5
+            for ( unsigned y = 0; y < 25; y += 5 )
+                _a[y + x] ^= d;
+        }
+        // rho and pi
+        Words carry = _a[1];
+#pragma GCC unroll 24
+        for ( unsigned i = 0; i < 24; ++i ) {
+            Words const next = _a[c_piLanes[i]];
+            _a[c_piLanes[i]] = ( carry << c_rotations[i] ) | ( carry >> ( 64 - c_rotations[i] ) );
+            carry = next;
+        }
+        // chi
+#pragma GCC unroll 5
+        for ( unsigned y = 0; y < 25; y += 5 ) {
+#pragma GCC unroll 5
+            for ( unsigned x = 0; x < 5; ++x )
+                c[x] = _a[y + x];
+#pragma GCC unroll 5
+            for ( unsigned x = 0; x < 5; ++x )
+                _a[y + x] = c[x] ^ ( ~c[( x + 1 ) % 5] & c[( x + 2 ) % 5] );
+        }
+        // iota
+        _a[0] ^= c_roundConstants[round];
+    }
+}
+
+// hashes Lanes inputs of the same blocks count, lane i of state words belongs to _inputs[i]
+template < class Words, size_t Lanes >
+inline __attribute__( ( always_inline ) ) void keccakLanes(
+    bytesConstRef const* _inputs, h256* const* _outputs ) {
+    Words a[25];
+    for ( Words& w : a )
+        w = Words{};
+
+    size_t const blocks = blocksCount( _inputs[0] );
+    uint8_t lastBlocks[Lanes][c_rate];
+    for ( size_t block = 0; block < blocks; ++block ) {
+        uint8_t const* data[Lanes];
+        for ( size_t lane = 0; lane < Lanes; ++lane ) {
+            size_t const offset = block * c_rate;
+            if ( block + 1 < blocks ) {
+                data[lane] = _inputs[lane].data() + offset;
+                continue;
+            }
+            // keccak padding: 0x01, zeros, 0x80 at the end of the block
+            size_t const tail = _inputs[lane].size() - offset;
+            std::memset( lastBlocks[lane], 0, c_rate );
+            if ( tail )
+                std::memcpy( lastBlocks[lane], _inputs[lane].data() + offset, tail );
+            lastBlocks[lane][tail] ^= 0x01;
+            lastBlocks[lane][c_rate - 1] ^= 0x80;
+            data[lane] = lastBlocks[lane];
+        }
+        for ( size_t i = 0; i < c_rate / 8; ++i ) {
+            Words w;
+            for ( size_t lane = 0; lane < Lanes; ++lane ) {
+                uint64_t word;
+                std::memcpy( &word, data[lane] + 8 * i, 8 );
+                w[lane] = word;
+            }
+            a[i] ^= w;
+        }
+        keccakF( a );
+    }
+
+    for ( size_t lane = 0; lane < Lanes; ++lane )
+        for ( size_t i = 0; i < 4; ++i ) {
+            uint64_t const word = a[i][lane];
+            std::memcpy( _outputs[lane]->data() + 8 * i, &word, 8 );
+        }
+}
+
+__attribute__( ( target( "avx2" ) ) ) void keccakAvx2(
+    bytesConstRef const* _inputs, h256* const* _outputs ) {
+    keccakLanes< Words4, 4 >( _inputs, _outputs );
+}
+
+__attribute__( ( target( "avx512f" ) ) ) void keccakAvx512(
+    bytesConstRef const* _inputs, h256* const* _outputs ) {
+    keccakLanes< Words8, 8 >( _inputs, _outputs );
+}
+
+MultiLaneKeccak const c_scalarKeccak;
+MultiLaneKeccak const c_avx2Keccak{ 4, keccakAvx2 };
+MultiLaneKeccak const c_avx512Keccak{ 8, keccakAvx512 };
+
+// @returns nullptr if the CPU does not support _kernel
+MultiLaneKeccak const* multiLaneKeccakFor( Sha3ManyKernel _kernel ) {
+    __builtin_cpu_init();
+    bool const avx512 = __builtin_cpu_supports( "avx512f" );
+    bool const avx2 = __builtin_cpu_supports( "avx2" );
+    switch ( _kernel ) {
+    case Sha3ManyKernel::Auto:
+        return avx512 ? &c_avx512Keccak : avx2 ? &c_avx2Keccak : &c_scalarKeccak;
+    case Sha3ManyKernel::Avx2:
+        return avx2 ? &c_avx2Keccak : nullptr;
+    case Sha3ManyKernel::Avx512:
+        return avx512 ? &c_avx512Keccak : nullptr;
+    default:
+        return &c_scalarKeccak;
+    }
+}
+
+#else
+
+MultiLaneKeccak const c_scalarKeccak;
+
+MultiLaneKeccak const* multiLaneKeccakFor( Sha3ManyKernel _kernel ) {
+    return _kernel == Sha3ManyKernel::Auto || _kernel == Sha3ManyKernel::Scalar ?
+               &c_scalarKeccak :
+               nullptr;
+}
+
+#endif
+
+std::atomic< MultiLaneKeccak const* >& multiLaneKeccak() {
+    static std::atomic< MultiLaneKeccak const* > kernel(
+        multiLaneKeccakFor( Sha3ManyKernel::Auto ) );
+    return kernel;
+}
+
+}  // namespace
+
 h256 const EmptySHA3 = sha3( bytesConstRef() );
 h256 const EmptyListSHA3 = sha3( rlpList() );
 
@@ -38,4 +218,61 @@ bool sha3( bytesConstRef _input, bytesRef o_output ) noexcept {
     bytesConstRef{ h.bytes, 32 }.copyTo( o_output );
     return true;
 }
+
+void sha3_many( std::vector< bytesConstRef > const& _inputs, h256* o_outputs ) {
+    MICROPROFILE_SCOPEI( "sha3", "sha3_many", MP_MEDIUMBLUE );
+
+    MultiLaneKeccak const& multiLane = *multiLaneKeccak().load( std::memory_order_relaxed );
+
+    // inputs are hashed in groups of the same blocks count, the rest one by one, indices of
+    // the hashed ones in order are replaced with _inputs.size()
+    std::vector< size_t > order;
+    if ( multiLane.hash && _inputs.size() >= multiLane.lanes ) {
+        order.resize( _inputs.size() );
+        std::iota( order.begin(), order.end(), 0 );
+        std::stable_sort( order.begin(), order.end(), [&_inputs]( size_t _a, size_t _b ) {
+            return blocksCount( _inputs[_a] ) < blocksCount( _inputs[_b] );
+        } );
+
+        size_t i = 0;
+        while ( i + multiLane.lanes <= order.size() ) {
+            size_t const blocks = blocksCount( _inputs[order[i]] );
+            if ( blocksCount( _inputs[order[i + multiLane.lanes - 1]] ) != blocks ) {
+                ++i;  // too few inputs of its blocks count, hash it alone below
+                continue;
+            }
+            bytesConstRef inputs[8];
+            h256* outputs[8];
+            for ( size_t lane = 0; lane < multiLane.lanes; ++lane ) {
+                inputs[lane] = _inputs[order[i]];
+                outputs[lane] = o_outputs + order[i];
+                order[i++] = _inputs.size();
+            }
+            multiLane.hash( inputs, outputs );
+        }
+    }
+
+    if ( order.empty() ) {
+        for ( size_t i = 0; i < _inputs.size(); ++i )
+            o_outputs[i] = sha3( _inputs[i] );
+        return;
+    }
+    for ( size_t i : order )
+        if ( i < _inputs.size() )
+            o_outputs[i] = sha3( _inputs[i] );
+}
+
+std::vector< h256 > sha3_many( std::vector< bytesConstRef > const& _inputs ) {
+    std::vector< h256 > ret( _inputs.size() );
+    sha3_many( _inputs, ret.data() );
+    return ret;
+}
+
+bool setSha3ManyKernel( Sha3ManyKernel _kernel ) {
+    MultiLaneKeccak const* kernel = multiLaneKeccakFor( _kernel );
+    if ( !kernel )
+        return false;
+    multiLaneKeccak() = kernel;
+    return true;
+}
 }  // namespace dev
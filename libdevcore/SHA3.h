@@ -31,6 +31,7 @@
 #include <ethash/keccak.hpp>
 
 #include <string>
+#include <vector>
 
 namespace dev {
 
@@ -72,6 +73,18 @@ inline SecureFixedHash< 32 > sha3Secure( std::string const& _input ) noexcept {
     return sha3Secure( bytesConstRef( _input ) );
 }
 
+/// Calculate SHA3-256 hashes of all _inputs into o_outputs, which must have room for as many.
+/// Inputs of the same count of Keccak blocks are hashed several at once with AVX2 or AVX-512
+/// if the CPU supports them, so this is faster than hashing many small inputs one by one.
+void sha3_many( std::vector< bytesConstRef > const& _inputs, h256* o_outputs );
+std::vector< h256 > sha3_many( std::vector< bytesConstRef > const& _inputs );
+
+/// Kernels of sha3_many(), Auto is the fastest one the CPU supports
+enum class Sha3ManyKernel { Auto, Scalar, Avx2, Avx512 };
+/// Makes sha3_many() use _kernel, for tests of every kernel on one host.
+/// @returns false if the CPU does not support _kernel, the kernel is not changed then
+bool setSha3ManyKernel( Sha3ManyKernel _kernel );
+
 /// Keccak hash variant optimized for hashing 256-bit hashes.
 inline h256 sha3( h256 const& _input ) noexcept {
     ethash::hash256 hash = ethash::keccak256_32( _input.data() );
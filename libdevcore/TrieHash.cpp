@@ -21,13 +21,107 @@
 #include "TrieCommon.h"
 #include "TrieDB.h"  // @TODO replace ASAP!
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+
 namespace dev {
 
-void hash256aux( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp );
+namespace {
+
+/// Subtrees with fewer items are hashed by the thread that reached them
+size_t const c_minParallelItems = 256;
+
+/// Threads that may be spawned by all concurrent orderedTrieRoot() calls together, so calls
+/// from several threads do not oversubscribe the CPU
+std::atomic< int >& spareHashThreads() {
+    static std::atomic< int > spare( std::max( 1u, std::thread::hardware_concurrency() ) - 1 );
+    return spare;
+}
+
+/// Sorted nibble keys with their values. Unlike HexMap it splits into subtrees in O(1) and
+/// does not copy the values.
+using HexVector = std::vector< std::pair< bytes, bytesConstRef > >;
+
+HexVector orderedHexVector( std::vector< bytesConstRef > const& _data ) {
+    HexVector ret;
+    ret.reserve( _data.size() );
+    for ( unsigned i = 0; i < _data.size(); ++i ) {
+        bytes const key = rlp( i );
+        ret.emplace_back( asNibbles( &key ), _data[i] );
+    }
+    std::sort( ret.begin(), ret.end(),
+        []( auto const& _a, auto const& _b ) { return _a.first < _b.first; } );
+    return ret;
+}
+
+}  // namespace
+
+// _spareThreads is null for serial hashing, otherwise subtrees of at least c_minParallelItems
+// items are hashed concurrently while it is positive
+template < class Iterator >
+void hash256rlp( Iterator _begin, Iterator _end, unsigned _preLen, RLPStream& _rlp,
+    std::atomic< int >* _spareThreads = nullptr );
+template < class Iterator >
+void hash256aux( Iterator _begin, Iterator _end, unsigned _preLen, RLPStream& _rlp,
+    std::atomic< int >* _spareThreads = nullptr );
 
-void hash256rlp( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp ) {
+// appends 16 children of a branch node, _begin.._end being all items below it. Children nodes
+// of 32 bytes and longer are hashed together with sha3_many()
+template < class Iterator >
+void hash256branches( Iterator _begin, Iterator _end, unsigned _preLen, RLPStream& _rlp,
+    std::atomic< int >* _spareThreads ) {
+    std::array< RLPStream, 16 > children;
+    std::array< bool, 16 > empty;
+    std::vector< std::future< void > > spawned;
+    auto b = _begin;
+    for ( auto i = 0; i < 16; ++i ) {
+        auto n = b;
+        for ( ; n != _end && n->first[_preLen] == i; ++n ) {
+        }
+        empty[i] = b == n;
+        if ( !empty[i] ) {
+            bool const large =
+                _spareThreads && size_t( std::distance( b, n ) ) >= c_minParallelItems;
+            if ( large && _spareThreads->fetch_sub( 1 ) > 0 )
+                spawned.push_back( std::async(
+                    std::launch::async, [&children, i, b, n, _preLen, _spareThreads]() {
+                        hash256rlp( b, n, _preLen + 1, children[i], _spareThreads );
+                        ++*_spareThreads;
+                    } ) );
+            else {
+                if ( large )
+                    ++*_spareThreads;
+                hash256rlp( b, n, _preLen + 1, children[i], _spareThreads );
+            }
+        }
+        b = n;
+    }
+    for ( auto& child : spawned )
+        child.get();
+
+    std::vector< bytesConstRef > toHash;
+    for ( auto i = 0; i < 16; ++i )
+        if ( !empty[i] && children[i].out().size() >= 32 )
+            toHash.emplace_back( &children[i].out() );
+    std::vector< h256 > const hashes = sha3_many( toHash );
+    auto hash = hashes.begin();
+    for ( auto i = 0; i < 16; ++i ) {
+        if ( empty[i] )
+            _rlp << "";
+        else if ( children[i].out().size() < 32 )
+            // RECURSIVE RLP
+            _rlp.appendRaw( children[i].out() );
+        else
+            _rlp << *hash++;
+    }
+}
+
+template < class Iterator >
+void hash256rlp( Iterator _begin, Iterator _end, unsigned _preLen, RLPStream& _rlp,
+    std::atomic< int >* _spareThreads ) {
     if ( _begin == _end )
         _rlp << "";  // NULL
     else if ( std::next( _begin ) == _end ) {
@@ -51,23 +145,14 @@ void hash256rlp( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_
             // if they all have the same next nibble, we also want a pair.
             _rlp.appendList( 2 ) << hexPrefixEncode(
                 _begin->first, false, _preLen, ( int ) sharedPre );
-            hash256aux( _s, _begin, _end, ( unsigned ) sharedPre, _rlp );
+            hash256aux( _begin, _end, ( unsigned ) sharedPre, _rlp, _spareThreads );
         } else {
             // otherwise enumerate all 16+1 entries.
             _rlp.appendList( 17 );
             auto b = _begin;
             if ( _preLen == b->first.size() )
                 ++b;
-            for ( auto i = 0; i < 16; ++i ) {
-                auto n = b;
-                for ( ; n != _end && n->first[_preLen] == i; ++n ) {
-                }
-                if ( b == n )
-                    _rlp << "";
-                else
-                    hash256aux( _s, b, n, _preLen + 1, _rlp );
-                b = n;
-            }
+            hash256branches( b, _end, _preLen, _rlp, _spareThreads );
             if ( _preLen == _begin->first.size() )
                 _rlp << _begin->second;
             else
@@ -76,10 +161,11 @@ void hash256rlp( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_
     }
 }
 
-void hash256aux( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp ) {
+template < class Iterator >
+void hash256aux( Iterator _begin, Iterator _end, unsigned _preLen, RLPStream& _rlp,
+    std::atomic< int >* _spareThreads ) {
     RLPStream rlp;
-    hash256rlp( _s, _begin, _end, _preLen, rlp );
+    hash256rlp( _begin, _end, _preLen, rlp, _spareThreads );
     if ( rlp.out().size() < 32 ) {
         // RECURSIVE RLP
         _rlp.appendRaw( rlp.out() );
@@ -95,7 +181,7 @@ bytes rlp256( BytesMap const& _s ) {
     for ( auto i = _s.rbegin(); i != _s.rend(); ++i )
         hexMap[asNibbles( bytesConstRef( &i->first ) )] = i->second;
     RLPStream s;
-    hash256rlp( hexMap, hexMap.cbegin(), hexMap.cend(), 0, s );
+    hash256rlp( hexMap.cbegin(), hexMap.cend(), 0, s );
     return s.out();
 }
 
@@ -104,19 +190,23 @@ h256 hash256( BytesMap const& _s ) {
 }
 
 h256 orderedTrieRoot( std::vector< bytes > const& _data ) {
-    BytesMap m;
-    unsigned j = 0;
-    for ( auto i : _data )
-        m[rlp( j++ )] = i;
-    return hash256( m );
+    std::vector< bytesConstRef > refs;
+    refs.reserve( _data.size() );
+    for ( auto const& i : _data )
+        refs.emplace_back( &i );
+    return orderedTrieRoot( refs );
 }
 
 h256 orderedTrieRoot( std::vector< bytesConstRef > const& _data ) {
-    BytesMap m;
-    unsigned j = 0;
-    for ( auto i : _data )
-        m[rlp( j++ )] = i.toBytes();
-    return hash256( m );
+    if ( _data.empty() )
+        return sha3( rlp( "" ) );
+    HexVector const hexVector = orderedHexVector( _data );
+    RLPStream s;
+    if ( _data.size() < c_minParallelItems )
+        hash256rlp( hexVector.cbegin(), hexVector.cend(), 0, s );
+    else
+        hash256rlp( hexVector.cbegin(), hexVector.cend(), 0, s, &spareHashThreads() );
+    return sha3( s.out() );
 }
 
 }  // namespace dev
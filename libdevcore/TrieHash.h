@@ -42,6 +42,9 @@ inline h256 trieRootOver( unsigned _itemCount, T const& _getKey, U const& _getVa
     return hash256( m );
 }
 
+/// Root of the trie of _data items keyed by RLP of their indices, as transactions and receipts
+/// tries are. Subtrees of large tries are hashed on several threads, concurrent calls share
+/// one limit of threads, about the number of cores.
 h256 orderedTrieRoot( std::vector< bytesConstRef > const& _data );
 h256 orderedTrieRoot( std::vector< bytes > const& _data );
 
@@ -0,0 +1,195 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ValueCodec.h"
+
+#include "Metrics.h"
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace dev::db {
+
+namespace {
+const size_t c_headerSize = 3;
+const char c_magic[2] = { 'S', 'K' };
+// smaller values are not worth the CPU
+const size_t c_minSize = 128;
+// protects from allocating much on a corrupted size field
+const size_t c_maxPlainSize = size_t( 1 ) << 30;
+
+string zstdEncode( Slice _plain, int _level ) {
+    string out( ZSTD_compressBound( _plain.size() ), '\0' );
+    size_t const n = ZSTD_compress( &out[0], out.size(), _plain.data(), _plain.size(), _level );
+    if ( ZSTD_isError( n ) )
+        return string();
+    out.resize( n );
+    return out;
+}
+
+bool zstdDecode( Slice _payload, string& _out ) {
+    unsigned long long const size = ZSTD_getFrameContentSize( _payload.data(), _payload.size() );
+    if ( size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size == 0 ||
+         size > c_maxPlainSize )
+        return false;
+    _out.resize( size );
+    size_t const n = ZSTD_decompress( &_out[0], _out.size(), _payload.data(), _payload.size() );
+    return !ZSTD_isError( n ) && n == size;
+}
+
+// payload is 4-byte plain size, bitmap of non-zero 8-byte words, these words, tail bytes
+string sparseEncode( Slice _plain ) {
+    size_t const words = _plain.size() / 8;
+    string out( 4 + ( words + 7 ) / 8, '\0' );
+    uint32_t const size = _plain.size();
+    for ( size_t i = 0; i < 4; ++i )
+        out[i] = char( size >> ( 24 - 8 * i ) );
+    for ( size_t i = 0; i < words; ++i ) {
+        char const* word = _plain.data() + i * 8;
+        if ( all_of( word, word + 8, []( char _c ) { return _c == 0; } ) )
+            continue;
+        out[4 + i / 8] |= char( 1 << ( i % 8 ) );
+        out.append( word, 8 );
+    }
+    out.append( _plain.data() + words * 8, _plain.size() % 8 );
+    return out;
+}
+
+bool sparseDecode( Slice _payload, string& _out ) {
+    if ( _payload.size() < 4 )
+        return false;
+    size_t size = 0;
+    for ( size_t i = 0; i < 4; ++i )
+        size = ( size << 8 ) | uint8_t( _payload[i] );
+    size_t const words = size / 8;
+    size_t const bitmapSize = ( words + 7 ) / 8;
+    if ( size > c_maxPlainSize || _payload.size() < 4 + bitmapSize )
+        return false;
+    char const* bitmap = _payload.data() + 4;
+    size_t nonZero = 0;
+    for ( size_t i = 0; i < bitmapSize; ++i )
+        nonZero += __builtin_popcount( uint8_t( bitmap[i] ) );
+    if ( _payload.size() != 4 + bitmapSize + nonZero * 8 + size % 8 )
+        return false;
+
+    _out.assign( size, '\0' );
+    char const* data = bitmap + bitmapSize;
+    for ( size_t i = 0; i < words; ++i ) {
+        if ( !( uint8_t( bitmap[i / 8] ) & ( 1 << ( i % 8 ) ) ) )
+            continue;
+        memcpy( &_out[i * 8], data, 8 );
+        data += 8;
+    }
+    memcpy( &_out[words * 8], data, size % 8 );
+    return true;
+}
+}  // namespace
+
+ValueCodec::ValueCodec(
+    std::vector< Family > _families, std::function< int( Slice ) > _classify, int _zstdLevel )
+    : m_families( std::move( _families ) ),
+      m_classify( std::move( _classify ) ),
+      m_zstdLevel( _zstdLevel ) {
+    auto& registry = metrics::Registry::instance();
+    for ( Family const& family : m_families ) {
+        m_plainBytes.push_back( &registry.counter( "skaled_db_codec_plain_bytes_total",
+            "Size of values written through DB value codec", { { "family", family.name } } ) );
+        m_storedBytes.push_back( &registry.counter( "skaled_db_codec_stored_bytes_total",
+            "Size of values stored by DB value codec", { { "family", family.name } } ) );
+    }
+}
+
+std::string ValueCodec::encode( Slice _key, Slice _value ) const {
+    int const family = m_classify( _key );
+    if ( family < 0 )
+        return _value.toString();
+
+    Method const method = m_families[family].method;
+    string payload;
+    if ( _value.size() >= c_minSize ) {
+        if ( method == Method::Zstd )
+            payload = zstdEncode( _value, m_zstdLevel );
+        else if ( method == Method::SparseZeros )
+            payload = sparseEncode( _value );
+    }
+
+    string stored;
+    if ( !payload.empty() && c_headerSize + payload.size() < _value.size() ) {
+        stored.reserve( c_headerSize + payload.size() );
+        stored.push_back( char( method ) );
+        stored.append( c_magic, sizeof( c_magic ) );
+        stored.append( payload );
+    } else
+        stored = _value.toString();
+
+    m_plainBytes[family]->inc( _value.size() );
+    m_storedBytes[family]->inc( stored.size() );
+    return stored;
+}
+
+std::string ValueCodec::decode( Slice _key, std::string _stored ) const {
+    if ( m_classify( _key ) < 0 || !isEncoded( Slice( _stored ) ) )
+        return _stored;
+    return decodeOrThrow( Slice( _stored ) );
+}
+
+bool ValueCodec::isEncoded( Slice _stored ) {
+    if ( _stored.size() <= c_headerSize || _stored[1] != c_magic[0] || _stored[2] != c_magic[1] )
+        return false;
+    Method const method = Method( uint8_t( _stored[0] ) );
+    return method == Method::Zstd || method == Method::SparseZeros;
+}
+
+void ValueCodec::decodeIfEncoded( std::string& _value ) {
+    if ( !isEncoded( Slice( _value ) ) )
+        return;
+    try {
+        _value = decodeOrThrow( Slice( _value ) );
+    } catch ( DatabaseError const& ) {
+        // a plain value that looks like an encoded one
+    }
+}
+
+ValueCodec::Method ValueCodec::methodFromString( std::string const& _name ) {
+    if ( _name == "none" )
+        return Method::None;
+    if ( _name == "zstd" )
+        return Method::Zstd;
+    if ( _name == "sparse" )
+        return Method::SparseZeros;
+    throw std::invalid_argument( "unknown DB value codec " + _name );
+}
+
+std::string ValueCodec::decodeOrThrow( Slice _stored ) {
+    Slice const payload = _stored.cropped( c_headerSize );
+    string plain;
+    bool const ok = Method( uint8_t( _stored[0] ) ) == Method::Zstd ?
+                        zstdDecode( payload, plain ) :
+                        sparseDecode( payload, plain );
+    if ( !ok )
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "corrupted encoded value" ) );
+    return plain;
+}
+
+}  // namespace dev::db
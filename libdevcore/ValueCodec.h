@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Compression of database values by key family.
+ */
+
+#pragma once
+
+#include "db.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace dev::metrics {
+class Counter;
+}
+
+namespace dev::db {
+
+/// Compresses values of selected key families before they are stored.
+/// An encoded value is a header {method, 'S', 'K'} followed by the payload. The codec is meant
+/// for families whose plain values are RLP lists, which start with 0xc0 or above, while the
+/// header starts with a small number. So plain values written with the codec disabled are read
+/// as they are, and the codec can be switched on and off on an existing database.
+/// Values that do not get smaller are stored plain.
+class ValueCodec {
+public:
+    enum class Method : uint8_t {
+        None = 0,
+        Zstd = 1,
+        /// drops zero 8-byte words, cheap and good for log blooms
+        SparseZeros = 2
+    };
+
+    struct Family {
+        std::string name;
+        Method method = Method::None;
+    };
+
+    /// @param _classify returns index in _families for a key, or -1 if values under the key
+    /// are stored plain
+    ValueCodec( std::vector< Family > _families, std::function< int( Slice ) > _classify,
+        int _zstdLevel = 3 );
+
+    /// @returns value to store under _key
+    std::string encode( Slice _key, Slice _value ) const;
+    /// @returns plain value of one read from under _key
+    std::string decode( Slice _key, std::string _stored ) const;
+
+    static bool isEncoded( Slice _stored );
+    /// Replaces an encoded value with the plain one, keeps anything else. Does not throw.
+    /// Used where key families are not known, e.g. to hash raw databases, so that the hash
+    /// does not depend on the codec settings.
+    static void decodeIfEncoded( std::string& _value );
+
+    /// "none", "zstd" or "sparse", throws std::invalid_argument otherwise
+    static Method methodFromString( std::string const& _name );
+
+private:
+    static std::string decodeOrThrow( Slice _stored );
+
+    std::vector< Family > const m_families;
+    std::function< int( Slice ) > const m_classify;
+    int const m_zstdLevel;
+
+    // per family, plain and stored sizes of encoded values
+    std::vector< metrics::Counter* > m_plainBytes;
+    std::vector< metrics::Counter* > m_storedBytes;
+};
+
+}  // namespace dev::db
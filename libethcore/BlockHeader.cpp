@@ -225,9 +225,11 @@ void BlockHeader::verify( Strictness _s, BlockHeader const& _parent, bytesConstR
         RLP root( _block );
 
         auto txList = root[1];
-        auto expectedRoot = trieRootOver(
-            txList.itemCount(), [&]( unsigned i ) { return rlp( i ); },
-            [&]( unsigned i ) { return txList[i].data().toBytes(); } );
+        std::vector< bytesConstRef > txData;
+        txData.reserve( txList.itemCount() );
+        for ( auto const& tx : txList )
+            txData.push_back( tx.data() );
+        auto expectedRoot = orderedTrieRoot( txData );
 
         LOG( m_logger ) << "Expected trie root: " << toString( expectedRoot );
         if ( m_transactionsRoot != expectedRoot ) {
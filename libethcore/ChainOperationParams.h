@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -94,6 +95,16 @@ public:
     bool archiveMode;
     bool syncFromCatchup;
     bool testSignatures;
+    // historic state retention, 0 means keep everything
+    uint64_t historicStateRetainBlocks = 0;
+    uint64_t historicStateCheckpointInterval = 0;
+    // tracers run on every imported block, results are persisted for tracing RPCs
+    std::vector< std::string > traceOnImport;
+    // value codecs of blocks and extras DB: key family -> "zstd", "sparse" or "none"
+    std::map< std::string, std::string > blocksDbCodecs;
+    int blocksDbZstdLevel = 3;
+    // in archive mode, convert archive pieces of blocks DB to compressed read-only segments
+    bool archiveColdTier = false;
 
     NodeInfo( std::string _name = "TestNode", u256 _id = 1, std::string _ip = "127.0.0.11",
         uint16_t _port = 11111, std::string _ip6 = "::1", uint16_t _port6 = 11111,
@@ -44,5 +44,18 @@ LogBloom LogEntry::bloom() const {
     return ret;
 }
 
+LogBloom bloom( LogEntries const& _logs ) {
+    std::vector< bytesConstRef > items;
+    for ( auto const& l : _logs ) {
+        items.push_back( l.address.ref() );
+        for ( auto const& t : l.topics )
+            items.push_back( t.ref() );
+    }
+    LogBloom ret;
+    for ( auto const& h : sha3_many( items ) )
+        ret.shiftBloom< 3 >( h );
+    return ret;
+}
+
 }  // namespace eth
 }  // namespace dev
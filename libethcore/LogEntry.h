@@ -89,12 +89,8 @@ struct LocalisedLogEntry : public LogEntry {
 
 using LocalisedLogEntries = std::vector< LocalisedLogEntry >;
 
-inline LogBloom bloom( LogEntries const& _logs ) {
-    LogBloom ret;
-    for ( auto const& l : _logs )
-        ret |= l.bloom();
-    return ret;
-}
+/// Bloom of all _logs, their addresses and topics are hashed together with sha3_many()
+LogBloom bloom( LogEntries const& _logs );
 
 }  // namespace eth
 }  // namespace dev
@@ -24,6 +24,7 @@
 #include "Block.h"
 
 #include "BlockChain.h"
+#include "BlockImportTimeline.h"
 #include "Defaults.h"
 #include "Executive.h"
 #include "ExtVM.h"
@@ -505,6 +506,9 @@ tuple< TransactionReceipts, unsigned > Block::syncEveryone(
                 continue;
             }
 
+            BlockImportTimeline::ScopedStage timelineStage( "execute", "transaction",
+                BlockImportTimeline::instance().isBlockOpen() ? tr.sha3().hex() :
+                                                                std::string() );
             ExecutionResult res =
                 execute( _bc.lastBlockHashes(), tr, Permanence::Committed, OnOpFunc() );
 
@@ -1002,19 +1006,16 @@ void Block::commitToSeal(
     // here was code to handle 6 generations of uncles
     // it was wtiting its results in two variables above
 
-    BytesMap transactionsMap;
-    BytesMap receiptsMap;
+    vector< bytes > transactionsData;
+    vector< bytes > receiptsData;
 
     RLPStream txs;
     txs.appendList( m_transactions.size() );
 
     for ( unsigned i = 0; i < m_transactions.size(); ++i ) {
-        RLPStream k;
-        k << i;
-
         RLPStream receiptrlp;
         receipt( i ).streamRLP( receiptrlp );
-        receiptsMap.insert( std::make_pair( k.out(), receiptrlp.out() ) );
+        receiptsData.push_back( receiptrlp.out() );
 
         dev::bytes txOutput = m_transactions[i].toBytes();
         if ( EIP1559TransactionsPatch::isEnabledInWorkingBlock() &&
@@ -1023,9 +1024,8 @@ void Block::commitToSeal(
             s.append( txOutput );
             txOutput = s.out();
         }
-        transactionsMap.insert( std::make_pair( k.out(), txOutput ) );
-
         txs.appendRaw( txOutput );
+        transactionsData.push_back( std::move( txOutput ) );
     }
 
     txs.swapOut( m_currentTxs );
@@ -1052,7 +1052,7 @@ void Block::commitToSeal(
 
     m_currentBlock.setLogBloom( logBloom() );
     m_currentBlock.setGasUsed( gasUsed() );
-    m_currentBlock.setRoots( hash256( transactionsMap ), hash256( receiptsMap ),
+    m_currentBlock.setRoots( orderedTrieRoot( transactionsData ), orderedTrieRoot( receiptsData ),
         sha3( m_currentUncles ), _stateRootHash );
 
     m_currentBlock.setParentHash( m_previousBlock.hash() );
@@ -39,6 +39,7 @@
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/TrieHash.h>
+#include <libdevcore/ValueCodec.h>
 #include <libdevcore/microprofile.h>
 #include <libethashseal/Ethash.h>
 #include <libethcore/BlockHeader.h>
@@ -161,14 +162,31 @@ void addBlockInfo( Exception& io_ex, BlockHeader const& _header, bytes&& _blockD
         io_ex << errinfo_extraData( _header.extraData() );
 }
 
-}  // namespace
-
+// @returns codec of blocks or extras DB, families that are not configured are written plain,
+// but values encoded while they were configured are still decoded
+std::shared_ptr< const db::ValueCodec > makeValueCodec(
+    NodeInfo const& _info, std::vector< std::pair< std::string, unsigned > > const& _families ) {
+    std::vector< db::ValueCodec::Family > families;
+    std::map< unsigned, int > indexBySub;
+    for ( auto const& [name, sub] : _families ) {
+        auto it = _info.blocksDbCodecs.find( name );
+        indexBySub[sub] = families.size();
+        families.push_back( { name, it == _info.blocksDbCodecs.end() ?
+                                        db::ValueCodec::Method::None :
+                                        db::ValueCodec::methodFromString( it->second ) } );
+    }
+    // keys are toSlice( hash, sub ), block ones have sub 0
+    auto classify = [indexBySub]( db::Slice _key ) -> int {
+        unsigned const sub = _key.size() == 33 ? uint8_t( _key[32] ) : 0;
+        auto it = indexBySub.find( sub );
+        return it == indexBySub.end() ? -1 : it->second;
+    };
+    return std::make_shared< db::ValueCodec >(
+        std::move( families ), std::move( classify ), _info.blocksDbZstdLevel );
+}
 
-/// Duration between flushes.
-chrono::system_clock::duration c_collectionDuration = chrono::seconds( 60 );
+}  // namespace
 
-/// Length of death row (total time in cache is multiple of this and collection duration).
-unsigned c_collectionQueueSize = 20;
 
 /// Max size, above which we start forcing cache reduction.
 unsigned c_maxCacheSize = 1024 * 1024 * 64;
@@ -207,9 +225,6 @@ BlockHeader const& BlockChain::genesis() const {
 
 void BlockChain::init( ChainParams const& _p ) {
     clockLastDbRotation_ = clock();
-    // initialise deathrow.
-    m_cacheUsage.resize( c_collectionQueueSize );
-    m_lastCollection = chrono::system_clock::now();
 
     // Initialise with the genesis as the last block on the longest chain.
     m_params = _p;
@@ -233,15 +248,19 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
 
     try {
         fs::create_directories( chainPath / fs::path( "blocks_and_extras" ) );
-        m_rotator = std::make_shared< batched_io::rotating_db_io >(
-            chainPath / fs::path( "blocks_and_extras" ), 5, chainParams().nodeInfo.archiveMode );
-        m_rotating_db = std::make_shared< db::ManuallyRotatingLevelDB >( m_rotator );
+        auto rotator = std::make_shared< batched_io::rotating_db_io >(
+            chainPath / fs::path( "blocks_and_extras" ), 5, chainParams().nodeInfo.archiveMode,
+            chainParams().nodeInfo.archiveColdTier );
+        m_rotating_db = std::make_shared< db::ManuallyRotatingLevelDB >( rotator );
         auto db = std::make_shared< batched_io::batched_db >();
         db->open( m_rotating_db );
         m_db = db;
         m_db_splitter = std::make_unique< batched_io::db_splitter >( m_db );
-        m_blocksDB = m_db_splitter->new_interface();
-        m_extrasDB = m_db_splitter->new_interface();
+        NodeInfo const& info = chainParams().nodeInfo;
+        m_blocksDB = m_db_splitter->new_interface( makeValueCodec( info, { { "blocks", 0 } } ) );
+        m_extrasDB = m_db_splitter->new_interface( makeValueCodec( info,
+            { { "receipts", ExtraReceipts }, { "logBlooms", ExtraLogBlooms },
+                { "blocksBlooms", ExtraBlocksBlooms } } ) );
         // m_blocksDB.reset( new db::DBImpl( chainPath / fs::path( "blocks" ) ) );
         // m_extrasDB.reset( new db::DBImpl( extrasPath / fs::path( "extras" ) ) );
     } catch ( db::DatabaseError const& ex ) {
@@ -273,7 +292,7 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
         BlockDetails details( 0, gb.difficulty(), h256(), {}, genesisBlockBytes.size() );
         auto r = details.rlp();
         details.size = r.size();
-        m_details[m_genesisHash] = details;
+        m_details.put( m_genesisHash, details );
         m_extrasDB->insert( toSlice( m_genesisHash, ExtraDetails ), ( db::Slice ) dev::ref( r ) );
         assert( isKnown( gb.hash() ) );
         m_db->commit( "insert_genesis" );
@@ -291,7 +310,7 @@ void BlockChain::open( fs::path const& _path, bool _applyPatches, WithExisting _
         // re-insert genesis
         BlockDetails details = this->details( m_genesisHash );
         auto r = details.rlp();
-        m_details[m_genesisHash] = details;
+        m_details.put( m_genesisHash, details );
         m_extrasDB->insert( toSlice( m_genesisHash, ExtraDetails ), ( db::Slice ) dev::ref( r ) );
         // update storage usage
         m_db->insert( db::Slice( "pieceUsageBytes" ), db::Slice( "0" ) );
@@ -338,17 +357,59 @@ void BlockChain::close() {
     m_lastBlockHashes->clear();
 }
 
+TransactionReceipt BlockChain::transactionReceipt( h256 const& _blockHash, unsigned _i ) const {
+    std::optional< TransactionReceipt > receipt;
+    m_receipts.visit( _blockHash, [&receipt, _i]( BlockReceipts const& _receipts ) {
+        receipt = _receipts.receipts.at( _i );
+    } );
+    if ( receipt ) {
+        m_extrasCacheHits.fetch_add( 1, std::memory_order_relaxed );
+        return *receipt;
+    }
+    m_extrasCacheMisses.fetch_add( 1, std::memory_order_relaxed );
+
+    // receipts are stored as one RLP list, skipping to the item does not decode the others
+    std::string const s = m_extrasDB->lookup( toSlice( _blockHash, ExtraReceipts ) );
+    RLP const receipts( s );
+    // same as at() of the cached receipts
+    if ( _i >= receipts.itemCount() )
+        throw std::out_of_range( "No receipt #" + std::to_string( _i ) + " in block" );
+    return TransactionReceipt( receipts[_i].data() );
+}
+
+u256 BlockChain::transactionGasUsed( h256 const& _blockHash, unsigned _i ) const {
+    std::optional< u256 > cachedGasUsed;
+    m_receipts.visit( _blockHash, [&cachedGasUsed, _i]( BlockReceipts const& _receipts ) {
+        TransactionReceipts const& receipts = _receipts.receipts;
+        u256 gasUsed = receipts.at( _i ).cumulativeGasUsed();
+        if ( _i > 0 )
+            gasUsed -= receipts.at( _i - 1 ).cumulativeGasUsed();
+        cachedGasUsed = gasUsed;
+    } );
+    if ( cachedGasUsed ) {
+        m_extrasCacheHits.fetch_add( 1, std::memory_order_relaxed );
+        return *cachedGasUsed;
+    }
+    m_extrasCacheMisses.fetch_add( 1, std::memory_order_relaxed );
+
+    // cumulative gas is the 2nd field of receipt
+    std::string const s = m_extrasDB->lookup( toSlice( _blockHash, ExtraReceipts ) );
+    RLP const receipts( s );
+    if ( _i >= receipts.itemCount() )
+        throw std::out_of_range( "No receipt #" + std::to_string( _i ) + " in block" );
+    u256 gasUsed = receipts[_i][1].toInt< u256 >();
+    if ( _i > 0 )
+        gasUsed -= receipts[_i - 1][1].toInt< u256 >();
+    return gasUsed;
+}
+
 std::pair< h256, unsigned > BlockChain::transactionLocation( h256 const& _transactionHash ) const {
     // cached transactionAddresses for transactions with gasUsed==0 should be re-queried from DB
-    bool cached = false;
-    {
-        ReadGuard g( x_transactionAddresses );
-        cached = m_transactionAddresses.count( _transactionHash ) > 0;
-    }
+    bool const cached = m_transactionAddresses.contains( _transactionHash );
 
     // get transactionAddresses from DB or cache
     TransactionAddress ta = queryExtras< TransactionAddress, ExtraTransactionAddress >(
-        _transactionHash, m_transactionAddresses, x_transactionAddresses, NullTransactionAddress );
+        _transactionHash, m_transactionAddresses, NullTransactionAddress );
 
     if ( !ta )
         return std::pair< h256, unsigned >( h256(), 0 );
@@ -362,22 +423,15 @@ std::pair< h256, unsigned > BlockChain::transactionLocation( h256 const& _transa
     // rest is for blocks with possibility of invalid transactions
 
     // compute gas used
-    TransactionReceipt receipt = transactionReceipt( ta.blockHash, ta.index );
-    u256 cumulativeGasUsed = receipt.cumulativeGasUsed();
-    u256 prevGasUsed =
-        ta.index == 0 ? 0 : transactionReceipt( ta.blockHash, ta.index - 1 ).cumulativeGasUsed();
-    u256 gasUsed = cumulativeGasUsed - prevGasUsed;
+    u256 gasUsed = transactionGasUsed( ta.blockHash, ta.index );
 
     // re-query receipt from DB if gasUsed==0 (and cache might have wrong value)
     if ( gasUsed == 0 && cached ) {
         // remove from cache
-        {
-            WriteGuard g( x_transactionAddresses );
-            m_transactionAddresses.erase( _transactionHash );
-        }
+        m_transactionAddresses.erase( _transactionHash );
         // re-read from DB
-        ta = queryExtras< TransactionAddress, ExtraTransactionAddress >( _transactionHash,
-            m_transactionAddresses, x_transactionAddresses, NullTransactionAddress );
+        ta = queryExtras< TransactionAddress, ExtraTransactionAddress >(
+            _transactionHash, m_transactionAddresses, NullTransactionAddress );
     }
     return std::make_pair( ta.blockHash, ta.index );
 }
@@ -677,7 +731,7 @@ bool BlockChain::rotateDBIfNeeded( uint64_t pieceUsageBytes ) {
 
     // re-insert genesis
     auto r = details.rlp();
-    m_details[m_genesisHash] = details;
+    m_details.put( m_genesisHash, details );
     m_extrasDB->insert( toSlice( m_genesisHash, ExtraDetails ), ( db::Slice ) dev::ref( r ) );
     m_db->commit( "genesis_after_rotate" );
 
@@ -709,18 +763,13 @@ size_t BlockChain::prepareDbDataAndReturnSize( VerifiedBlockRef const& _block,
 
         blocksWriteBatch.insert( toSlice( _block.info.hash() ), db::Slice( _block.block ) );
 
-        // ensure parent is cached for later addition.
-        // TODO: this is a bit horrible would be better refactored into an enveloping
-        // UpgradableGuard together with an "ensureCachedWithUpdatableLock(l)" method. This is
-        // safe in practice since the caches don't get flushed nearly often enough to be done
-        // here.
-        details( _block.info.parentHash() );
-        DEV_WRITE_GUARDED( x_details ) {
-            m_details[_block.info.parentHash()].children.clear();
-            m_details[_block.info.parentHash()].children.push_back( _block.info.hash() );
-            extrasWriteBatch.insert( toSlice( _block.info.parentHash(), ExtraDetails ),
-                ( db::Slice ) dev::ref( m_details[_block.info.parentHash()].rlp() ) );
-        }
+        // blocks are imported one at a time, so nobody changes parent details meanwhile
+        BlockDetails parentDetails = details( _block.info.parentHash() );
+        parentDetails.children.clear();
+        parentDetails.children.push_back( _block.info.hash() );
+        extrasWriteBatch.insert( toSlice( _block.info.parentHash(), ExtraDetails ),
+            ( db::Slice ) dev::ref( parentDetails.rlp() ) );
+        m_details.put( _block.info.parentHash(), std::move( parentDetails ) );
 
         BlockDetails details( ( unsigned ) _block.info.number(), _totalDifficulty,
             _block.info.parentHash(), {}, _block.block.size() );
@@ -729,9 +778,10 @@ size_t BlockChain::prepareDbDataAndReturnSize( VerifiedBlockRef const& _block,
         extrasWriteBatch.insert(
             toSlice( _block.info.hash(), ExtraDetails ), ( db::Slice ) dev::ref( details_rlp ) );
 
+        // bloom is the 3rd field of receipt, no need to decode logs
         BlockLogBlooms blb;
         for ( auto i : RLP( _receipts ) )
-            blb.blooms.push_back( TransactionReceipt( i.data() ).bloom() );
+            blb.blooms.push_back( ( LogBloom ) i[2] );
         extrasWriteBatch.insert(
             toSlice( _block.info.hash(), ExtraLogBlooms ), ( db::Slice ) dev::ref( blb.rlp() ) );
 
@@ -772,7 +822,7 @@ size_t BlockChain::prepareDbDataAndReturnSize( VerifiedBlockRef const& _block,
     }
 
     // Collate logs into blooms.
-    h256s alteredBlooms;
+    std::vector< std::pair< h256, bytes > > alteredBlooms;
     {
         MICROPROFILE_SCOPEI( "insertBlockAndExtras", "collate_logs", MP_PALETURQUOISE );
 
@@ -791,33 +841,26 @@ size_t BlockChain::prepareDbDataAndReturnSize( VerifiedBlockRef const& _block,
 
         blockBloom.shiftBloom< 3 >( sha3( tbi.author().ref() ) );
 
-        // Pre-memoize everything we need before locking x_blocksBlooms
-        for ( unsigned level = 0, index = ( unsigned ) tbi.number(); level < c_bloomIndexLevels;
-              level++, index /= c_bloomIndexSize )
-            blocksBlooms( chunkId( level, index / c_bloomIndexSize ) );
-
-        WriteGuard l( x_blocksBlooms );
         for ( unsigned level = 0, index = ( unsigned ) tbi.number(); level < c_bloomIndexLevels;
               level++, index /= c_bloomIndexSize ) {
             unsigned i = index / c_bloomIndexSize;
             unsigned o = index % c_bloomIndexSize;
-            alteredBlooms.push_back( chunkId( level, i ) );
-            m_blocksBlooms[alteredBlooms.back()].blooms[o] |= blockBloom;
+            h256 const id = chunkId( level, i );
+            BlocksBlooms blooms = blocksBlooms( id );
+            blooms.blooms[o] |= blockBloom;
+            // rlp() also updates size the cache is accounted by
+            alteredBlooms.emplace_back( id, blooms.rlp() );
+            m_blocksBlooms.put( id, std::move( blooms ) );
         }
     }
 
-    for ( auto const& h : alteredBlooms )
-        noteUsed( h, ExtraBlocksBlooms );
-
     // Update database with them.
-    // ReadGuard l1( x_blocksBlooms );
-    WriteGuard l1( x_blocksBlooms );
     {
         MICROPROFILE_SCOPEI( "insertBlockAndExtras", "insert_to_extras", MP_LIGHTSKYBLUE );
 
-        for ( auto const& h : alteredBlooms )
-            extrasWriteBatch.insert( toSlice( h, ExtraBlocksBlooms ),
-                ( db::Slice ) dev::ref( m_blocksBlooms[h].rlp() ) );
+        for ( auto const& altered : alteredBlooms )
+            extrasWriteBatch.insert( toSlice( altered.first, ExtraBlocksBlooms ),
+                ( db::Slice ) dev::ref( altered.second ) );
         extrasWriteBatch.insert( toSlice( h256( tbi.number() ), ExtraBlockHash ),
             ( db::Slice ) dev::ref( BlockHash( tbi.hash() ).rlp() ) );
     }
@@ -1082,8 +1125,9 @@ void BlockChain::clearBlockBlooms( unsigned _begin, unsigned _end ) {
                 for ( auto const& bloom : blocksBlooms( lowerChunkId ).blooms )
                     acc |= bloom;
             }
-            blocksBlooms( id );  // make sure it has been memoized.
-            m_blocksBlooms[id].blooms[offset] = acc;
+            BlocksBlooms blooms = blocksBlooms( id );
+            blooms.blooms[offset] = acc;
+            m_blocksBlooms.put( id, std::move( blooms ) );
         }
     }
 }
@@ -1208,92 +1252,13 @@ tuple< h256s, h256, unsigned > BlockChain::treeRoute(
     return make_tuple( ret, from, i );
 }
 
-void BlockChain::noteUsed( h256 const& _h, unsigned _extra ) const {
-    auto id = CacheID( _h, _extra );
-    Guard l( x_cacheUsage );
-    m_cacheUsage[0].insert( id );
-    if ( m_cacheUsage[1].count( id ) )
-        m_cacheUsage[1].erase( id );
-    else
-        m_inUse.insert( id );
-}
-
-template < class K, class T >
-static unsigned getHashSize( unordered_map< K, T > const& _map ) {
-    unsigned ret = 0;
-    for ( auto const& i : _map )
-        ret += i.second.size + 64;
-    return ret;
-}
-
-template < class K, class T >
-static uint64_t getApproximateHashSize( unordered_map< K, T > const& _map ) {
-    uint64_t ret = 0;
-    uint64_t counter = 0;
-    for ( auto const& i : _map ) {
-        ret += i.second.size + 64;
-        counter++;
-        if ( counter >= 1024 ) {
-            break;
-        }
-    }
-    if ( _map.size() <= 1024 )
-        return ret;
-    else {
-        // sample for large cache
-        return ( ret * _map.size() ) / 1024;
-    }
-}
-
-
-template < class K, class T >
-static unsigned getBlockHashSize( map< K, T > const& _map ) {
-    return _map.size() * ( BlockHash::size + 64 );
-}
-
 void BlockChain::updateStats() const {
-    m_lastStats.memBlocks = 0;
-    uint64_t counter = 0;
-    {
-        DEV_READ_GUARDED( x_blocks )
-
-        for ( auto const& i : m_blocks ) {
-            m_lastStats.memBlocks += i.second.size() + 64;
-            counter++;
-            if ( counter >= 1024 )
-                break;
-        }
-
-        // sample for large cache
-        if ( m_blocks.size() > 1024 ) {
-            m_lastStats.memBlocks = ( m_lastStats.memBlocks * m_blocks.size() ) / 1024;
-        }
-    }
-    { DEV_READ_GUARDED( x_details ) m_lastStats.memDetails = getApproximateHashSize( m_details ); }
-    size_t logBloomsSize = 0;
-    size_t blocksBloomsSize = 0;
-    { DEV_READ_GUARDED( x_logBlooms ) logBloomsSize = getApproximateHashSize( m_logBlooms ); }
-    {
-        DEV_READ_GUARDED( x_blocksBlooms )
-        blocksBloomsSize = getApproximateHashSize( m_blocksBlooms );
-    }
-
-    m_lastStats.memLogBlooms = logBloomsSize + blocksBloomsSize;
-
-    {
-        DEV_READ_GUARDED( x_receipts )
-        m_lastStats.memReceipts = getApproximateHashSize( m_receipts );
-    }
-    {
-        DEV_READ_GUARDED( x_blockHashes )
-        m_lastStats.memBlockHashes = m_blockHashes.size() * ( 64 + BlockHash::size );
-    }
-
-    {
-        DEV_READ_GUARDED( x_transactionAddresses )
-        m_lastStats.memTransactionAddresses =
-            m_transactionAddresses.size() * ( 64 + TransactionAddress::size );
-    }
+    m_lastStats.memBlocks = m_blocks.memoryUsage();
+    m_lastStats.memDetails = m_details.memoryUsage();
+    m_lastStats.memLogBlooms = m_logBlooms.memoryUsage() + m_blocksBlooms.memoryUsage();
+    m_lastStats.memReceipts = m_receipts.memoryUsage();
+    m_lastStats.memBlockHashes = m_blockHashes.memoryUsage();
+    m_lastStats.memTransactionAddresses = m_transactionAddresses.memoryUsage();
 }
 
 uint64_t BlockChain::getTotalCacheMemory() {
@@ -1303,129 +1268,43 @@ uint64_t BlockChain::getTotalCacheMemory() {
 void BlockChain::garbageCollect( bool _force ) {
     updateStats();
 
-    if ( !_force && chrono::system_clock::now() < m_lastCollection + c_collectionDuration &&
-         m_lastStats.memTotal() < c_maxCacheSize )
-        return;
-    if ( m_lastStats.memTotal() < c_minCacheSize )
+    uint64_t const total = m_lastStats.memTotal();
+    uint64_t const budget = _force ? c_minCacheSize : c_maxCacheSize;
+    if ( total <= budget )
         return;
 
+    // every cache gives up its share of the excess, entries unused for longest go first
+    uint64_t const excess = total - budget;
+    auto evict = [excess, total]( auto& _cache ) {
+        _cache.evict( excess * _cache.memoryUsage() / total );
+    };
+    evict( m_blocks );
+    evict( m_details );
+    evict( m_logBlooms );
+    evict( m_receipts );
+    evict( m_transactionAddresses );
+    evict( m_blockHashes );
+    evict( m_blocksBlooms );
 
-    m_lastCollection = chrono::system_clock::now();
-
-    // We subtract memory that blockhashes occupy because it is treated sepaparately
-    while ( m_lastStats.memTotal() - m_lastStats.memBlockHashes >= c_maxCacheSize ) {
-        Guard l( x_cacheUsage );
-        for ( CacheID const& id : m_cacheUsage.back() ) {
-            m_inUse.erase( id );
-            // kill i from cache.
-            switch ( id.second ) {
-            case ( unsigned ) -1: {
-                WriteGuard l( x_blocks );
-                m_blocks.erase( id.first );
-                break;
-            }
-            case ExtraDetails: {
-                WriteGuard l( x_details );
-                m_details.erase( id.first );
-                break;
-            }
-            case ExtraBlockHash: {
-                // m_cacheUsage should not contain ExtraBlockHash elements currently.  See the
-                // second noteUsed() in BlockChain.h, which is a no-op.
-                cerror << DETAILED_ERROR;
-                assert( false );
-                break;
-            }
-            case ExtraReceipts: {
-                WriteGuard l( x_receipts );
-                m_receipts.erase( id.first );
-                break;
-            }
-            case ExtraLogBlooms: {
-                WriteGuard l( x_logBlooms );
-                m_logBlooms.erase( id.first );
-                break;
-            }
-            case ExtraTransactionAddress: {
-                WriteGuard l( x_transactionAddresses );
-                m_transactionAddresses.erase( id.first );
-                break;
-            }
-            case ExtraBlocksBlooms: {
-                WriteGuard l( x_blocksBlooms );
-                m_blocksBlooms.erase( id.first );
-                break;
-            }
-            }
-        }
-        m_cacheUsage.pop_back();
-        m_cacheUsage.push_front( std::unordered_set< CacheID >{} );
-        updateStats();
-    }
-
-
-    {
-        WriteGuard l( x_blockHashes );
-        // This is where block hash memory cleanup is treated
-        // allow only 4096 blockhashes in the cache
-        if ( m_blockHashes.size() > 4096 ) {
-            auto last = m_blockHashes.begin();
-            std::advance( last, ( m_blockHashes.size() - 4096 ) );
-            m_blockHashes.erase( m_blockHashes.begin(), last );
-            assert( m_blockHashes.size() == 4096 );
-        }
-    }
+    updateStats();
 }
 
 void BlockChain::clearCaches() {
-    {
-        Guard l( x_cacheUsage );
-        m_inUse.clear();
-
-        int n = m_cacheUsage.size();
-        m_cacheUsage.clear();
-        m_cacheUsage.resize( n );
-    }
-    {
-        WriteGuard l( x_details );
-        m_details.clear();
-    }
-    {
-        WriteGuard l( x_blocks );
-        m_blocks.clear();
-    }
-    {
-        WriteGuard l( x_logBlooms );
-        m_logBlooms.clear();
-    }
-    {
-        WriteGuard l( x_receipts );
-        m_receipts.clear();
-    }
-    {
-        WriteGuard l( x_transactionAddresses );
-        m_transactionAddresses.clear();
-    }
-    {
-        WriteGuard l( x_blocksBlooms );
-        m_blocksBlooms.clear();
-    }
-    {
-        WriteGuard l( x_blockHashes );
-        m_blockHashes.clear();
-    }
+    m_details.clear();
+    m_blocks.clear();
+    m_logBlooms.clear();
+    m_receipts.clear();
+    m_transactionAddresses.clear();
+    m_blocksBlooms.clear();
+    m_blockHashes.clear();
 }
 
 void BlockChain::doLevelDbCompaction() const {
-    for ( auto it = m_rotator->begin(); it != m_rotator->end(); ++it ) {
-        dev::db::LevelDB* ldb = dynamic_cast< dev::db::LevelDB* >( it->get() );
-        assert( ldb );
-        ldb->doCompaction();
-    }
+    m_rotating_db->doCompaction();
 }
 
 void BlockChain::checkConsistency() {
-    DEV_WRITE_GUARDED( x_details ) { m_details.clear(); }
+    m_details.clear();
 
     m_blocksDB->forEach( [this]( db::Slice const& _key, db::Slice const& /* _value */ ) {
         if ( _key.size() == 32 ) {
@@ -1451,10 +1330,8 @@ void BlockChain::checkConsistency() {
 
 void BlockChain::clearCachesDuringChainReversion( unsigned _firstInvalid ) {
     unsigned end = m_lastBlockNumber + 1;
-    DEV_WRITE_GUARDED( x_blockHashes )
     for ( auto i = _firstInvalid; i < end; ++i )
         m_blockHashes.erase( i );
-    DEV_WRITE_GUARDED( x_transactionAddresses )
     m_transactionAddresses.clear();  // TODO: could perhaps delete them individually?
 
     // If we are reverting previous blocks, we need to clear their blooms (in particular, to
@@ -1564,12 +1441,10 @@ bool BlockChain::isKnown( h256 const& _hash, bool _isCurrent ) const {
     if ( _hash == m_genesisHash )
         return true;
 
-    DEV_READ_GUARDED( x_blocks )
-    if ( !m_blocks.count( _hash ) && !m_blocksDB->exists( toSlice( _hash ) ) ) {
+    if ( !m_blocks.contains( _hash ) && !m_blocksDB->exists( toSlice( _hash ) ) ) {
         return false;
     }
-    DEV_READ_GUARDED( x_details )
-    if ( !m_details.count( _hash ) && !m_extrasDB->exists( toSlice( _hash, ExtraDetails ) ) ) {
+    if ( !m_details.contains( _hash ) && !m_extrasDB->exists( toSlice( _hash, ExtraDetails ) ) ) {
         return false;
     }
     //  return true;
@@ -1581,12 +1456,8 @@ bytes BlockChain::block( h256 const& _hash ) const {
     if ( _hash == m_genesisHash )
         return m_params.genesisBlock();
 
-    {
-        ReadGuard l( x_blocks );
-        auto it = m_blocks.find( _hash );
-        if ( it != m_blocks.end() )
-            return it->second;
-    }
+    if ( std::optional< bytes > cached = m_blocks.get( _hash ) )
+        return *cached;
 
     string d = m_blocksDB->lookup( toSlice( _hash ) );
     if ( d.empty() ) {
@@ -1594,25 +1465,18 @@ bytes BlockChain::block( h256 const& _hash ) const {
         return bytes();
     }
 
-    noteUsed( _hash );
-
-    WriteGuard l( x_blocks );
-    m_blocks[_hash].resize( d.size() );
-    memcpy( m_blocks[_hash].data(), d.data(), d.size() );
-
-    return m_blocks[_hash];
+    return m_blocks.insert( _hash, bytes( d.begin(), d.end() ) );
 }
 
 bytes BlockChain::headerData( h256 const& _hash ) const {
     if ( _hash == m_genesisHash )
         return m_genesisHeaderBytes;
 
-    {
-        ReadGuard l( x_blocks );
-        auto it = m_blocks.find( _hash );
-        if ( it != m_blocks.end() )
-            return BlockHeader::extractHeader( &it->second ).data().toBytes();
-    }
+    bytes header;
+    if ( m_blocks.visit( _hash, [&header]( bytes const& _block ) {
+             header = BlockHeader::extractHeader( &_block ).data().toBytes();
+         } ) )
+        return header;
 
     string d = m_blocksDB->lookup( toSlice( _hash ) );
     if ( d.empty() ) {
@@ -1620,13 +1484,8 @@ bytes BlockChain::headerData( h256 const& _hash ) const {
         return bytes();
     }
 
-    noteUsed( _hash );
-
-    WriteGuard l( x_blocks );
-    m_blocks[_hash].resize( d.size() );
-    memcpy( m_blocks[_hash].data(), d.data(), d.size() );
-
-    return BlockHeader::extractHeader( &m_blocks[_hash] ).data().toBytes();
+    bytes const block = m_blocks.insert( _hash, bytes( d.begin(), d.end() ) );
+    return BlockHeader::extractHeader( &block ).data().toBytes();
 }
 
 Block BlockChain::genesisBlock(
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <unordered_map>
@@ -47,6 +48,7 @@
 #include "BlockDetails.h"
 #include "BlockQueue.h"
 #include "ChainParams.h"
+#include "ExtrasCache.h"
 #include "LastBlockHashesFace.h"
 #include "Transaction.h"
 #include "VerifiedBlock.h"
@@ -189,8 +191,7 @@ public:
     /// Get the familial details concerning a block (or the most recent mined if none given).
     /// Thread-safe.
     BlockDetails details( h256 const& _hash ) const {
-        return queryExtras< BlockDetails, ExtraDetails >(
-            _hash, m_details, x_details, NullBlockDetails );
+        return queryExtras< BlockDetails, ExtraDetails >( _hash, m_details, NullBlockDetails );
     }
     BlockDetails details() const { return details( currentHash() ); }
 
@@ -198,22 +199,23 @@ public:
     /// Thread-safe.
     BlockLogBlooms logBlooms( h256 const& _hash ) const {
         return queryExtras< BlockLogBlooms, ExtraLogBlooms >(
-            _hash, m_logBlooms, x_logBlooms, NullBlockLogBlooms );
+            _hash, m_logBlooms, NullBlockLogBlooms );
     }
     BlockLogBlooms logBlooms() const { return logBlooms( currentHash() ); }
 
     /// Get the transactions' receipts of a block (or the most recent mined if none given).
     /// Thread-safe. receipts are given in the same order are in the same order as the transactions
     BlockReceipts receipts( h256 const& _hash ) const {
-        return queryExtras< BlockReceipts, ExtraReceipts >(
-            _hash, m_receipts, x_receipts, NullBlockReceipts );
+        return queryExtras< BlockReceipts, ExtraReceipts >( _hash, m_receipts, NullBlockReceipts );
     }
     BlockReceipts receipts() const { return receipts( currentHash() ); }
 
-    /// Get the transaction by block hash and index;
-    TransactionReceipt transactionReceipt( h256 const& _blockHash, unsigned _i ) const {
-        return receipts( _blockHash ).receipts[_i];
-    }
+    /// Get the transaction by block hash and index. If receipts of the block are not cached
+    /// only the requested one is decoded, and nothing is added to the cache. Thread-safe.
+    TransactionReceipt transactionReceipt( h256 const& _blockHash, unsigned _i ) const;
+
+    /// Get gas used by the transaction alone, without decoding logs of its block. Thread-safe.
+    u256 transactionGasUsed( h256 const& _blockHash, unsigned _i ) const;
 
     /// Get the transaction receipt by transaction hash. Thread-safe.
     TransactionReceipt transactionReceipt( h256 const& _transactionHash ) const {
@@ -253,7 +255,7 @@ public:
         if ( !_i )
             return genesisHash();
         return queryExtras< BlockHash, uint64_t, ExtraBlockHash >(
-            _i, m_blockHashes, x_blockHashes, NullBlockHash )
+            _i, m_blockHashes, NullBlockHash )
             .value;
     }
 
@@ -280,7 +282,7 @@ public:
     }
     BlocksBlooms blocksBlooms( h256 const& _chunkId ) const {
         auto res = queryExtras< BlocksBlooms, ExtraBlocksBlooms >(
-            _chunkId, m_blocksBlooms, x_blocksBlooms, NullBlocksBlooms );
+            _chunkId, m_blocksBlooms, NullBlocksBlooms );
         // std::cerr << "Queried " << _chunkId.hex() << "->" << std::endl;
         // for ( size_t i = 0; i < 16; ++i )
         //    std::cerr << "\t" << i << " = " << res.blooms[i].hex() << std::endl;
@@ -298,16 +300,16 @@ public:
     /// Returns true if transaction is known. Thread-safe
     bool isKnownTransaction( h256 const& _transactionHash ) const {
         TransactionAddress ta =
-            queryExtras< TransactionAddress, ExtraTransactionAddress >( _transactionHash,
-                m_transactionAddresses, x_transactionAddresses, NullTransactionAddress );
+            queryExtras< TransactionAddress, ExtraTransactionAddress >(
+                _transactionHash, m_transactionAddresses, NullTransactionAddress );
         return !!ta;
     }
 
     /// Get a transaction from its hash. Thread-safe.
     bytes transaction( h256 const& _transactionHash ) const {
         TransactionAddress ta =
-            queryExtras< TransactionAddress, ExtraTransactionAddress >( _transactionHash,
-                m_transactionAddresses, x_transactionAddresses, NullTransactionAddress );
+            queryExtras< TransactionAddress, ExtraTransactionAddress >(
+                _transactionHash, m_transactionAddresses, NullTransactionAddress );
         if ( !ta )
             return bytes();
         return transaction( ta.blockHash, ta.index );
@@ -411,6 +413,10 @@ public:
         return m_lastStats;
     }
 
+    /// @returns count of extras lookups served from memory and from the database
+    uint64_t extrasCacheHits() const { return m_extrasCacheHits; }
+    uint64_t extrasCacheMisses() const { return m_extrasCacheMisses; }
+
     /// Deallocate unused data.
     void garbageCollect( bool _force = false );
 
@@ -490,58 +496,25 @@ private:
     void checkBlockTimestamp( BlockHeader const& _header ) const;
 
     template < class T, class K, unsigned N >
-    T queryExtras( K const& _h, std::unordered_map< K, T >& _m, boost::shared_mutex& _x,
-        T const& _n, batched_io::db_face* _extrasDB = nullptr ) const {
-        {
-            ReadGuard l( _x );
-            auto it = _m.find( _h );
-            if ( it != _m.end() )
-                return it->second;
-        }
-
-        std::string const s = ( _extrasDB ? _extrasDB : m_extrasDB )->lookup( toSlice( _h, N ) );
-        if ( s.empty() )
-            return _n;
-
-        noteUsed( _h, N );
-
-        WriteGuard l( _x );
-        auto ret = _m.insert( std::make_pair( _h, T( RLP( s ) ) ) );
-        return ret.first->second;
-    }
-
-    template < class T, class K, unsigned N >
-    T queryExtras( K const& _h, std::map< K, T >& _m, boost::shared_mutex& _x, T const& _n,
+    T queryExtras( K const& _h, ExtrasCache< K, T >& _m, T const& _n,
         batched_io::db_face* _extrasDB = nullptr ) const {
-        {
-            ReadGuard l( _x );
-            auto it = _m.find( _h );
-            if ( it != _m.end() )
-                return it->second;
+        if ( std::optional< T > cached = _m.get( _h ) ) {
+            m_extrasCacheHits.fetch_add( 1, std::memory_order_relaxed );
+            return *cached;
         }
+        m_extrasCacheMisses.fetch_add( 1, std::memory_order_relaxed );
 
         std::string const s = ( _extrasDB ? _extrasDB : m_extrasDB )->lookup( toSlice( _h, N ) );
         if ( s.empty() )
             return _n;
 
-        noteUsed( _h, N );
-
-        WriteGuard l( _x );
-        auto ret = _m.insert( std::make_pair( _h, T( RLP( s ) ) ) );
-        return ret.first->second;
+        return _m.insert( _h, T( RLP( s ) ) );
     }
 
-
     template < class T, unsigned N >
-    T queryExtras( h256 const& _h, std::unordered_map< h256, T >& _m, boost::shared_mutex& _x,
-        T const& _n, batched_io::db_face* _extrasDB = nullptr ) const {
-        return queryExtras< T, h256, N >( _h, _m, _x, _n, _extrasDB );
-    }
-
-    template < class T, unsigned N >
-    T queryExtras( h256 const& _h, std::map< h256, T >& _m, boost::shared_mutex& _x, T const& _n,
+    T queryExtras( h256 const& _h, ExtrasCache< h256, T >& _m, T const& _n,
         batched_io::db_face* _extrasDB = nullptr ) const {
-        return queryExtras< T, h256, N >( _h, _m, _x, _n, _extrasDB );
+        return queryExtras< T, h256, N >( _h, _m, _n, _extrasDB );
     }
 
     void checkConsistency();
@@ -551,32 +524,19 @@ private:
     void clearCachesDuringChainReversion( unsigned _firstInvalid );
     void clearBlockBlooms( unsigned _begin, unsigned _end );
 
-    /// The caches of the disk DB and their locks.
-    mutable SharedMutex x_blocks;
-    mutable BlocksHash m_blocks;
-    mutable SharedMutex x_details;
-    mutable BlockDetailsHash m_details;
-    mutable SharedMutex x_logBlooms;
-    mutable BlockLogBloomsHash m_logBlooms;
-    mutable SharedMutex x_receipts;
-    mutable BlockReceiptsHash m_receipts;
-    mutable SharedMutex x_transactionAddresses;
-    mutable TransactionAddressHash m_transactionAddresses;
-    mutable SharedMutex x_blockHashes;
-    mutable BlockHashHash m_blockHashes;
-    mutable SharedMutex x_blocksBlooms;
-    mutable BlocksBloomsHash m_blocksBlooms;
-
-    using CacheID = std::pair< h256, unsigned >;
-    mutable Mutex x_cacheUsage;
-    mutable std::deque< std::unordered_set< CacheID > > m_cacheUsage;
-    mutable std::unordered_set< CacheID > m_inUse;
-    void noteUsed( h256 const& _h, unsigned _extra = ( unsigned ) -1 ) const;
-    void noteUsed( uint64_t const& _h, unsigned _extra = ( unsigned ) -1 ) const {
-        ( void ) _h;
-        ( void ) _extra;
-    }  // don't note non-hash types
-    std::chrono::system_clock::time_point m_lastCollection;
+    /// The caches of the disk DB, each keeps its own locks. Their total size is kept within
+    /// budget by garbageCollect().
+    mutable ExtrasCache< h256, bytes > m_blocks{ "blocks" };
+    mutable ExtrasCache< h256, BlockDetails > m_details{ "details" };
+    mutable ExtrasCache< h256, BlockLogBlooms > m_logBlooms{ "logBlooms" };
+    mutable ExtrasCache< h256, BlockReceipts > m_receipts{ "receipts" };
+    mutable ExtrasCache< h256, TransactionAddress > m_transactionAddresses{
+        "transactionAddresses" };
+    mutable ExtrasCache< uint64_t, BlockHash > m_blockHashes{ "blockHashes" };
+    mutable ExtrasCache< h256, BlocksBlooms > m_blocksBlooms{ "blocksBlooms" };
+
+    mutable std::atomic< uint64_t > m_extrasCacheHits = 0;
+    mutable std::atomic< uint64_t > m_extrasCacheMisses = 0;
 
     void noteCanonChanged() const { m_lastBlockHashes->clear(); }
     std::unique_ptr< LastBlockHashesFace > m_lastBlockHashes;
@@ -588,8 +548,7 @@ private:
     uint64_t m_maxStorageUsage;
 
     /// The disk DBs. Thread-safe, so no need for locks.
-    std::shared_ptr< batched_io::rotating_db_io > m_rotator;       // for compaction
-    std::shared_ptr< db::ManuallyRotatingLevelDB > m_rotating_db;  // rotate()
+    std::shared_ptr< db::ManuallyRotatingLevelDB > m_rotating_db;  // rotate(), compaction
     std::shared_ptr< batched_io::db_face > m_db;                   // insert()/commit()
     std::unique_ptr< batched_io::db_splitter > m_db_splitter;      // new_interface()
     batched_io::db_operations_face* m_blocksDB;                    // working horse 1!
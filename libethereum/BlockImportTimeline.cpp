@@ -0,0 +1,175 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BlockImportTimeline.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace dev {
+namespace eth {
+
+namespace {
+// rusage counts block I/O in 512-byte units
+const uint64_t c_ioBlockSize = 512;
+
+uint64_t toMicroseconds( std::chrono::steady_clock::time_point const& _time ) {
+    return std::chrono::duration_cast< std::chrono::microseconds >( _time.time_since_epoch() )
+        .count();
+}
+
+uint64_t currentThreadId() {
+    thread_local uint64_t const id = ::syscall( SYS_gettid );
+    return id;
+}
+
+// block open on this thread, it is touched only by this thread until it is finished
+thread_local std::unique_ptr< BlockImportTimeline::BlockTimeline > t_openBlock;
+}  // namespace
+
+const size_t BlockImportTimeline::c_defaultCapacity = 256;
+
+BlockImportTimeline::Sample BlockImportTimeline::Sample::now() {
+    Sample sample;
+    sample.wall = std::chrono::steady_clock::now();
+    struct rusage usage;
+    if ( ::getrusage( RUSAGE_THREAD, &usage ) == 0 ) {
+        sample.cpuMicroseconds = ( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) * 1000000ULL +
+                                 usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+        sample.ioReadBytes = usage.ru_inblock * c_ioBlockSize;
+        sample.ioWriteBytes = usage.ru_oublock * c_ioBlockSize;
+        sample.majorFaults = usage.ru_majflt;
+    }
+    return sample;
+}
+
+BlockImportTimeline::ScopedStage::ScopedStage(
+    char const* _name, char const* _category, std::string _detail )
+    : m_name( _name ), m_category( _category ), m_detail( std::move( _detail ) ) {
+    if ( instance().isBlockOpen() )
+        m_start = Sample::now();
+}
+
+BlockImportTimeline::ScopedStage::~ScopedStage() {
+    if ( m_start )
+        instance().addStage( m_name, m_category, m_detail, *m_start, Sample::now() );
+}
+
+BlockImportTimeline& BlockImportTimeline::instance() {
+    static BlockImportTimeline timeline;
+    return timeline;
+}
+
+void BlockImportTimeline::beginBlock( uint64_t _number ) {
+    t_openBlock.reset( new BlockTimeline );
+    t_openBlock->number = _number;
+    t_openBlock->threadId = currentThreadId();
+    t_openBlock->start = Sample::now();
+}
+
+void BlockImportTimeline::endBlock() {
+    if ( !t_openBlock )
+        return;
+    t_openBlock->finish = Sample::now();
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_finished.push_back( std::move( *t_openBlock ) );
+    t_openBlock.reset();
+    while ( m_finished.size() > m_capacity )
+        m_finished.pop_front();
+}
+
+bool BlockImportTimeline::isBlockOpen() const {
+    return t_openBlock != nullptr;
+}
+
+void BlockImportTimeline::addStage( std::string const& _name, std::string const& _category,
+    std::string const& _detail, Sample const& _start, Sample const& _finish ) {
+    if ( !t_openBlock )
+        return;
+    t_openBlock->stages.push_back(
+        Stage{ _name, _category, _detail, currentThreadId(), _start, _finish } );
+}
+
+void BlockImportTimeline::setCapacity( size_t _capacity ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_capacity = std::max< size_t >( _capacity, 1 );
+    while ( m_finished.size() > m_capacity )
+        m_finished.pop_front();
+}
+
+std::vector< BlockImportTimeline::BlockTimeline > BlockImportTimeline::lastBlocks(
+    size_t _count ) const {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    size_t const count = std::min( _count, m_finished.size() );
+    return std::vector< BlockTimeline >( m_finished.end() - count, m_finished.end() );
+}
+
+Json::Value BlockImportTimeline::toChromeTrace( size_t _count ) const {
+    auto const fillEvent = []( Json::Value& _event, Sample const& _start, Sample const& _finish ) {
+        _event["ph"] = "X";
+        _event["pid"] = Json::Value::UInt64( ::getpid() );
+        _event["ts"] = Json::Value::UInt64( toMicroseconds( _start.wall ) );
+        _event["dur"] = Json::Value::UInt64( toMicroseconds( _finish.wall ) -
+                                             toMicroseconds( _start.wall ) );
+        Json::Value& args = _event["args"];
+        args["cpu_us"] = Json::Value::UInt64( _finish.cpuMicroseconds - _start.cpuMicroseconds );
+        args["io_read_bytes"] = Json::Value::UInt64( _finish.ioReadBytes - _start.ioReadBytes );
+        args["io_write_bytes"] =
+            Json::Value::UInt64( _finish.ioWriteBytes - _start.ioWriteBytes );
+        args["major_faults"] = Json::Value::UInt64( _finish.majorFaults - _start.majorFaults );
+    };
+
+    Json::Value events( Json::arrayValue );
+    for ( auto const& block : lastBlocks( _count ) ) {
+        Json::Value blockEvent;
+        blockEvent["name"] = "block " + std::to_string( block.number );
+        blockEvent["cat"] = "block";
+        // cpu, io and faults of the whole block are only meaningful per stage
+        fillEvent( blockEvent, block.start, block.finish );
+        blockEvent["args"] = Json::Value( Json::objectValue );
+        blockEvent["args"]["number"] = Json::Value::UInt64( block.number );
+        blockEvent["tid"] = Json::Value::UInt64( block.threadId );
+        events.append( blockEvent );
+
+        for ( auto const& stage : block.stages ) {
+            Json::Value event;
+            event["name"] = stage.name;
+            event["cat"] = stage.category;
+            event["tid"] = Json::Value::UInt64( stage.threadId );
+            fillEvent( event, stage.start, stage.finish );
+            if ( !stage.detail.empty() )
+                event["args"]["detail"] = stage.detail;
+            events.append( event );
+        }
+    }
+
+    Json::Value trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    return trace;
+}
+
+}  // namespace eth
+}  // namespace dev
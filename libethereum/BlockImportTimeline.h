@@ -0,0 +1,132 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Per-block timeline of block import stages.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dev {
+namespace eth {
+
+/// Records how long each stage of a block import took.
+/// SkaleHost::createBlock opens a timeline for every block, code on the import path records
+/// stages into it, and finished timelines of the last blocks are kept in a ring buffer.
+/// The open block belongs to the thread that opened it, stages recorded by other threads
+/// (e.g. RPC calls executing transactions) are ignored.
+/// Each stage carries wall time and, for the recording thread, CPU time, block I/O and major
+/// page faults. Page faults stand in for cache misses, as hardware counters are usually not
+/// available to the node.
+class BlockImportTimeline {
+public:
+    struct Sample {
+        std::chrono::steady_clock::time_point wall;
+        uint64_t cpuMicroseconds = 0;
+        uint64_t ioReadBytes = 0;
+        uint64_t ioWriteBytes = 0;
+        uint64_t majorFaults = 0;
+
+        static Sample now();
+    };
+
+    struct Stage {
+        std::string name;
+        std::string category;
+        /// e.g. hash of the transaction
+        std::string detail;
+        uint64_t threadId = 0;
+        Sample start;
+        Sample finish;
+    };
+
+    struct BlockTimeline {
+        uint64_t number = 0;
+        uint64_t threadId = 0;
+        Sample start;
+        Sample finish;
+        std::vector< Stage > stages;
+    };
+
+    /// Records a stage from construction to destruction if a block is open
+    class ScopedStage {
+    public:
+        explicit ScopedStage( char const* _name, char const* _category = "block",
+            std::string _detail = std::string() );
+        ~ScopedStage();
+
+        ScopedStage( ScopedStage const& ) = delete;
+        ScopedStage& operator=( ScopedStage const& ) = delete;
+
+    private:
+        char const* m_name;
+        char const* m_category;
+        std::string m_detail;
+        std::optional< Sample > m_start;
+    };
+
+    /// Opens the timeline of a block on construction and closes it on destruction
+    class ScopedBlock {
+    public:
+        explicit ScopedBlock( uint64_t _number ) { instance().beginBlock( _number ); }
+        ~ScopedBlock() { instance().endBlock(); }
+
+        ScopedBlock( ScopedBlock const& ) = delete;
+        ScopedBlock& operator=( ScopedBlock const& ) = delete;
+    };
+
+    static BlockImportTimeline& instance();
+
+    void beginBlock( uint64_t _number );
+    void endBlock();
+    /// @returns true if a block is open on the calling thread
+    bool isBlockOpen() const;
+
+    /// Does nothing if no block is open on the calling thread
+    void addStage( std::string const& _name, std::string const& _category,
+        std::string const& _detail, Sample const& _start, Sample const& _finish );
+
+    void setCapacity( size_t _capacity );
+
+    /// @returns timelines of the last _count blocks, oldest first
+    std::vector< BlockTimeline > lastBlocks( size_t _count ) const;
+
+    /// @returns timelines of the last _count blocks in Chrome trace event format
+    Json::Value toChromeTrace( size_t _count ) const;
+
+    static const size_t c_defaultCapacity;
+
+private:
+    BlockImportTimeline() = default;
+
+    mutable std::mutex m_mutex;
+    std::deque< BlockTimeline > m_finished;
+    size_t m_capacity = c_defaultCapacity;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -252,6 +252,25 @@ void ChainParams::processSkaleConfigItems( ChainParams& cp, json_spirit::mObject
         static_cast< uint16_t >( port6 ), sgxServerUrl, ecdsaKeyName, keyShareName, BLSPublicKeys,
         commonBLSPublicKeys, syncNode, archiveMode, syncFromCatchup, testSignatures };
 
+    cp.nodeInfo.historicStateRetainBlocks =
+        infoObj.count( "historicStateRetainBlocks" ) ?
+            infoObj.at( "historicStateRetainBlocks" ).get_uint64() :
+            0;
+    cp.nodeInfo.historicStateCheckpointInterval =
+        infoObj.count( "historicStateCheckpointInterval" ) ?
+            infoObj.at( "historicStateCheckpointInterval" ).get_uint64() :
+            0;
+    if ( infoObj.count( "traceOnImport" ) )
+        for ( auto const& tracer : infoObj.at( "traceOnImport" ).get_array() )
+            cp.nodeInfo.traceOnImport.push_back( tracer.get_str() );
+    if ( infoObj.count( "blocksDbCodecs" ) )
+        for ( auto const& [family, codec] : infoObj.at( "blocksDbCodecs" ).get_obj() )
+            cp.nodeInfo.blocksDbCodecs[family] = codec.get_str();
+    if ( infoObj.count( "blocksDbZstdLevel" ) )
+        cp.nodeInfo.blocksDbZstdLevel = infoObj.at( "blocksDbZstdLevel" ).get_int();
+    cp.nodeInfo.archiveColdTier =
+        infoObj.count( "archiveColdTier" ) ? infoObj.at( "archiveColdTier" ).get_bool() : false;
+
     auto sChainObj = skaleObj.at( "sChain" ).get_obj();
     SChain s{};
     s.nodes.clear();
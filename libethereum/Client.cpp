@@ -23,6 +23,7 @@
 
 #include "Client.h"
 #include "Block.h"
+#include "BlockImportTimeline.h"
 #include "Defaults.h"
 #include "Executive.h"
 #include "SkaleHost.h"
@@ -37,6 +38,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -108,6 +111,46 @@ void delete_lock_file( const fs::path& dir ) {
 }
 #endif  /// (defined __HAVE_SKALED_LOCK_FILE_INDICATING_CRITICAL_STOP__)
 
+#ifdef HISTORIC_STATE
+/// Threads replaying blocks for all debug_traceBlockRange calls together
+class TraceReplayThreads {
+public:
+    explicit TraceReplayThreads( size_t _count ) : m_free( _count ) {}
+
+    bool tryAcquire() {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if ( m_free == 0 )
+            return false;
+        --m_free;
+        return true;
+    }
+    void acquire() {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        m_freed.wait( lock, [this]() { return m_free > 0; } );
+        --m_free;
+    }
+    void release() {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            ++m_free;
+        }
+        m_freed.notify_one();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_freed;
+    size_t m_free;
+};
+
+TraceReplayThreads& traceReplayThreads() {
+    static TraceReplayThreads threads( std::max< size_t >(
+        1, std::min< size_t >(
+               std::thread::hardware_concurrency(), MAX_TRACE_BLOCK_RANGE_THREADS ) ) );
+    return threads;
+}
+#endif
+
 }  // namespace
 
 std::ostream& dev::eth::operator<<( std::ostream& _out, ActivityReport const& _r ) {
@@ -176,6 +219,13 @@ void Client::stopWorking() {
 
     m_snapshotAgent->terminate();
 
+#ifdef HISTORIC_STATE
+    if ( m_historicStateCompactor )
+        m_historicStateCompactor->stop();
+    if ( m_blockTraceStore )
+        m_blockTraceStore->stop();
+#endif
+
     m_new_block_watch.uninstallAll();
     m_new_pending_transaction_watch.uninstallAll();
 
@@ -267,6 +317,40 @@ void Client::init( WithExisting _forceAction, u256 _networkId ) {
 
     initStateFromDiskOrGenesis();
 
+#ifdef HISTORIC_STATE
+    HistoricStateRetention retention;
+    retention.retainBlocks = chainParams().nodeInfo.historicStateRetainBlocks;
+    retention.checkpointInterval = chainParams().nodeInfo.historicStateCheckpointInterval;
+    if ( retention.enabled() ) {
+        auto& historicState = m_state.mutableHistoricState();
+        m_historicStateCompactor = make_shared< HistoricStateCompactor >( historicState.db(),
+            historicState.blockToStateRootDB(), retention,
+            m_dbPath / ( std::string( HISTORIC_STATE_DIR ) + "_marks" ) );
+        // all states copied from m_state from now on share the compactor
+        historicState.setCompactor( m_historicStateCompactor );
+        LOG( m_logger ) << "Historic state retention: last " << retention.retainBlocks
+                        << " blocks, checkpoint every " << retention.checkpointInterval
+                        << " blocks";
+    }
+
+    if ( !chainParams().nodeInfo.traceOnImport.empty() ) {
+        std::vector< Json::Value > traceConfigs;
+        for ( auto const& tracer : chainParams().nodeInfo.traceOnImport ) {
+            Json::Value traceConfig( Json::objectValue );
+            traceConfig["tracer"] = tracer;
+            // fail early on unknown tracer names
+            m_storedTraceOptionsKeys.insert( TraceOptions::make( traceConfig ).toString() );
+            traceConfigs.push_back( traceConfig );
+        }
+        fs::path const traceStorePath = m_dbPath / BLOCK_TRACES_DIR;
+        fs::create_directories( traceStorePath );
+        m_blockTraceStore = make_unique< BlockTraceStore >( traceStorePath, traceConfigs,
+            [this]( uint64_t _blockNumber, Json::Value const& _traceConfig ) {
+                return traceBlock( _blockNumber, _traceConfig );
+            } );
+    }
+#endif
+
     // LAZY. TODO: move genesis state construction/commiting to stateDB opening and have this
     // just take the root from the genesis block.
 
@@ -442,14 +526,14 @@ void Client::appendFromNewPending(
     Guard l( x_filtersWatches );
     io_changed.insert( PendingChangedFilter );
     m_specialFilters.at( PendingChangedFilter ).push_back( _sha3 );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number.
-        auto m = i.second.filter.matches( _receipt );
+    for ( h256 const& id : m_filterIndex.candidates( _receipt ) ) {
+        InstalledFilter& f = m_filters.at( id );
+        auto m = f.filter.matches( _receipt );
         if ( m.size() ) {
             // filter catches them
             for ( LogEntry const& l : m )
-                i.second.changes_.push_back( LocalisedLogEntry( l ) );
-            io_changed.insert( i.first );
+                f.changes_.push_back( LocalisedLogEntry( l ) );
+            io_changed.insert( id );
         }
     }
 }
@@ -461,18 +545,21 @@ void Client::appendFromBlock( h256 const& _block, BlockPolarity _polarity, h256H
     Guard l( x_filtersWatches );
     io_changed.insert( ChainChangedFilter );
     m_specialFilters.at( ChainChangedFilter ).push_back( _block );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number & looks like block may contain a matching log entry.
-        for ( size_t j = 0; j < receipts.size(); j++ ) {
-            auto tr = receipts[j];
-            auto m = i.second.filter.matches( tr );
+    // receipts in the outer loop keep changes of each filter in block order
+    for ( size_t j = 0; j < receipts.size(); j++ ) {
+        TransactionReceipt const& tr = receipts[j];
+        h256 transactionHash;
+        for ( h256 const& id : m_filterIndex.candidates( tr ) ) {
+            InstalledFilter& f = m_filters.at( id );
+            auto m = f.filter.matches( tr );
             if ( m.size() ) {
-                auto transactionHash = transaction( _block, j ).sha3();
+                if ( !transactionHash )
+                    transactionHash = transaction( _block, j ).sha3();
                 // filter catches them
                 for ( LogEntry const& l : m )
-                    i.second.changes_.push_back( LocalisedLogEntry( l, _block,
+                    f.changes_.push_back( LocalisedLogEntry( l, _block,
                         ( BlockNumber ) bc().number( _block ), transactionHash, j, 0, _polarity ) );
-                io_changed.insert( i.first );
+                io_changed.insert( id );
             }
         }
     }
@@ -537,7 +624,10 @@ size_t Client::importTransactionsAsBlock(
         m_snapshotAgent->init( 0, _timestamp );
         m_snapshotAgentInited = true;
     }
-    m_snapshotAgent->finishHashComputingAndUpdateHashesIfNeeded( _timestamp );
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "snapshot_hash" );
+        m_snapshotAgent->finishHashComputingAndUpdateHashesIfNeeded( _timestamp );
+    }
 
     // begin, detect partially executed block
     bool bIsPartial = false;
@@ -583,10 +673,19 @@ size_t Client::importTransactionsAsBlock(
     // end, detect partially executed block
     //
     size_t cntSucceeded = 0;
-    cntSucceeded = syncTransactions(
-        _transactions, _gasPrice, _timestamp, bIsPartial ? &vecMissing : nullptr );
-    sealUnconditionally( false );
-    importWorkingBlock();
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "sync_transactions" );
+        cntSucceeded = syncTransactions(
+            _transactions, _gasPrice, _timestamp, bIsPartial ? &vecMissing : nullptr );
+    }
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "seal" );
+        sealUnconditionally( false );
+    }
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "import" );
+        importWorkingBlock();
+    }
 
     SchainPatch::useLatestBlockTimestamp( blockChain().info().timestamp() );
 
@@ -619,11 +718,27 @@ size_t Client::importTransactionsAsBlock(
     if ( chainParams().sChain.nodeGroups.size() > 0 )
         updateHistoricGroupIndex();
 
-    m_snapshotAgent->doSnapshotIfNeeded( number(), _timestamp );
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "snapshot_hooks" );
+        m_snapshotAgent->doSnapshotIfNeeded( number(), _timestamp );
+    }
+
+#ifdef HISTORIC_STATE
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "historic_hooks" );
+        if ( m_historicStateCompactor )
+            m_historicStateCompactor->onBlockImported( number() );
+        if ( m_blockTraceStore )
+            m_blockTraceStore->onBlockImported( number() );
+    }
+#endif
 
     // TEMPRORARY FIX!
     // TODO: REVIEW
-    tick();
+    {
+        BlockImportTimeline::ScopedStage timelineStage( "tick" );
+        tick();
+    }
 
     return cntSucceeded;
     assert( false );
@@ -1175,12 +1290,48 @@ h256 Client::importTransaction( Transaction const& _t ) {
             chainParams(), bc().info().timestamp(), number() );
     }
 
-    Executive::verifyTransaction( _t, bc().info().timestamp(),
-        bc().number() ? this->blockInfo( bc().currentHash() ) : bc().genesis(), state,
-        chainParams(), 0, gasBidPrice, chainParams().sChain.multiTransactionMode );
+    verifyAndQueueTransaction( _t, state,
+        bc().number() ? this->blockInfo( bc().currentHash() ) : bc().genesis(), gasBidPrice );
+
+    return _t.sha3();
+}
+
+size_t Client::importTransactions( Transactions& _transactions ) {
+    prepareForTransaction();
+
+    State state;
+    u256 gasBidPrice;
+
+    DEV_GUARDED( m_blockImportMutex ) {
+        state = this->state().createStateReadOnlyCopy();
+        gasBidPrice = this->gasBidPrice();
+
+        for ( Transaction& t : _transactions )
+            t.checkOutExternalGas( chainParams(), bc().info().timestamp(), number() );
+    }
+
+    BlockHeader const header =
+        bc().number() ? this->blockInfo( bc().currentHash() ) : bc().genesis();
+    size_t imported = 0;
+    for ( Transaction const& t : _transactions ) {
+        try {
+            verifyAndQueueTransaction( t, state, header, gasBidPrice );
+            ++imported;
+        } catch ( std::exception const& ex ) {
+            LOG( m_loggerDetail ) << "Skipped transaction " << t.sha3() << " of batch: "
+                                  << ex.what();
+        }
+    }
+    return imported;
+}
+
+void Client::verifyAndQueueTransaction( Transaction const& _t, State const& _state,
+    BlockHeader const& _header, u256 const& _gasBidPrice ) {
+    Executive::verifyTransaction( _t, bc().info().timestamp(), _header, _state, chainParams(), 0,
+        _gasBidPrice, chainParams().sChain.multiTransactionMode );
 
     ImportResult res;
-    if ( chainParams().sChain.multiTransactionMode && state.getNonce( _t.sender() ) < _t.nonce() &&
+    if ( chainParams().sChain.multiTransactionMode && _state.getNonce( _t.sender() ) < _t.nonce() &&
          m_tq.maxCurrentNonce( _t.sender() ) != _t.nonce() ) {
         res = m_tq.import( _t, IfDropped::Ignore, true );
     } else {
@@ -1203,8 +1354,6 @@ h256 Client::importTransaction( Transaction const& _t ) {
     }
 
     m_new_pending_transaction_watch.invoke( _t );
-
-    return _t.sha3();
 }
 
 // TODO: remove try/catch, allow exceptions
@@ -1300,6 +1449,8 @@ Json::Value Client::traceCall( Address const& _from, u256 _value, Address _to, b
             make_shared< AlethStandardTrace >( t, historicBlock.author(), traceOptions, true );
         tracer->setOriginalFromBalance( originalFromBalance );
         auto er = historicBlock.executeHistoricCall( bc().lastBlockHashes(), t, tracer, 0 );
+        if ( traceOptions.outputFormat == TraceOutputFormat::RLP )
+            return toHexPrefixed( tracer->getRLPResult() );
         return tracer->getJSONResult();
     } catch ( ... ) {
         cwarn << boost::current_exception_diagnostic_information();
@@ -1325,24 +1476,42 @@ Transaction Client::createTransactionForCallOrTraceCall( const Address& _from, c
 
 Json::Value Client::traceBlock( BlockNumber _blockNumber, Json::Value const& _jsonTraceConfig ) {
     try {
-        Block previousBlock = blockByNumber( _blockNumber - 1 );
-        Block historicBlock = blockByNumber( _blockNumber );
-
-        Json::Value traces( Json::arrayValue );
-
-        auto hash = ClientBase::hashFromNumber( _blockNumber );
-        Transactions transactions = this->transactions( hash );
-
         auto traceOptions = TraceOptions::make( _jsonTraceConfig );
+        auto const traceOptionsKey = traceOptions.toString();
 
         // cache results for better peformance
-        string key = to_string( _blockNumber ) + traceOptions.toString();
+        string key = to_string( _blockNumber ) + traceOptionsKey;
 
         auto cachedResult = m_blockTraceCache.getIfExists( key );
         if ( cachedResult.has_value() ) {
             return std::any_cast< Json::Value >( cachedResult );
         }
 
+        // only traces of the tracers run on import are stored, whichever block is traced
+        bool const isStored =
+            m_blockTraceStore && m_storedTraceOptionsKeys.count( traceOptionsKey ) > 0;
+        if ( isStored ) {
+            auto storedTraces = m_blockTraceStore->get( _blockNumber, traceOptionsKey );
+            if ( storedTraces ) {
+                m_blockTraceCache.put( key, *storedTraces, storedTraces->toStyledString().size() );
+                return *storedTraces;
+            }
+        }
+
+        Block previousBlock = blockByNumber( _blockNumber - 1 );
+        Block historicBlock = blockByNumber( _blockNumber );
+
+        Json::Value traces( Json::arrayValue );
+
+        auto hash = ClientBase::hashFromNumber( _blockNumber );
+        Transactions transactions = this->transactions( hash );
+
+        // in binary format the block is a list of [txHash, trace] pairs
+        bool const isRLP = traceOptions.outputFormat == TraceOutputFormat::RLP;
+        RLPStream rlpTraces;
+        if ( isRLP )
+            rlpTraces.appendList( transactions.size() );
+
         for ( unsigned k = 0; k < transactions.size(); k++ ) {
             Json::Value transactionLog( Json::objectValue );
             Transaction tx = transactions.at( k );
@@ -1353,13 +1522,23 @@ Json::Value Client::traceBlock( BlockNumber _blockNumber, Json::Value const& _js
                 std::make_shared< AlethStandardTrace >( tx, historicBlock.author(), traceOptions );
             auto executionResult =
                 previousBlock.executeHistoricCall( bc().lastBlockHashes(), tx, tracer, k );
+            if ( isRLP ) {
+                rlpTraces.appendList( 2 ) << tx.sha3();
+                rlpTraces.appendRaw( tracer->getRLPResult() );
+                continue;
+            }
             auto result = tracer->getJSONResult();
             transactionLog["result"] = result;
             traces.append( transactionLog );
         }
 
+        if ( isRLP )
+            traces = toHexPrefixed( rlpTraces.out() );
+
         auto tracesSize = traces.toStyledString().size();
         m_blockTraceCache.put( key, traces, tracesSize );
+        if ( isStored )
+            m_blockTraceStore->put( _blockNumber, traceOptionsKey, traces );
 
         return traces;
     } catch ( std::exception& e ) {
@@ -1368,6 +1547,60 @@ Json::Value Client::traceBlock( BlockNumber _blockNumber, Json::Value const& _js
     }
 }
 
+Json::Value Client::traceBlockRange(
+    BlockNumber _fromBlock, BlockNumber _toBlock, Json::Value const& _jsonTraceConfig ) {
+    if ( _fromBlock == 0 || _fromBlock > _toBlock )
+        BOOST_THROW_EXCEPTION( std::runtime_error( "Invalid block range" ) );
+    if ( size_t( _toBlock - _fromBlock ) + 1 > MAX_TRACE_BLOCK_RANGE )
+        BOOST_THROW_EXCEPTION( std::runtime_error( "Block range is too large" ) );
+
+    // blocks are independent: each one is replayed on its own historic state copy positioned
+    // at the parent root. Replay threads are shared by all calls, a call waits for one only
+    // when it has no blocks in flight. Results are collected in block order, so a slow block
+    // delays the window but never reorders output
+    TraceReplayThreads& threads = traceReplayThreads();
+    Json::Value result( Json::arrayValue );
+    size_t resultSize = 0;
+    std::deque< std::pair< BlockNumber, std::future< Json::Value > > > inFlight;
+    BlockNumber next = _fromBlock;
+    while ( next <= _toBlock || !inFlight.empty() ) {
+        while ( next <= _toBlock && inFlight.size() < MAX_TRACE_BLOCK_RANGE_THREADS ) {
+            if ( inFlight.empty() )
+                threads.acquire();
+            else if ( !threads.tryAcquire() )
+                break;
+            auto traceFuture = std::async(
+                std::launch::async, [this, next, &_jsonTraceConfig, &threads]() {
+                    try {
+                        Json::Value traces = traceBlock( next, _jsonTraceConfig );
+                        threads.release();
+                        return traces;
+                    } catch ( ... ) {
+                        threads.release();
+                        throw;
+                    }
+                } );
+            inFlight.emplace_back( next, std::move( traceFuture ) );
+            ++next;
+        }
+
+        Json::Value blockTraces( Json::objectValue );
+        blockTraces["blockNumber"] = Json::UInt64( inFlight.front().first );
+        blockTraces["traces"] = inFlight.front().second.get();
+        inFlight.pop_front();
+        resultSize += Json::FastWriter().write( blockTraces["traces"] ).size();
+        if ( resultSize > MAX_TRACE_BLOCK_RANGE_RESPONSE_SIZE ) {
+            // futures of the blocks in flight wait for them in their destructors
+            std::string const limit = to_string( MAX_TRACE_BLOCK_RANGE_RESPONSE_SIZE );
+            BOOST_THROW_EXCEPTION( std::runtime_error(
+                "Traces of the block range exceed " + limit + " bytes, request fewer blocks" ) );
+        }
+        result.append( blockTraces );
+    }
+
+    return result;
+}
+
 #endif
 
 
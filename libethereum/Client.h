@@ -31,6 +31,7 @@
 #include <map>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -57,6 +58,7 @@
 #include "ThreadSafeQueue.h"
 
 #include <libhistoric/AlethStandardTrace.h>
+#include <libhistoric/BlockTraceStore.h>
 #include <skutils/atomic_shared_ptr.h>
 #include <skutils/multithreading.h>
 
@@ -81,6 +83,10 @@ std::ostream& operator<<( std::ostream& _out, ActivityReport const& _r );
 #ifdef HISTORIC_STATE
 constexpr size_t MAX_BLOCK_TRACES_CACHE_SIZE = 64 * 1024 * 1024;
 constexpr size_t MAX_BLOCK_TRACES_CACHE_ITEMS = 1024 * 1024;
+// limits for debug_traceBlockRange, the threads are shared by all calls
+constexpr size_t MAX_TRACE_BLOCK_RANGE = 256;
+constexpr size_t MAX_TRACE_BLOCK_RANGE_THREADS = 32;
+constexpr size_t MAX_TRACE_BLOCK_RANGE_RESPONSE_SIZE = 128 * 1024 * 1024;
 #endif
 
 /**
@@ -121,6 +127,11 @@ public:
     /// Imports the given transaction into the transaction queue
     h256 importTransaction( Transaction const& _t ) override;
 
+    /// Imports a batch of transactions, e.g. received through broadcast, validating all of them
+    /// against one state snapshot. Invalid transactions are skipped.
+    /// @returns count of imported transactions
+    size_t importTransactions( Transactions& _transactions );
+
     /// Makes the given call. Nothing is recorded into the state.
     ExecutionResult call( Address const& _secret, u256 _value, Address _dest, bytes const& _data,
         u256 _gas, u256 _gasPrice,
@@ -133,6 +144,12 @@ public:
     Json::Value traceCall( Address const& _from, u256 _value, Address _to, bytes const& _data,
         u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, Json::Value const& _jsonTraceConfig );
     Json::Value traceBlock( BlockNumber _blockNumber, Json::Value const& _jsonTraceConfig );
+    /// Traces blocks [_fromBlock, _toBlock] concurrently, each on its own historic state.
+    /// The whole result is kept in memory, so its serialized size is limited by
+    /// MAX_TRACE_BLOCK_RANGE_RESPONSE_SIZE.
+    /// @returns array of { blockNumber, traces } ordered by block number
+    Json::Value traceBlockRange(
+        BlockNumber _fromBlock, BlockNumber _toBlock, Json::Value const& _jsonTraceConfig );
     Transaction createTransactionForCallOrTraceCall( const Address& _from, const u256& _value,
         const Address& _to, const bytes& _data, const u256& _gasLimit, const u256& _gasPrice,
         const u256& nonce ) const;
@@ -574,9 +591,20 @@ protected:
     fs::path m_dbPath;
 #ifdef HISTORIC_STATE
     cache::lru_ordered_memory_constrained_cache< std::string, Json::Value > m_blockTraceCache;
+    /// null unless historic state retention is configured
+    std::shared_ptr< HistoricStateCompactor > m_historicStateCompactor;
+    /// null unless tracing on import is configured
+    std::unique_ptr< BlockTraceStore > m_blockTraceStore;
+    /// TraceOptions::toString() of the traceOnImport tracers. Traces requested with other
+    /// options are only cached in memory, so the store holds a bounded size per block
+    std::set< std::string > m_storedTraceOptionsKeys;
 #endif
 
 private:
+    /// Validates _t against _state and puts it into the queue, throws if it is not accepted
+    void verifyAndQueueTransaction( Transaction const& _t, State const& _state,
+        BlockHeader const& _header, u256 const& _gasBidPrice );
+
     void initHistoricGroupIndex();
     void updateHistoricGroupIndex();
 
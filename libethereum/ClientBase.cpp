@@ -307,6 +307,7 @@ unsigned ClientBase::installWatch(
         if ( !m_filters.count( h ) ) {
             LOG( m_loggerWatch ) << "FFF" << _f << h;
             m_filters.insert( make_pair( h, _f ) );
+            m_filterIndex.insert( h, _f );
         }
     }
     return installWatch( h, _r, fnOnNewChanges, isWS );
@@ -348,6 +349,7 @@ bool ClientBase::uninstallWatch( unsigned _i ) {
     if ( fit != m_filters.end() )
         if ( !--fit->second.refCount ) {
             LOG( m_loggerWatch ) << "*X*" << fit->first << ":" << fit->second.filter;
+            m_filterIndex.erase( fit->first, fit->second.filter );
             m_filters.erase( fit );
         }
     return true;
@@ -424,9 +426,7 @@ LocalisedTransactionReceipt ClientBase::localisedTransactionReceipt(
             EIP1559TransactionsPatch::isEnabledWhen(
                 blockInfo( numberFromHash( tl.first ) - 1 ).timestamp() ) );
     TransactionReceipt tr = bc().transactionReceipt( tl.first, tl.second );
-    u256 gasUsed = tr.cumulativeGasUsed();
-    if ( tl.second > 0 )
-        gasUsed -= bc().transactionReceipt( tl.first, tl.second - 1 ).cumulativeGasUsed();
+    u256 gasUsed = bc().transactionGasUsed( tl.first, tl.second );
     //
     // The "contractAddress" field must be null for all types of transactions but contract
     // deployment ones. The contract deployment transaction is special because it's the only type of
@@ -28,6 +28,7 @@
 #include "CommonNet.h"
 #include "Interface.h"
 #include "LogFilter.h"
+#include "LogFilterIndex.h"
 #include "TransactionQueue.h"
 #include <chrono>
 
@@ -210,6 +211,7 @@ protected:
     mutable Mutex x_filtersWatches;                         ///< Our lock.
     std::unordered_map< h256, InstalledFilter > m_filters;  ///< The dictionary of filters that are
                                                             ///< active.
+    LogFilterIndex m_filterIndex;  ///< Which of m_filters may match a log, follows m_filters.
     std::unordered_map< h256, h256s > m_specialFilters =
         std::unordered_map< h256, std::vector< h256 > >{ { PendingChangedFilter, {} },
             { ChainChangedFilter, {} } };
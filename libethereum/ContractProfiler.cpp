@@ -0,0 +1,188 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ContractProfiler.h"
+
+#include <libdevcore/CommonJS.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace dev {
+namespace eth {
+
+namespace {
+std::string selectorToString( ContractProfiler::Key const& _key ) {
+    switch ( _key.kind ) {
+    case ContractProfiler::CallKind::Creation:
+        return "constructor";
+    case ContractProfiler::CallKind::Fallback:
+        return "fallback";
+    default:
+        return toJS( toCompactBigEndian( _key.selector, 4 ) );
+    }
+}
+}  // namespace
+
+const size_t ContractProfiler::c_capacity = 1024;
+
+thread_local ContractProfiler::Frame* ContractProfiler::s_currentFrame = nullptr;
+thread_local bool ContractProfiler::s_sampling = false;
+thread_local unsigned ContractProfiler::s_scopeDepth = 0;
+thread_local std::map< ContractProfiler::Key, ContractProfiler::Counters >
+    ContractProfiler::s_transactionCounters;
+
+ContractProfiler::Counters& ContractProfiler::Counters::operator+=( Counters const& _other ) {
+    nanoseconds += _other.nanoseconds;
+    calls += _other.calls;
+    storageReads += _other.storageReads;
+    storageWrites += _other.storageWrites;
+    dbMisses += _other.dbMisses;
+    return *this;
+}
+
+ContractProfiler::TransactionScope::TransactionScope( bool _enabled ) {
+    // nested scopes, e.g. of calls done during execution, belong to the outer transaction
+    // whether it is sampled or not
+    if ( s_scopeDepth++ > 0 )
+        return;
+    ContractProfiler& profiler = instance();
+    unsigned const rate = profiler.m_sampleRate;
+    if ( !_enabled || rate == 0 )
+        return;
+    if ( profiler.m_transactionCounter++ % rate != 0 )
+        return;
+    m_sampled = true;
+    s_sampling = true;
+}
+
+ContractProfiler::TransactionScope::~TransactionScope() {
+    --s_scopeDepth;
+    if ( !m_sampled )
+        return;
+    s_sampling = false;
+    instance().merge( s_transactionCounters );
+    s_transactionCounters.clear();
+}
+
+ContractProfiler::Frame::Frame( Address const& _address, bytesConstRef _data, bool _isCreation ) {
+    if ( !s_sampling )
+        return;
+    m_key.address = _address;
+    if ( _isCreation )
+        m_key.kind = CallKind::Creation;
+    else if ( _data.size() < 4 )
+        m_key.kind = CallKind::Fallback;
+    else
+        m_key.selector = fromBigEndian< uint32_t >( _data.cropped( 0, 4 ) );
+    m_counters.calls = 1;
+    m_parent = s_currentFrame;
+    s_currentFrame = this;
+    m_start = std::chrono::steady_clock::now();
+}
+
+ContractProfiler::Frame::~Frame() {
+    if ( s_currentFrame != this )
+        return;
+    uint64_t const total = std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now() - m_start )
+                               .count();
+    m_counters.nanoseconds = total - std::min( total, m_childNanoseconds );
+    if ( m_parent )
+        m_parent->m_childNanoseconds += total;
+    s_currentFrame = m_parent;
+    s_transactionCounters[m_key] += m_counters;
+}
+
+ContractProfiler& ContractProfiler::instance() {
+    static ContractProfiler profiler;
+    return profiler;
+}
+
+void ContractProfiler::merge( std::map< Key, Counters > const& _transactionCounters ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    ++m_sampledTransactions;
+    for ( auto const& [key, counters] : _transactionCounters ) {
+        auto it = m_entries.find( key );
+        if ( it != m_entries.end() ) {
+            it->second.counters += counters;
+            continue;
+        }
+        if ( m_entries.size() < c_capacity ) {
+            m_entries[key].counters = counters;
+            continue;
+        }
+        // Space-Saving: the new key takes over the lightest entry and its weight
+        auto lightest = std::min_element(
+            m_entries.begin(), m_entries.end(), []( auto const& _a, auto const& _b ) {
+                return _a.second.counters.nanoseconds < _b.second.counters.nanoseconds;
+            } );
+        Entry entry;
+        entry.errorNanoseconds = lightest->second.counters.nanoseconds;
+        entry.counters = counters;
+        entry.counters.nanoseconds += entry.errorNanoseconds;
+        m_entries.erase( lightest );
+        m_entries.emplace( key, entry );
+    }
+}
+
+void ContractProfiler::reset() {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_entries.clear();
+    m_sampledTransactions = 0;
+}
+
+Json::Value ContractProfiler::toJson( size_t _count ) const {
+    std::vector< std::pair< Key, Entry > > entries;
+    Json::Value result;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        entries.assign( m_entries.begin(), m_entries.end() );
+        result["sampledTransactions"] = Json::Value::UInt64( m_sampledTransactions );
+    }
+    result["sampleRate"] = m_sampleRate.load();
+
+    size_t const count = std::min( _count, entries.size() );
+    std::partial_sort( entries.begin(), entries.begin() + count, entries.end(),
+        []( auto const& _a, auto const& _b ) {
+            return _a.second.counters.nanoseconds > _b.second.counters.nanoseconds;
+        } );
+
+    Json::Value contracts( Json::arrayValue );
+    for ( size_t i = 0; i < count; ++i ) {
+        Key const& key = entries[i].first;
+        Entry const& entry = entries[i].second;
+        Json::Value item;
+        item["address"] = toJS( key.address );
+        item["selector"] = selectorToString( key );
+        item["timeMicroseconds"] = Json::Value::UInt64( entry.counters.nanoseconds / 1000 );
+        item["errorMicroseconds"] = Json::Value::UInt64( entry.errorNanoseconds / 1000 );
+        item["calls"] = Json::Value::UInt64( entry.counters.calls );
+        item["storageReads"] = Json::Value::UInt64( entry.counters.storageReads );
+        item["storageWrites"] = Json::Value::UInt64( entry.counters.storageWrites );
+        item["dbMisses"] = Json::Value::UInt64( entry.counters.dbMisses );
+        contracts.append( item );
+    }
+    result["contracts"] = contracts;
+    return result;
+}
+
+}  // namespace eth
+}  // namespace dev
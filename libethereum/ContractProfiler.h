@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Sampling profiler of contract execution time.
+ */
+
+#pragma once
+
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+
+#include <json/json.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace dev {
+namespace eth {
+
+/// Attributes execution time of sampled transactions to (contract, function selector).
+/// Every call frame records its own time without the time of nested calls, along with counts
+/// of storage reads and writes and of state lookups that missed the cache and went to the DB.
+/// Storage reads include the read of the current value that SSTORE does for gas calculation.
+/// Results are aggregated across blocks in a Space-Saving top-K summary, so heavy contracts are
+/// kept while the memory stays bounded. Each entry reports the upper bound of the error of its
+/// time, which is zero for contracts that have never been evicted.
+class ContractProfiler {
+public:
+    enum class CallKind { Function, Fallback, Creation };
+
+    struct Key {
+        Address address;
+        uint32_t selector = 0;
+        CallKind kind = CallKind::Function;
+
+        bool operator<( Key const& _other ) const {
+            return std::tie( address, selector, kind ) <
+                   std::tie( _other.address, _other.selector, _other.kind );
+        }
+    };
+
+    struct Counters {
+        uint64_t nanoseconds = 0;
+        uint64_t calls = 0;
+        uint64_t storageReads = 0;
+        uint64_t storageWrites = 0;
+        uint64_t dbMisses = 0;
+
+        Counters& operator+=( Counters const& _other );
+    };
+
+    /// Samples the transaction executed in its scope if _enabled and the sample rate selects it
+    class TransactionScope {
+    public:
+        explicit TransactionScope( bool _enabled );
+        ~TransactionScope();
+
+        TransactionScope( TransactionScope const& ) = delete;
+        TransactionScope& operator=( TransactionScope const& ) = delete;
+
+    private:
+        bool m_sampled = false;
+    };
+
+    /// One EVM call frame of a sampled transaction, does nothing otherwise
+    class Frame {
+    public:
+        Frame( Address const& _address, bytesConstRef _data, bool _isCreation );
+        ~Frame();
+
+        Frame( Frame const& ) = delete;
+        Frame& operator=( Frame const& ) = delete;
+
+    private:
+        friend class ContractProfiler;
+
+        Key m_key;
+        Counters m_counters;
+        std::chrono::steady_clock::time_point m_start;
+        // time spent in nested frames
+        uint64_t m_childNanoseconds = 0;
+        Frame* m_parent = nullptr;
+    };
+
+    static ContractProfiler& instance();
+
+    static void noteStorageRead() {
+        if ( s_currentFrame )
+            ++s_currentFrame->m_counters.storageReads;
+    }
+    static void noteStorageWrite() {
+        if ( s_currentFrame )
+            ++s_currentFrame->m_counters.storageWrites;
+    }
+    static void noteDbMiss() {
+        if ( s_currentFrame )
+            ++s_currentFrame->m_counters.dbMisses;
+    }
+
+    /// 0 disables profiling, N samples every Nth transaction
+    void setSampleRate( unsigned _rate ) { m_sampleRate = _rate; }
+    unsigned sampleRate() const { return m_sampleRate; }
+
+    void reset();
+
+    /// @returns _count heaviest entries by time, heaviest first
+    Json::Value toJson( size_t _count ) const;
+
+    static const size_t c_capacity;
+
+private:
+    struct Entry {
+        Counters counters;
+        // overestimation of nanoseconds inherited from the evicted entry
+        uint64_t errorNanoseconds = 0;
+    };
+
+    ContractProfiler() = default;
+
+    void merge( std::map< Key, Counters > const& _transactionCounters );
+
+    static thread_local Frame* s_currentFrame;
+    static thread_local bool s_sampling;
+    // count of open TransactionScopes, only the outermost one can be sampled
+    static thread_local unsigned s_scopeDepth;
+    static thread_local std::map< Key, Counters > s_transactionCounters;
+
+    std::atomic< unsigned > m_sampleRate = 0;
+    std::atomic< uint64_t > m_transactionCounter = 0;
+
+    mutable std::mutex m_mutex;
+    std::map< Key, Entry > m_entries;
+    uint64_t m_sampledTransactions = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
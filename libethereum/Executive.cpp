@@ -34,6 +34,7 @@
 
 #include "Block.h"
 #include "BlockChain.h"
+#include "ContractProfiler.h"
 #include "ExtVM.h"
 #include "Interface.h"
 
@@ -462,6 +463,7 @@ bool Executive::go( OnOpFunc const& _onOp ) {
 #if ETH_TIMED_EXECUTIONS
         Timer t;
 #endif
+        ContractProfiler::Frame profilerFrame( m_ext->myAddress, m_ext->data, m_isCreation );
         try {
             // Create VM instance. Force Interpreter if tracing requested.
             auto vm = VMFactory::create();
@@ -146,6 +146,7 @@ h256 ExtVM::codeHashAt( Address _a ) {
 }
 
 void ExtVM::setStore( u256 _n, u256 _v ) {
+    ContractProfiler::noteStorageWrite();
     m_s.setStorage( myAddress, _n, _v );
 }
 
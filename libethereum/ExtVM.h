@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "ContractProfiler.h"
 #include "Executive.h"
 
 #include <libethcore/Common.h>
@@ -54,7 +55,10 @@ public:
     }
 
     /// Read storage location.
-    virtual u256 store( u256 _n ) override final { return m_s.storage( myAddress, _n ); }
+    virtual u256 store( u256 _n ) override final {
+        ContractProfiler::noteStorageRead();
+        return m_s.storage( myAddress, _n );
+    }
 
     /// Write a value in storage.
     virtual void setStore( u256 _n, u256 _v ) override final;
@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Sharded in-memory cache of one family of blockchain extras.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/Metrics.h>
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/// Estimated memory taken by a cached value, the same as BlockChain::Statistics counted it
+template < class V >
+uint64_t extrasCacheEntrySize( V const& _value ) {
+    return _value.size + 64;
+}
+inline uint64_t extrasCacheEntrySize( bytes const& _value ) {
+    return _value.size() + 64;
+}
+
+/// Cache of one family of extras (details, receipts, ...) split into shards, each with its own
+/// lock, so lookups of different keys do not contend. A hit takes only a read lock of its shard
+/// and marks the entry as referenced. Eviction is CLOCK: evict() sweeps entries of a shard in a
+/// ring, removes those not referenced since the previous sweep and clears the mark of others.
+/// Memory is counted the same way as before, so the owner keeps the total within a budget.
+template < class K, class V >
+class ExtrasCache {
+public:
+    explicit ExtrasCache( std::string const& _family ) {
+        auto& registry = metrics::Registry::instance();
+        metrics::Labels const labels{ { "family", _family } };
+        m_hits = &registry.counter(
+            "skaled_extras_cache_hits_total", "Lookups of blockchain extras cache hits", labels );
+        m_misses = &registry.counter(
+            "skaled_extras_cache_misses_total", "Lookups of blockchain extras cache misses",
+            labels );
+        m_evictions = &registry.counter(
+            "skaled_extras_cache_evictions_total", "Entries evicted from extras cache", labels );
+    }
+
+    ExtrasCache( ExtrasCache const& ) = delete;
+    ExtrasCache& operator=( ExtrasCache const& ) = delete;
+
+    /// Calls _fn( value ) under the shard lock if _key is cached, counts hit or miss
+    /// @returns false if _key is not cached
+    template < class Fn >
+    bool visit( K const& _key, Fn&& _fn ) const {
+        Shard const& shard = shardOf( _key );
+        ReadGuard l( shard.mutex );
+        auto it = shard.entries.find( _key );
+        if ( it == shard.entries.end() ) {
+            m_misses->inc();
+            return false;
+        }
+        it->second.referenced.store( true, std::memory_order_relaxed );
+        m_hits->inc();
+        _fn( it->second.value );
+        return true;
+    }
+
+    std::optional< V > get( K const& _key ) const {
+        std::optional< V > ret;
+        visit( _key, [&ret]( V const& _value ) { ret = _value; } );
+        return ret;
+    }
+
+    bool contains( K const& _key ) const {
+        Shard const& shard = shardOf( _key );
+        ReadGuard l( shard.mutex );
+        return shard.entries.count( _key ) != 0;
+    }
+
+    /// Adds _value unless _key is cached already, @returns the cached value
+    V insert( K const& _key, V _value ) {
+        Shard& shard = shardOf( _key );
+        WriteGuard l( shard.mutex );
+        auto it = shard.entries.find( _key );
+        if ( it != shard.entries.end() )
+            return it->second.value;
+        return emplace( shard, _key, std::move( _value ) );
+    }
+
+    /// Sets _key to _value
+    void put( K const& _key, V _value ) {
+        Shard& shard = shardOf( _key );
+        WriteGuard l( shard.mutex );
+        eraseLocked( shard, _key );
+        emplace( shard, _key, std::move( _value ) );
+    }
+
+    void erase( K const& _key ) {
+        Shard& shard = shardOf( _key );
+        WriteGuard l( shard.mutex );
+        eraseLocked( shard, _key );
+    }
+
+    void clear() {
+        for ( Shard& shard : m_shards ) {
+            WriteGuard l( shard.mutex );
+            shard.entries.clear();
+            shard.hasHand = false;
+            m_bytes.fetch_sub( shard.bytes, std::memory_order_relaxed );
+            shard.bytes = 0;
+        }
+    }
+
+    /// Evicts entries not used recently until _bytes are freed or every shard is swept twice
+    /// @returns count of freed bytes
+    uint64_t evict( uint64_t _bytes ) {
+        uint64_t freed = 0;
+        for ( size_t i = 0; i < c_shards && freed < _bytes; ++i ) {
+            // each shard gives its share, the next shards give what the previous could not
+            uint64_t const share = ( _bytes - freed ) / ( c_shards - i ) + 1;
+            Shard& shard = m_shards[m_nextShard];
+            m_nextShard = ( m_nextShard + 1 ) % c_shards;
+            freed += evictFromShard( shard, share );
+        }
+        return freed;
+    }
+
+    uint64_t memoryUsage() const { return m_bytes.load( std::memory_order_relaxed ); }
+
+private:
+    // must be 2 ^ 4, see shardIndex()
+    static size_t const c_shards = 16;
+
+    struct Entry {
+        explicit Entry( V _value )
+            : value( std::move( _value ) ), bytes( extrasCacheEntrySize( value ) ) {}
+
+        V value;
+        uint64_t bytes;
+        // entries read once, as by a scan of old blocks, go first
+        mutable std::atomic< bool > referenced{ false };
+    };
+
+    struct Shard {
+        mutable SharedMutex mutex;
+        std::unordered_map< K, Entry > entries;
+        uint64_t bytes = 0;
+        // CLOCK hand, the key to continue the sweep from
+        K hand{};
+        bool hasHand = false;
+    };
+
+    // low bits of std::hash are poor for FixedHash and used by unordered_map, take the high ones
+    static size_t shardIndex( K const& _key ) {
+        uint64_t const h = std::hash< K >()( _key ) * 0x9e3779b97f4a7c15ULL;
+        return h >> 60;
+    }
+    Shard& shardOf( K const& _key ) { return m_shards[shardIndex( _key )]; }
+    Shard const& shardOf( K const& _key ) const { return m_shards[shardIndex( _key )]; }
+
+    V const& emplace( Shard& _shard, K const& _key, V _value ) {
+        auto it = _shard.entries
+                      .emplace( std::piecewise_construct, std::forward_as_tuple( _key ),
+                          std::forward_as_tuple( std::move( _value ) ) )
+                      .first;
+        _shard.bytes += it->second.bytes;
+        m_bytes.fetch_add( it->second.bytes, std::memory_order_relaxed );
+        return it->second.value;
+    }
+
+    void eraseLocked( Shard& _shard, K const& _key ) {
+        auto it = _shard.entries.find( _key );
+        if ( it == _shard.entries.end() )
+            return;
+        _shard.bytes -= it->second.bytes;
+        m_bytes.fetch_sub( it->second.bytes, std::memory_order_relaxed );
+        _shard.entries.erase( it );
+    }
+
+    uint64_t evictFromShard( Shard& _shard, uint64_t _bytes ) {
+        WriteGuard l( _shard.mutex );
+        auto& entries = _shard.entries;
+        auto it = entries.end();
+        if ( _shard.hasHand )
+            it = entries.find( _shard.hand );
+        if ( it == entries.end() )
+            it = entries.begin();
+
+        uint64_t freed = 0;
+        uint64_t evicted = 0;
+        // the 1st pass clears marks, the 2nd one evicts, the shard may become empty before
+        for ( size_t steps = 2 * entries.size(); steps > 0 && freed < _bytes && !entries.empty();
+              --steps ) {
+            if ( it == entries.end() )
+                it = entries.begin();
+            if ( it->second.referenced.exchange( false, std::memory_order_relaxed ) ) {
+                ++it;
+                continue;
+            }
+            freed += it->second.bytes;
+            ++evicted;
+            it = entries.erase( it );
+        }
+
+        _shard.hasHand = it != entries.end();
+        if ( _shard.hasHand )
+            _shard.hand = it->first;
+        _shard.bytes -= freed;
+        m_bytes.fetch_sub( freed, std::memory_order_relaxed );
+        m_evictions->inc( evicted );
+        return freed;
+    }
+
+    std::array< Shard, c_shards > m_shards;
+    std::atomic< uint64_t > m_bytes{ 0 };
+    // only evict() moves it, it is called from one thread
+    size_t m_nextShard = 0;
+
+    metrics::Counter* m_hits;
+    metrics::Counter* m_misses;
+    metrics::Counter* m_evictions;
+};
+
+}  // namespace eth
+}  // namespace dev
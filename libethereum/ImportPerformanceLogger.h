@@ -24,6 +24,8 @@
 
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/Metrics.h>
+#include <libethereum/BlockImportTimeline.h>
 
 #include <string>
 #include <unordered_map>
@@ -35,8 +37,17 @@ namespace eth {
 class ImportPerformanceLogger {
 public:
     void onStageFinished( std::string const& _name ) {
-        m_stages[_name] = m_stageTimer.elapsed();
+        double const elapsed = m_stageTimer.elapsed();
+        m_stages[_name] = elapsed;
         m_stageTimer.restart();
+        auto const now = BlockImportTimeline::Sample::now();
+        BlockImportTimeline::instance().addStage(
+            _name, "import", std::string(), m_stageStart, now );
+        m_stageStart = now;
+        metrics::Registry::instance()
+            .histogram( "skaled_block_import_stage_seconds",
+                "Duration of block import stages", { { "stage", _name } } )
+            .observe( elapsed );
     }
 
     double stageDuration( std::string const& _name ) const {
@@ -46,6 +57,9 @@ public:
 
     void onFinished( std::unordered_map< std::string, std::string > const& _additionalValues ) {
         double const totalElapsed = m_totalTimer.elapsed();
+        metrics::Registry::instance()
+            .histogram( "skaled_block_import_seconds", "Duration of block import" )
+            .observe( totalElapsed );
         if ( totalElapsed > 0.5 ) {
             cdebug << "SLOW IMPORT: { " << constructReport( totalElapsed, _additionalValues )
                    << " }";
@@ -58,6 +72,7 @@ private:
 
     Timer m_totalTimer;
     Timer m_stageTimer;
+    BlockImportTimeline::Sample m_stageStart = BlockImportTimeline::Sample::now();
     std::unordered_map< std::string, double > m_stages;
 };
 
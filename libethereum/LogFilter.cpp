@@ -139,7 +139,7 @@ LogEntries LogFilter::matches( TransactionReceipt const& _m ) const {
                 goto continue2;
             for ( unsigned i = 0; i < 4; ++i )
                 if ( !m_topics[i].empty() &&
-                     ( e.topics.size() < i || find( m_topics[i].begin(), m_topics[i].end(),
+                     ( e.topics.size() <= i || find( m_topics[i].begin(), m_topics[i].end(),
                                                   e.topics[i] ) == m_topics[i].end() ) )
                     goto continue2;
             ret.push_back( e );
@@ -0,0 +1,85 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LogFilterIndex.h"
+
+using namespace std;
+
+namespace dev {
+namespace eth {
+
+template < class Fn >
+bool LogFilterIndex::forEachKey( LogFilter const& _filter, Fn&& _fn ) {
+    std::vector< Address > const addresses = _filter.getAddresses();
+    if ( !addresses.empty() ) {
+        for ( Address const& address : addresses )
+            _fn( m_byAddress, address );
+        return true;
+    }
+    std::array< std::vector< h256 >, 4 > const topics = _filter.getTopics();
+    for ( size_t i = 0; i < topics.size(); ++i ) {
+        if ( topics[i].empty() )
+            continue;
+        for ( h256 const& topic : topics[i] )
+            _fn( m_byTopic[i], topic );
+        return true;
+    }
+    return false;
+}
+
+void LogFilterIndex::insert( h256 const& _id, LogFilter const& _filter ) {
+    bool const indexed =
+        forEachKey( _filter, [&]( auto& _map, auto const& _key ) { _map[_key].insert( _id ); } );
+    if ( !indexed )
+        m_rangeFilters.insert( _id );
+}
+
+void LogFilterIndex::erase( h256 const& _id, LogFilter const& _filter ) {
+    bool const indexed = forEachKey( _filter, [&]( auto& _map, auto const& _key ) {
+        auto it = _map.find( _key );
+        if ( it == _map.end() )
+            return;
+        it->second.erase( _id );
+        if ( it->second.empty() )
+            _map.erase( it );
+    } );
+    if ( !indexed )
+        m_rangeFilters.erase( _id );
+}
+
+h256Hash LogFilterIndex::candidates( TransactionReceipt const& _receipt ) const {
+    h256Hash ret;
+    if ( _receipt.log().empty() )
+        return ret;
+    ret = m_rangeFilters;
+    for ( LogEntry const& entry : _receipt.log() ) {
+        auto itAddress = m_byAddress.find( entry.address );
+        if ( itAddress != m_byAddress.end() )
+            ret.insert( itAddress->second.begin(), itAddress->second.end() );
+        for ( size_t i = 0; i < entry.topics.size() && i < m_byTopic.size(); ++i ) {
+            auto itTopic = m_byTopic[i].find( entry.topics[i] );
+            if ( itTopic != m_byTopic[i].end() )
+                ret.insert( itTopic->second.begin(), itTopic->second.end() );
+        }
+    }
+    return ret;
+}
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Index of installed log filters by address and topics.
+ */
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <libdevcore/Address.h>
+#include <libdevcore/FixedHash.h>
+
+#include <array>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/// Finds installed filters that may be interested in a receipt without testing every filter.
+/// Each filter is indexed under a single dimension: its addresses if it has any, otherwise
+/// the values of its first constrained topic. A filter can match a log only if the log has
+/// one of the values of that dimension, so looking up the address and the topics of each log
+/// gives a superset of matching filters, which are then checked with LogFilter::matches.
+/// Filters without addresses and topics match every log and are kept aside.
+/// Not thread-safe, the owner guards it together with the filters.
+class LogFilterIndex {
+public:
+    void insert( h256 const& _id, LogFilter const& _filter );
+    void erase( h256 const& _id, LogFilter const& _filter );
+
+    /// @returns ids of filters that may match some log of _receipt
+    h256Hash candidates( TransactionReceipt const& _receipt ) const;
+
+private:
+    // calls _fn( map, key ) for every key _filter is indexed under, @returns false if none
+    template < class Fn >
+    bool forEachKey( LogFilter const& _filter, Fn&& _fn );
+
+    std::unordered_map< Address, h256Hash > m_byAddress;
+    std::array< std::unordered_map< h256, h256Hash >, 4 > m_byTopic;
+    h256Hash m_rangeFilters;
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -42,6 +42,7 @@ using namespace std;
 #include <libdevcore/RLP.h>
 #include <libethcore/CommonJS.h>
 
+#include <libethereum/BlockImportTimeline.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/Client.h>
 #include <libethereum/CommonNet.h>
@@ -66,6 +67,8 @@ using namespace dev::eth;
 #endif
 
 const int SkaleHost::REJECT_OLD_TRANSACTION_THROUGH_BROADCAST_INTERVAL_SEC = 600;
+const size_t SkaleHost::BROADCAST_BATCH_MAX_SIZE = 256;
+const std::chrono::microseconds SkaleHost::BROADCAST_BATCH_MAX_DELAY{ 2000 };
 
 std::unique_ptr< ConsensusInterface > DefaultConsensusFactory::create(
     ConsensusExtFace& _extFace ) const {
@@ -369,6 +372,52 @@ h256 SkaleHost::receiveTransaction( std::string _rlp ) {
     return sha;
 }
 
+size_t SkaleHost::receiveTransactions( std::string const& _rlpList ) {
+    // drop incoming transactions if skaled has an outdated state
+    if ( m_client.bc().info().timestamp() + REJECT_OLD_TRANSACTION_THROUGH_BROADCAST_INTERVAL_SEC <
+         std::time( NULL ) ) {
+        LOG( m_debugLogger ) << "Dropped the transactions received through broadcast";
+        return 0;
+    }
+
+    bytes const data = jsToBytes( _rlpList, OnFailed::Throw );
+    RLP const list( data );
+    if ( list.itemCount() > BROADCAST_BATCH_MAX_SIZE )
+        BOOST_THROW_EXCEPTION( ValueTooLarge() << errinfo_comment(
+                                   "Too many transactions in batch: " +
+                                   std::to_string( list.itemCount() ) ) );
+
+    // a malformed transaction does not spoil the rest of the batch
+    Transactions transactions;
+    transactions.reserve( list.itemCount() );
+    size_t malformed = 0;
+    for ( RLP const& item : list ) {
+        try {
+            transactions.emplace_back( item.toBytesConstRef(), CheckTransaction::None, false,
+                EIP1559TransactionsPatch::isEnabledInWorkingBlock() );
+        } catch ( std::exception const& ex ) {
+            ++malformed;
+            LOG( m_debugLogger ) << "Skipped malformed transaction of broadcast batch: "
+                                 << ex.what();
+        }
+    }
+
+    m_debugTracer.tracepoint( "receive_transactions" );
+    {
+        std::lock_guard< std::mutex > localGuard( m_receivedMutex );
+        for ( Transaction const& t : transactions )
+            m_received.insert( t.sha3() );
+        LOG( m_debugLogger ) << "m_received = " << m_received.size() << std::endl;
+    }
+
+    size_t const imported = m_client.importTransactions( transactions );
+
+    m_debugTracer.tracepoint( "receive_transactions_success" );
+    LOG( m_debugLogger ) << "Received through broadcast " << imported << " of "
+                         << list.itemCount() << " transactions, " << malformed << " malformed";
+    return imported;
+}
+
 // keeps mutex unlocked when exists
 template < class M >
 class unlock_guard {
@@ -589,6 +638,7 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
 
     LOG( m_debugLogger ) << "createBlock ID = #" << _blockID;
     m_debugTracer.tracepoint( "create_block" );
+    BlockImportTimeline::ScopedBlock timelineBlock( _blockID );
 
     // convert bytes back to transactions (using caching), delete them from q and push results into
     // blockchain
@@ -638,6 +688,8 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
         skutils::task::performance::json jarrProcessedTxns =
             skutils::task::performance::json::array();
 
+        // decoding of consensus-born transactions includes recovery of senders
+        auto const decodeStart = BlockImportTimeline::Sample::now();
         for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
             const bytes& data = *it;
             h256 sha = sha3( data );
@@ -681,13 +733,15 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
                 haveConsensusBorn = true;
             }
 
-            if ( m_tq.knownTransactions().count( sha ) != 0 ) {
+            if ( m_tq.isKnown( sha ) ) {
                 LOG( m_traceLogger )
                     << "Consensus returned future transaction that we didn't yet send";
                 m_debugTracer.tracepoint( "import_future" );
             }
 
         }  // for
+        BlockImportTimeline::instance().addStage(
+            "decode", "block", std::string(), decodeStart, BlockImportTimeline::Sample::now() );
         // TODO Monitor somehow m_transaction_cache and delete long-lasting elements?
 
         total_arrived += out_txns.size();
@@ -876,55 +930,66 @@ void SkaleHost::broadcastFunc() {
         try {
             m_broadcaster->broadcast( "" );  // HACK this is just to initialize sockets
 
-            dev::eth::Transactions txns = m_tq.topTransactionsSync( 1, 0, 1 );
+            dev::eth::Transactions txns =
+                m_tq.topTransactionsSync( BROADCAST_BATCH_MAX_SIZE, 0, 1 );
             if ( txns.empty() )  // means timeout
                 continue;
 
+            // let the batch fill up a little, one message per peer is much cheaper than many
+            auto const deadline = std::chrono::steady_clock::now() + BROADCAST_BATCH_MAX_DELAY;
+            while ( txns.size() < BROADCAST_BATCH_MAX_SIZE && !m_exitNeeded &&
+                    std::chrono::steady_clock::now() < deadline ) {
+                std::this_thread::sleep_for( BROADCAST_BATCH_MAX_DELAY / 8 );
+                dev::eth::Transactions more =
+                    m_tq.topTransactions( BROADCAST_BATCH_MAX_SIZE - txns.size(), 0, 1 );
+                txns.insert( txns.end(), more.begin(), more.end() );
+            }
+
             this->logState();
 
             MICROPROFILE_SCOPEI( "SkaleHost", "broadcastFunc", MP_BISQUE );
 
-            assert( txns.size() == 1 );
-            Transaction& txn = txns[0];
-            h256 sha = txn.sha3();
-
             // TODO XXX such blocks are bad :(
-            size_t received;
+            // transactions received through broadcast are not sent back
+            dev::eth::Transactions own;
             {
                 std::lock_guard< std::mutex > lock( m_receivedMutex );
-                received = m_received.count( sha );
+                for ( Transaction const& txn : txns )
+                    if ( m_received.count( txn.sha3() ) == 0 )
+                        own.push_back( txn );
             }
+            if ( own.size() < txns.size() )
+                m_debugTracer.tracepoint( "broadcast_already_have" );
 
-            if ( received == 0 ) {
+            if ( !own.empty() ) {
                 try {
                     if ( !m_broadcastPauseFlag ) {
                         MICROPROFILE_SCOPEI(
                             "SkaleHost", "broadcastFunc.broadcast", MP_CHARTREUSE1 );
-                        std::string rlp = toJS( txn.toBytes() );
-                        std::string h = toJS( txn.sha3() );
+                        RLPStream rlpList( own.size() );
+                        for ( Transaction const& txn : own )
+                            rlpList.append( txn.toBytes() );
                         //
                         std::string strPerformanceQueueName = "bc/broadcast";
                         std::string strPerformanceActionName =
                             skutils::tools::format( "broadcast %zu", nBroadcastTaskNumber++ );
                         skutils::task::performance::json jsn =
                             skutils::task::performance::json::object();
-                        jsn["hash"] = h;
+                        jsn["hash"] = toJS( own.front().sha3() );
+                        jsn["count"] = own.size();
                         skutils::task::performance::action a(
                             strPerformanceQueueName, strPerformanceActionName, jsn );
                         //
                         m_debugTracer.tracepoint( "broadcast" );
-                        m_broadcaster->broadcast( rlp );
+                        m_broadcaster->broadcastBatch( toJS( rlpList.out() ) );
                     }
                 } catch ( const std::exception& ex ) {
                     cwarn << "BROADCAST EXCEPTION CAUGHT";
                     cwarn << ex.what();
                 }  // catch
+            }      // if
 
-            }  // if
-            else
-                m_debugTracer.tracepoint( "broadcast_already_have" );
-
-            ++m_bcast_counter;
+            m_bcast_counter += int( txns.size() );
 
             logState();
         } catch ( const std::exception& ex ) {
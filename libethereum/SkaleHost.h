@@ -120,7 +120,14 @@ public:
     void noteNewBlocks();
     void onBlockImported( dev::eth::BlockHeader const& _info );
 
+    // broadcast batch is sent when it has this many transactions, larger ones are not received
+    static const size_t BROADCAST_BATCH_MAX_SIZE;
+
     dev::h256 receiveTransaction( std::string );
+    /// Imports hex-encoded RLP list of transactions sent by broadcastFunc of another node,
+    /// invalid transactions are skipped, lists longer than BROADCAST_BATCH_MAX_SIZE are rejected
+    /// @returns count of imported transactions
+    size_t receiveTransactions( std::string const& _rlpList );
 
     dev::u256 getGasPrice( unsigned _blockNumber = dev::eth::LatestBlock ) const;
     dev::u256 getBlockRandom() const;
@@ -233,4 +240,6 @@ private:
     // reject old transactions that come through broadcast
     // if current ts is much bigger than currentBlock.ts
     static const int REJECT_OLD_TRANSACTION_THROUGH_BROADCAST_INTERVAL_SEC;
+    // not full broadcast batch is sent when its first transaction has waited this long
+    static const std::chrono::microseconds BROADCAST_BATCH_MAX_DELAY;
 };
@@ -28,6 +28,7 @@
 #include <libethcore/Exceptions.h>
 #include <libethereum/SchainPatch.h>
 
+#include <algorithm>
 #include <list>
 #include <thread>
 #include <vector>
@@ -142,6 +143,7 @@ ImportResult TransactionQueue::import(
                 fs->second.erase( t->second.transaction.nonce() );
                 if ( fs->second.empty() )
                     m_future.erase( fs );
+                publishNonces_WITH_LOCK( _transaction.from() );
             }  // if found
         }      // if fs->second
 
@@ -192,12 +194,13 @@ Transactions TransactionQueue::topTransactions_WITH_LOCK(
     PriorityQueue::iterator my_begin = m_current.lower_bound( dummy );
 
     for ( PriorityQueue::iterator transaction_ptr = my_begin;
-          top_transactions.size() < _limit && transaction_ptr != m_current.end();
-          ++transaction_ptr ) {
+          top_transactions.size() < _limit && transaction_ptr != m_current.end(); ) {
         top_transactions.push_back( transaction_ptr->transaction );
-        if ( _setCategory >= 0 ) {
-            found.push_back( m_current.extract( transaction_ptr ) );
-        }
+        // step before extracting, extracted node is not linked into the set anymore
+        if ( _setCategory >= 0 )
+            found.push_back( m_current.extract( transaction_ptr++ ) );
+        else
+            ++transaction_ptr;
     }
 
     // set all at once
@@ -209,15 +212,12 @@ Transactions TransactionQueue::topTransactions_WITH_LOCK(
     }
 
     // HACK For IS-348
-    auto saved_txns = top_transactions;
-    std::stable_sort( top_transactions.begin(), top_transactions.end(),
-        TransactionQueue::PriorityCompare{ *this } );
-    bool found_difference = false;
-    for ( size_t i = 0; i < top_transactions.size(); ++i ) {
-        if ( top_transactions[i].sha3() != saved_txns[i].sha3() )
-            found_difference = true;
-    }
-    if ( found_difference ) {
+    // the set is kept ordered when min nonces of senders change, so this is only a safety net
+    // and sorts nothing unless the order is broken
+    TransactionQueue::PriorityCompare const compare{ *this };
+    if ( !std::is_sorted( top_transactions.begin(), top_transactions.end(), compare ) ) {
+        auto saved_txns = top_transactions;
+        std::stable_sort( top_transactions.begin(), top_transactions.end(), compare );
         clog( VerbosityError, "skale-host" ) << "IS-348 bug detected. Wrong transaction order in "
                                                 "block proposal was fixed by workaround :(";
         clog( VerbosityTrace, "skale-host" ) << "<i> <old> <new>";
@@ -230,6 +230,11 @@ Transactions TransactionQueue::topTransactions_WITH_LOCK(
     return top_transactions;
 }
 
+bool TransactionQueue::isKnown( h256 const& _txHash ) const {
+    ReadGuard l( m_lock );
+    return m_known.count( _txHash ) != 0;
+}
+
 const h256Hash TransactionQueue::knownTransactions() const {
     h256Hash rv;
     {  // block
@@ -283,13 +288,41 @@ ImportResult TransactionQueue::manageImport_WITH_LOCK(
 }
 
 u256 TransactionQueue::maxNonce( Address const& _a ) const {
-    ReadGuard l( m_lock );
-    return maxNonce_WITH_LOCK( _a );
+    return m_senderNonces.get( _a ).second;
 }
 
 u256 TransactionQueue::maxCurrentNonce( Address const& _a ) const {
-    ReadGuard l( m_lock );
-    return maxCurrentNonce_WITH_LOCK( _a );
+    return m_senderNonces.get( _a ).first;
+}
+
+std::pair< u256, u256 > TransactionQueue::SenderNonces::get( Address const& _a ) const {
+    Shard& s = shard( _a );
+    Guard l( s.mutex );
+    auto it = s.nonces.find( _a );
+    if ( it == s.nonces.end() )
+        return {};
+    return it->second;
+}
+
+void TransactionQueue::SenderNonces::set(
+    Address const& _a, u256 const& _current, u256 const& _all ) {
+    Shard& s = shard( _a );
+    Guard l( s.mutex );
+    if ( _all == 0 )
+        s.nonces.erase( _a );
+    else
+        s.nonces[_a] = { _current, _all };
+}
+
+void TransactionQueue::SenderNonces::clear() {
+    for ( Shard& s : m_shards ) {
+        Guard l( s.mutex );
+        s.nonces.clear();
+    }
+}
+
+void TransactionQueue::publishNonces_WITH_LOCK( Address const& _a ) {
+    m_senderNonces.set( _a, maxCurrentNonce_WITH_LOCK( _a ), maxNonce_WITH_LOCK( _a ) );
 }
 
 u256 TransactionQueue::maxNonce_WITH_LOCK( Address const& _a ) const {
@@ -319,19 +352,50 @@ void TransactionQueue::insertCurrent_WITH_LOCK( std::pair< h256, Transaction > c
 
     Transaction const& t = _p.second;
     // Insert into current
-    auto inserted = m_currentByAddressAndNonce[t.from()].insert(
-        std::make_pair( t.nonce(), PriorityQueue::iterator() ) );
-    PriorityQueue::iterator handle = m_current.emplace( VerifiedTransaction( t ) );
+    PriorityQueue::iterator handle = emplaceCurrent_WITH_LOCK( VerifiedTransaction( t ) );
+    m_currentSizeBytes += ( *handle ).transaction.toBytes().size();
+
+    // Move following transactions from future to current
+    makeCurrent_WITH_LOCK( t );
+    m_known.insert( _p.first );
+    publishNonces_WITH_LOCK( t.from() );
+}
+
+TransactionQueue::PriorityQueue::iterator TransactionQueue::emplaceCurrent_WITH_LOCK(
+    VerifiedTransaction&& _t ) {
+    Address const from = _t.transaction.from();
+    h256 const hash = _t.transaction.sha3();
+    NonceQueue& queue = m_currentByAddressAndNonce[from];
+    auto inserted =
+        queue.insert( std::make_pair( _t.transaction.nonce(), PriorityQueue::iterator() ) );
+    // new lowest nonce changes heights of all other transactions of the account
+    if ( inserted.first == queue.begin() && queue.size() > 1 )
+        reorderSender_WITH_LOCK( queue, std::next( inserted.first ) );
+    PriorityQueue::iterator handle = m_current.emplace( std::move( _t ) );
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-copy"
     inserted.first->second = handle;
-    m_currentByHash[_p.first] = handle;
+    m_currentByHash[hash] = handle;
 #pragma GCC diagnostic pop
-    m_currentSizeBytes += t.toBytes().size();
+    return handle;
+}
 
-    // Move following transactions from future to current
-    makeCurrent_WITH_LOCK( t );
-    m_known.insert( _p.first );
+void TransactionQueue::reorderSender_WITH_LOCK( NonceQueue& _queue, NonceQueue::iterator _from ) {
+    MICROPROFILE_SCOPEI( "TransactionQueue", "reorderSender_WITH_LOCK", MP_DEEPSKYBLUE );
+    // all nodes go out first, positions of the rest of the set are valid then
+    std::vector< PriorityQueue::node_type > nodes;
+    for ( auto it = _from; it != _queue.end(); ++it )
+        nodes.push_back( m_current.extract( it->second ) );
+    auto it = _from;
+    for ( PriorityQueue::node_type& node : nodes ) {
+        PriorityQueue::iterator handle = m_current.insert( std::move( node ) );
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-copy"
+        it->second = handle;
+        m_currentByHash[( *handle ).transaction.sha3()] = handle;
+#pragma GCC diagnostic pop
+        ++it;
+    }
 }
 
 bool TransactionQueue::remove_WITH_LOCK( h256 const& _txHash ) {
@@ -344,13 +408,18 @@ bool TransactionQueue::remove_WITH_LOCK( h256 const& _txHash ) {
     Address from = ( *t->second ).transaction.from();
     auto it = m_currentByAddressAndNonce.find( from );
     assert( it != m_currentByAddressAndNonce.end() );
-    it->second.erase( ( *t->second ).transaction.nonce() );
+    u256 const nonce = ( *t->second ).transaction.nonce();
+    bool const wasLowest = it->second.begin()->first == nonce;
+    it->second.erase( nonce );
     m_currentSizeBytes -= ( *t->second ).transaction.toBytes().size();
     m_current.erase( t->second );
     m_currentByHash.erase( t );
     if ( it->second.empty() )
         m_currentByAddressAndNonce.erase( it );
+    else if ( wasLowest )
+        reorderSender_WITH_LOCK( it->second, it->second.begin() );
     m_known.erase( _txHash );
+    publishNonces_WITH_LOCK( from );
     return true;
 }
 
@@ -391,6 +460,7 @@ void TransactionQueue::setFuture_WITH_LOCK( h256 const& _txHash ) {
     queue.erase( cutoff, queue.end() );
     if ( queue.empty() )
         m_currentByAddressAndNonce.erase( from );
+    publishNonces_WITH_LOCK( from );
 
     while ( m_futureSize > m_futureLimit || m_futureSizeBytes > m_futureSizeBytesLimit ) {
         // TODO: priority queue for future transactions
@@ -400,9 +470,11 @@ void TransactionQueue::setFuture_WITH_LOCK( h256 const& _txHash ) {
         auto erasedHash = m_future.begin()->second.rbegin()->second.transaction.sha3();
         LOG( m_loggerDetail ) << "Dropping out of bounds future transaction " << erasedHash;
         m_known.erase( erasedHash );
+        Address const erasedFrom = m_future.begin()->first;
         m_future.begin()->second.erase( --m_future.begin()->second.end() );
         if ( m_future.begin()->second.empty() )
             m_future.erase( m_future.begin() );
+        publishNonces_WITH_LOCK( erasedFrom );
     }
 }
 
@@ -422,14 +494,7 @@ void TransactionQueue::makeCurrent_WITH_LOCK( Transaction const& _t ) {
         if ( fb != fs->second.end() ) {
             auto ft = fb;
             while ( ft != fs->second.end() && ft->second.transaction.nonce() == nonce ) {
-                auto inserted = m_currentByAddressAndNonce[_t.from()].insert(
-                    std::make_pair( ft->second.transaction.nonce(), PriorityQueue::iterator() ) );
-                PriorityQueue::iterator handle = m_current.emplace( move( ft->second ) );
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-copy"
-                inserted.first->second = handle;
-                m_currentByHash[( *handle ).transaction.sha3()] = handle;
-#pragma GCC diagnostic pop
+                PriorityQueue::iterator handle = emplaceCurrent_WITH_LOCK( move( ft->second ) );
                 m_futureSizeBytes -= ( *handle ).transaction.toBytes().size();
                 m_currentSizeBytes += ( *handle ).transaction.toBytes().size();
                 --m_futureSize;
@@ -443,8 +508,10 @@ void TransactionQueue::makeCurrent_WITH_LOCK( Transaction const& _t ) {
         }
     }
 
-    if ( newCurrent )
+    if ( newCurrent ) {
+        publishNonces_WITH_LOCK( _t.from() );
         m_onReady();
+    }
 }
 
 void TransactionQueue::drop( h256 const& _txHash ) {
@@ -484,6 +551,7 @@ void TransactionQueue::clear() {
     m_future.clear();
     m_futureSize = 0;
     m_futureSizeBytes = 0;
+    m_senderNonces.clear();
 }
 
 void TransactionQueue::enqueue( RLP const& _data, h512 const& _nodeId ) {
@@ -34,6 +34,7 @@
 #include <libdevcore/Log.h>
 #include <libdevcore/LruCache.h>
 #include <libethcore/Common.h>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
@@ -129,11 +130,14 @@ public:
     /// @returns A hash set of all transactions in the queue
     const h256Hash knownTransactions() const;
 
-    /// Get max nonce for an account
+    /// @returns true if transaction is in current or future queue, does not copy the known set
+    bool isKnown( h256 const& _txHash ) const;
+
+    /// Get max nonce for an account. Does not take the queue lock.
     /// @returns Max transaction nonce for account in the queue
     u256 maxNonce( Address const& _a ) const;
 
-    /// Get max nonce from current queue for an account
+    /// Get max nonce from current queue for an account. Does not take the queue lock.
     /// @returns Max transaction nonce for account in the queue
     u256 maxCurrentNonce( Address const& _a ) const;
 
@@ -283,8 +287,30 @@ public:
 
 private:
     // Use a set with dynamic comparator for minmax priority queue. The comparator takes into
-    // account min account nonce. Updating it does not affect the order.
+    // account min account nonce. When it changes, transactions of the account are re-inserted
+    // to keep the set ordered.
     using PriorityQueue = boost::container::multiset< VerifiedTransaction, PriorityCompare >;
+    using NonceQueue = std::map< u256, PriorityQueue::iterator >;
+
+    /// Max nonces of queued transactions by account, sharded by address so that readers
+    /// (e.g. nonce of a new transaction for eth_sendTransaction) do not wait for m_lock.
+    /// Written under m_lock after every change of the account's transactions.
+    class SenderNonces {
+    public:
+        /// @returns max nonce + 1 of current and of all transactions, zeros if none
+        std::pair< u256, u256 > get( Address const& _a ) const;
+        void set( Address const& _a, u256 const& _current, u256 const& _all );
+        void clear();
+
+    private:
+        struct Shard {
+            mutable Mutex mutex;
+            std::unordered_map< Address, std::pair< u256, u256 > > nonces;
+        };
+        Shard& shard( Address const& _a ) const { return m_shards[_a[0] % m_shards.size()]; }
+
+        mutable std::array< Shard, 64 > m_shards;
+    };
 
     ImportResult import(
         bytesConstRef _tx, IfDropped _ik = IfDropped::Ignore, bool _isFuture = false );
@@ -299,6 +325,9 @@ private:
         unsigned _limit, int _maxCategory = 0, int _setCategory = -1 );
 
     void insertCurrent_WITH_LOCK( std::pair< h256, Transaction > const& _p );
+    PriorityQueue::iterator emplaceCurrent_WITH_LOCK( VerifiedTransaction&& _t );
+    void reorderSender_WITH_LOCK( NonceQueue& _queue, NonceQueue::iterator _from );
+    void publishNonces_WITH_LOCK( Address const& _a );
     void makeCurrent_WITH_LOCK( Transaction const& _t );
     bool remove_WITH_LOCK( h256 const& _txHash );
     u256 maxNonce_WITH_LOCK( Address const& _a ) const;
@@ -320,10 +349,11 @@ private:
     std::unordered_map< h256, PriorityQueue::iterator > m_currentByHash;  ///< Transaction hash to
                                                                           ///< set ref
 
-    std::unordered_map< Address, std::map< u256, PriorityQueue::iterator > >
+    std::unordered_map< Address, NonceQueue >
         m_currentByAddressAndNonce;  ///< Transactions grouped by account and nonce
     std::unordered_map< Address, std::map< u256, VerifiedTransaction > > m_future;  /// Future
                                                                                     /// transactions
+    SenderNonces m_senderNonces;
 
     Signal<> m_onReady;  ///< Called when a subsequent call to import transactions will return a
                          ///< non-empty container. Be nice and exit fast.
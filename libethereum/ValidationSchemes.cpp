@@ -157,6 +157,7 @@ void validateConfigJson( js::mObject const& _obj ) {
             { "infoWssRpcPort", { { js::int_type }, JsonFieldPresence::Optional } },
             { "infoWssRpcPort6", { { js::int_type }, JsonFieldPresence::Optional } },
             { "imaMonitoringPort", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "metricsPort", { { js::int_type }, JsonFieldPresence::Optional } },
             { "emptyBlockIntervalMs", { { js::int_type }, JsonFieldPresence::Optional } },
             { "emptyBlockIntervalAfterCatchupMs",
                 { { js::int_type }, JsonFieldPresence::Optional } },
@@ -207,6 +208,8 @@ void validateConfigJson( js::mObject const& _obj ) {
             { "unsafe-transactions", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "max-connections", { { js::int_type }, JsonFieldPresence::Optional } },
             { "max-http-queues", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "batch-parallelism", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "rpc-executor", { { js::obj_type }, JsonFieldPresence::Optional } },
             { "ws-mode", { { js::str_type }, JsonFieldPresence::Optional } },
             { "ws-log", { { js::str_type }, JsonFieldPresence::Optional } },
             { "log-value-size-limit", { { js::int_type }, JsonFieldPresence::Optional } },
@@ -223,6 +226,13 @@ void validateConfigJson( js::mObject const& _obj ) {
             { "archiveMode", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "syncFromCatchup", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "testSignatures", { { js::bool_type }, JsonFieldPresence::Optional } },
+            { "historicStateRetainBlocks", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "historicStateCheckpointInterval",
+                { { js::int_type }, JsonFieldPresence::Optional } },
+            { "traceOnImport", { { js::array_type }, JsonFieldPresence::Optional } },
+            { "blocksDbCodecs", { { js::obj_type }, JsonFieldPresence::Optional } },
+            { "blocksDbZstdLevel", { { js::int_type }, JsonFieldPresence::Optional } },
+            { "archiveColdTier", { { js::bool_type }, JsonFieldPresence::Optional } },
             { "wallets", { { js::obj_type }, JsonFieldPresence::Optional } } } );
 
     std::string keyShareName = "";
@@ -55,6 +55,7 @@ void AlethStandardTrace::analyzeInstructionAndRecordNeededInformation( uint64_t,
         // the stackSize() check prevents malicios code crashing the tracer
         // by issuing SLOAD with nothing on the stack
         if ( _vm->stackSize() > 0 ) {
+            recordOriginalStorageValue( _ext, _vm->getStackElement( 0 ) );
             m_accessedStorageValues[_ext.myAddress][_vm->getStackElement( 0 )] =
                 _ext.store( _vm->getStackElement( 0 ) );
         }
@@ -62,6 +63,7 @@ void AlethStandardTrace::analyzeInstructionAndRecordNeededInformation( uint64_t,
     case Instruction::SSTORE:
         // STORAGE - record storage access
         if ( _vm->stackSize() > 1 ) {
+            recordOriginalStorageValue( _ext, _vm->getStackElement( 0 ) );
             m_accessedStorageValues[_ext.myAddress][_vm->getStackElement( 0 )] =
                 _vm->getStackElement( 1 );
         }
@@ -239,6 +241,12 @@ Json::Value AlethStandardTrace::getJSONResult() const {
     return m_jsonTrace;
 }
 
+const bytes& AlethStandardTrace::getRLPResult() const {
+    STATE_CHECK( m_isFinalized )
+    STATE_CHECK( m_options.outputFormat == TraceOutputFormat::RLP )
+    return m_rlpTrace;
+}
+
 uint64_t AlethStandardTrace::getTotalGasUsed() const {
     STATE_CHECK( m_isFinalized )
     return m_totalGasUsed;
@@ -436,6 +444,14 @@ bool AlethStandardTrace::isFailed() const {
 
 void eth::AlethStandardTrace::printTrace( ExecutionResult& _er, const HistoricState& _statePre,
     const HistoricState& _statePost ) {  // now print the trace
+    if ( m_options.outputFormat == TraceOutputFormat::RLP ) {
+        // encode directly from the collected records, no json is built in this case
+        RLPStream rlpTrace;
+        m_tracePrinters.at( m_options.tracerType ).printRLP( rlpTrace, _er, _statePre, _statePost );
+        rlpTrace.swapOut( m_rlpTrace );
+        return;
+    }
+
     m_jsonTrace = Json::Value( Json::objectValue );
     // now run the trace that the user wants based on options provided
     if ( m_tracePrinters.count( m_options.tracerType ) > 0 ) {
@@ -473,6 +489,24 @@ const set< Address >& AlethStandardTrace::getAccessedAccounts() const {
     return m_accessedAccounts;
 }
 
+std::optional< u256 > AlethStandardTrace::getOriginalStorageValue(
+    const Address& _address, const u256& _key ) const {
+    STATE_CHECK( m_isFinalized )
+    auto it = m_originalStorageValues.find( StorageSlot{ _address, h256( _key ) } );
+    if ( it == m_originalStorageValues.end() )
+        return std::nullopt;
+    return it->second;
+}
+
+// the first time a slot is accessed, record its value before the transaction.
+// The read goes to the executing state and warms the slot for the SLOAD or SSTORE
+// that follows, so printers do not need to read the pre-transaction state again
+void AlethStandardTrace::recordOriginalStorageValue( AlethExtVM& _ext, const u256& _key ) {
+    StorageSlot slot{ _ext.myAddress, h256( _key ) };
+    if ( m_originalStorageValues.count( slot ) == 0 )
+        m_originalStorageValues.emplace( slot, _ext.originalStorageValue( _key ) );
+}
+
 const map< Address, map< u256, u256 > >& AlethStandardTrace::getAccessedStorageValues() const {
     STATE_CHECK( m_isFinalized )
     return m_accessedStorageValues;
@@ -35,6 +35,8 @@ along with skaled.  If not, see <http://www.gnu.org/licenses/>.
 #include "libevm/VMFace.h"
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 namespace Json {
 class Value;
@@ -47,6 +49,22 @@ namespace dev::eth {
 
 class FunctionCallRecord;
 
+// a storage slot of a contract
+struct StorageSlot {
+    Address m_address;
+    h256 m_key;
+
+    bool operator==( const StorageSlot& _other ) const {
+        return m_address == _other.m_address && m_key == _other.m_key;
+    }
+};
+
+struct StorageSlotHash {
+    size_t operator()( const StorageSlot& _slot ) const {
+        return std::hash< Address >()( _slot.m_address ) ^ std::hash< h256 >()( _slot.m_key );
+    }
+};
+
 // This class collects information during EVM execution.  The oollected information
 // is then used by trace printers to print the trace requested by the user
 
@@ -77,6 +95,9 @@ public:
 
     [[nodiscard]] Json::Value getJSONResult() const;
 
+    // the trace encoded by the printer when TraceOutputFormat::RLP was requested
+    [[nodiscard]] const bytes& getRLPResult() const;
+
     [[nodiscard]] const std::shared_ptr< FunctionCallRecord >& getTopFunctionCall() const;
 
     [[nodiscard]] TraceOptions getOptions() const;
@@ -86,6 +107,10 @@ public:
 
     [[nodiscard]] const std::set< Address >& getAccessedAccounts() const;
 
+    // value the storage slot had before the transaction, if the slot was accessed
+    [[nodiscard]] std::optional< u256 > getOriginalStorageValue(
+        const Address& _address, const u256& _key ) const;
+
     [[nodiscard]] const h256& getTxHash() const;
 
     [[nodiscard]] const shared_ptr< vector< shared_ptr< OpExecutionRecord > > >&
@@ -176,6 +201,8 @@ private:
 
     void recordMinerPayment( u256 _minerGasPayment );
 
+    void recordOriginalStorageValue( AlethExtVM& _ext, const u256& _key );
+
     void printTrace(
         ExecutionResult& _er, const HistoricState& _statePre, const HistoricState& _statePost );
 
@@ -194,11 +221,14 @@ private:
     TraceOptions m_options;
     h256 m_txHash;
     Json::Value m_jsonTrace;
+    bytes m_rlpTrace;
     // set of all storage values accessed during execution
     std::set< Address > m_accessedAccounts;
     // std::map of all storage addresses accessed (read or write) during execution
     // for each storage address the current value if recorded
     std::map< Address, std::map< dev::u256, dev::u256 > > m_accessedStorageValues;
+    // values of accessed storage slots before the transaction, recorded on first access
+    std::unordered_map< StorageSlot, u256, StorageSlotHash > m_originalStorageValues;
 
     std::shared_ptr< std::vector< std::shared_ptr< OpExecutionRecord > > >
         m_executionRecordSequence = nullptr;
@@ -0,0 +1,139 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BlockTraceStore.h"
+
+#include <libdevcore/Log.h>
+
+#include <snappy.h>
+
+using namespace std;
+
+namespace dev::eth {
+
+const size_t BlockTraceStore::c_pieces = 4;
+const uint64_t BlockTraceStore::c_rotationPeriodBlocks = 100000;
+const size_t BlockTraceStore::c_maxQueueSize = 10000;
+
+BlockTraceStore::BlockTraceStore( boost::filesystem::path const& _path,
+    std::vector< Json::Value > const& _importTraceConfigs, TraceFunction _traceFunction )
+    : m_rotatingIO( make_shared< batched_io::rotating_db_io >( _path, c_pieces, false ) ),
+      m_db( new db::ManuallyRotatingLevelDB( m_rotatingIO ) ),
+      m_importTraceConfigs( _importTraceConfigs ),
+      m_traceFunction( std::move( _traceFunction ) ) {
+    if ( !m_importTraceConfigs.empty() )
+        m_thread = std::thread( [this]() { traceQueuedBlocks(); } );
+}
+
+BlockTraceStore::~BlockTraceStore() {
+    stop();
+}
+
+std::string BlockTraceStore::makeKey( uint64_t _blockNumber, std::string const& _optionsKey ) {
+    return to_string( _blockNumber ) + ":" + _optionsKey;
+}
+
+std::optional< Json::Value > BlockTraceStore::get(
+    uint64_t _blockNumber, std::string const& _optionsKey ) const {
+    std::string const key = makeKey( _blockNumber, _optionsKey );
+    std::string const compressed = m_db->lookup( db::Slice( key ) );
+    if ( compressed.empty() )
+        return std::nullopt;
+
+    std::string serialized;
+    if ( !snappy::Uncompress( compressed.data(), compressed.size(), &serialized ) ) {
+        cwarn << "Corrupted trace of block " << _blockNumber << " in block trace store";
+        return std::nullopt;
+    }
+
+    Json::Value traces;
+    if ( !Json::Reader().parse( serialized, traces ) )
+        return std::nullopt;
+    return traces;
+}
+
+void BlockTraceStore::put(
+    uint64_t _blockNumber, std::string const& _optionsKey, Json::Value const& _traces ) {
+    std::string const serialized = Json::FastWriter().write( _traces );
+    std::string compressed;
+    snappy::Compress( serialized.data(), serialized.size(), &compressed );
+    std::string const key = makeKey( _blockNumber, _optionsKey );
+    m_db->insert( db::Slice( key ), db::Slice( compressed ) );
+}
+
+void BlockTraceStore::onBlockImported( uint64_t _blockNumber ) {
+    // pieces hold c_rotationPeriodBlocks blocks each, oldest traces are dropped on rotation
+    if ( _blockNumber > 0 && _blockNumber % c_rotationPeriodBlocks == 0 )
+        m_db->rotate();
+
+    if ( m_importTraceConfigs.empty() || _blockNumber == 0 )
+        return;
+
+    {
+        std::lock_guard< std::mutex > lock( m_queueMutex );
+        if ( m_queue.size() >= c_maxQueueSize ) {
+            // tracing cannot keep up with import, oldest blocks will be traced on demand
+            cwarn << "Block trace queue is full, dropping block " << m_queue.front();
+            m_queue.pop_front();
+        }
+        m_queue.push_back( _blockNumber );
+    }
+    m_queueCondition.notify_one();
+}
+
+void BlockTraceStore::stop() {
+    {
+        std::lock_guard< std::mutex > lock( m_queueMutex );
+        m_stop = true;
+    }
+    m_queueCondition.notify_all();
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+size_t BlockTraceStore::queueSize() const {
+    std::lock_guard< std::mutex > lock( m_queueMutex );
+    return m_queue.size();
+}
+
+void BlockTraceStore::traceQueuedBlocks() {
+    while ( true ) {
+        uint64_t blockNumber;
+        {
+            std::unique_lock< std::mutex > lock( m_queueMutex );
+            m_queueCondition.wait( lock, [this]() { return m_stop || !m_queue.empty(); } );
+            if ( m_stop )
+                return;
+            blockNumber = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        for ( auto const& traceConfig : m_importTraceConfigs ) {
+            if ( m_stop )
+                return;
+            try {
+                m_traceFunction( blockNumber, traceConfig );
+            } catch ( std::exception const& ex ) {
+                cwarn << "Could not trace imported block " << blockNumber << ": " << ex.what();
+            }
+        }
+    }
+}
+
+}  // namespace dev::eth
@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libdevcore/ManuallyRotatingLevelDB.h>
+
+#include <jsonrpccpp/client.h>
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace dev::eth {
+
+constexpr auto BLOCK_TRACES_DIR = "block_traces";
+
+/// Persistent store of block traces.
+/// Traces are kept snappy-compressed in a rotating LevelDB keyed by block number and trace
+/// options. Blocks can be queued for tracing right after import: a background thread then runs
+/// every configured tracer on them, so that later tracing RPCs are served from disk instead
+/// of replaying the block on historic state. Client stores only traces of these tracers, so
+/// pieces rotated by block count stay bounded in size.
+class BlockTraceStore {
+public:
+    /// Traces a block with the given trace config, the same as tracing_traceBlockByNumber.
+    /// Expected to put() the result into the store.
+    using TraceFunction =
+        std::function< Json::Value( uint64_t _blockNumber, Json::Value const& _traceConfig ) >;
+
+    BlockTraceStore( boost::filesystem::path const& _path,
+        std::vector< Json::Value > const& _importTraceConfigs, TraceFunction _traceFunction );
+    ~BlockTraceStore();
+
+    BlockTraceStore( BlockTraceStore const& ) = delete;
+    BlockTraceStore& operator=( BlockTraceStore const& ) = delete;
+
+    /// @returns traces stored for the block and TraceOptions::toString() of the options
+    std::optional< Json::Value > get( uint64_t _blockNumber, std::string const& _optionsKey ) const;
+    void put( uint64_t _blockNumber, std::string const& _optionsKey, Json::Value const& _traces );
+
+    /// Queues the block for tracing with the configured tracers. Called by the import thread.
+    void onBlockImported( uint64_t _blockNumber );
+
+    /// Stops the tracing thread. Queued blocks that are not traced yet are dropped.
+    void stop();
+
+    size_t queueSize() const;
+
+private:
+    void traceQueuedBlocks();
+
+    static std::string makeKey( uint64_t _blockNumber, std::string const& _optionsKey );
+
+    std::shared_ptr< batched_io::rotating_db_io > m_rotatingIO;
+    std::unique_ptr< db::ManuallyRotatingLevelDB > m_db;
+
+    std::vector< Json::Value > m_importTraceConfigs;
+    TraceFunction m_traceFunction;
+
+    std::deque< uint64_t > m_queue;
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::atomic< bool > m_stop = false;
+    std::thread m_thread;
+
+    static const size_t c_pieces;
+    static const uint64_t c_rotationPeriodBlocks;
+    static const size_t c_maxQueueSize;
+};
+
+}  // namespace dev::eth
@@ -68,6 +68,37 @@ void CallTracePrinter::printContractTransactionTrace(
     }
 }
 
+// binary call trace, see FunctionCallRecord::printTraceRLP for the layout of a frame
+void CallTracePrinter::printRLP( RLPStream& _rlpTrace, const ExecutionResult&,
+    const HistoricState&, const HistoricState& _statePost ) {
+    if ( m_trace.isSimpleTransfer() ) {
+        // no bytecode was executed
+        string error;
+        if ( m_trace.isFailed() ) {
+            error = getEvmErrorDescription( m_trace.getEVMCStatusCode() );
+        }
+        _rlpTrace.appendList( 12 );
+        _rlpTrace << ( uint64_t ) Instruction::CALL << m_trace.getFrom() << m_trace.getTo()
+                  << m_trace.getGasLimit() << u256( m_trace.getTotalGasUsed() )
+                  << m_trace.getValue() << m_trace.getInputData() << bytes() << error << string();
+        _rlpTrace.appendList( 0 );
+        _rlpTrace.appendList( 0 );
+        return;
+    }
+
+    auto topFunctionCall = m_trace.getTopFunctionCall();
+    STATE_CHECK( topFunctionCall );
+    // same substitutions for the top call as in printContractTransactionTrace
+    if ( m_trace.isContractCreation() ) {
+        topFunctionCall->printTopTraceRLP( _rlpTrace, _statePost, m_trace.getOptions(),
+            m_trace.getGasLimit(), m_trace.getDeployedContractAddress(),
+            m_trace.getInputData() );
+    } else {
+        topFunctionCall->printTopTraceRLP( _rlpTrace, _statePost, m_trace.getOptions(),
+            m_trace.getGasLimit(), m_trace.getTo(), m_trace.getInputData() );
+    }
+}
+
 CallTracePrinter::CallTracePrinter( AlethStandardTrace& _standardTrace )
     : TracePrinter( _standardTrace, "callTrace" ) {}
 
@@ -37,6 +37,9 @@ public:
     void print( Json::Value& _jsonTrace, const ExecutionResult&, const HistoricState&,
         const HistoricState& ) override;
 
+    void printRLP( RLPStream& _rlpTrace, const ExecutionResult&, const HistoricState&,
+        const HistoricState& _statePost ) override;
+
 private:
     void printTransferTrace( Json::Value& _jsonTrace );
 
@@ -65,6 +65,33 @@ void FourByteTracePrinter::addContractCreationEntry( Json::Value& _jsonTrace ) c
     _jsonTrace[key] = 1;
 }
 
+// binary fourbyte trace: a list of [selector, argument data size, call count] entries
+// built from the same keys as the json trace
+void FourByteTracePrinter::printRLP(
+    RLPStream& _rlpTrace, const ExecutionResult&, const HistoricState&, const HistoricState& ) {
+    std::map< string, uint64_t > callMap;
+
+    auto topFunctionCallRecord = m_trace.getTopFunctionCall();
+    if ( topFunctionCallRecord ) {
+        topFunctionCallRecord->collectFourByteTrace( callMap );
+
+        auto inputBytes = m_trace.getInputData();
+        if ( m_trace.isContractCreation() && inputBytes.size() >= 4 ) {
+            callMap[toHexPrefixed( inputBytes ).substr( 0, 10 ) + "-" +
+                    to_string( inputBytes.size() - 4 )] = 1;
+        }
+    }
+
+    _rlpTrace.appendList( callMap.size() );
+    for ( auto&& entry : callMap ) {
+        // keys are "0x" + 8 hex symbols of the selector + "-" + argument data size
+        STATE_CHECK( entry.first.size() > 11 )
+        _rlpTrace.appendList( 3 ) << fromHex( entry.first.substr( 2, 8 ) )
+                                  << ( uint64_t ) std::stoull( entry.first.substr( 11 ) )
+                                  << entry.second;
+    }
+}
+
 FourByteTracePrinter::FourByteTracePrinter( AlethStandardTrace& standardTrace )
     : TracePrinter( standardTrace, "4byteTrace" ) {}
 
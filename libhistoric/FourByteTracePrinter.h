@@ -37,6 +37,8 @@ public:
 public:
     void print( Json::Value& _jsonTrace, const ExecutionResult&, const HistoricState&,
         const HistoricState& ) override;
+    void printRLP( RLPStream& _rlpTrace, const ExecutionResult&, const HistoricState&,
+        const HistoricState& ) override;
     void addContractCreationEntry( Json::Value& _jsonTrace ) const;
 };
 }  // namespace dev::eth
@@ -213,6 +213,64 @@ void FunctionCallRecord::printTrace( Json::Value& _jsonTrace, const HistoricStat
     }
 }
 
+void FunctionCallRecord::printTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost,
+    int64_t _depth, const TraceOptions& _debugOptions ) {
+    appendTraceRLP( _rlpTrace, _statePost, _depth, _debugOptions, u256( m_functionGasLimit ),
+        m_to, m_inputData );
+}
+
+void FunctionCallRecord::printTopTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost,
+    const TraceOptions& _debugOptions, const u256& _gas, const Address& _to,
+    const bytes& _input ) {
+    appendTraceRLP( _rlpTrace, _statePost, 0, _debugOptions, _gas, _to, _input );
+}
+
+// same information as printTrace, but addresses and byte arrays are written as raw bytes
+// and absent fields are written as empty items, so the layout of a frame is fixed
+void FunctionCallRecord::appendTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost,
+    int64_t _depth, const TraceOptions& _debugOptions, const u256& _gas, const Address& _to,
+    const bytes& _input ) {
+    // prevent Denial of service
+    STATE_CHECK( _depth < MAX_TRACE_DEPTH )
+    STATE_CHECK( _depth == m_depth )
+
+    bool const isCreate = m_type == Instruction::CREATE || m_type == Instruction::CREATE2;
+
+    // output of a constructor is the code of the constructed contract
+    if ( isCreate ) {
+        m_outputData = _statePost.code( m_to );
+    }
+
+    _rlpTrace.appendList( 12 );
+    _rlpTrace << ( uint64_t ) m_type << m_from << _to << _gas << u256( m_gasUsed ) << m_value
+              << _input << m_outputData << m_error << m_revertReason;
+
+    // no logs in contract creation
+    if ( _debugOptions.withLog && !isCreate ) {
+        _rlpTrace.appendList( m_logRecords.size() );
+        for ( auto&& log : m_logRecords ) {
+            _rlpTrace.appendList( 2 ) << log.m_data;
+            _rlpTrace.appendList( log.m_topics.size() );
+            for ( auto&& topic : log.m_topics ) {
+                _rlpTrace << h256( topic );
+            }
+        }
+    } else {
+        _rlpTrace.appendList( 0 );
+    }
+
+    if ( _debugOptions.onlyTopCall ) {
+        _rlpTrace.appendList( 0 );
+        return;
+    }
+
+    _rlpTrace.appendList( m_nestedCalls.size() );
+    for ( auto&& nestedCall : m_nestedCalls ) {
+        STATE_CHECK( nestedCall );
+        nestedCall->printTraceRLP( _rlpTrace, _statePost, _depth + 1, _debugOptions );
+    }
+}
+
 FunctionCallRecord::FunctionCallRecord( Instruction _type, const Address& _from, const Address& _to,
     uint64_t _functionGasLimit, const weak_ptr< FunctionCallRecord >& _parentCall,
     const vector< uint8_t >& _inputData, const u256& _value, int64_t _depth,
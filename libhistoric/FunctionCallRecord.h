@@ -23,6 +23,7 @@ along with skaled.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "AlethExtVM.h"
 #include "libevm/LegacyVM.h"
+#include <libdevcore/RLP.h>
 #include <jsonrpccpp/common/exception.h>
 #include <skutils/eth_utils.h>
 
@@ -73,6 +74,17 @@ public:
     void printFunctionExecutionDetail( Json::Value& _jsonTrace, const HistoricState& _statePost,
         const TraceOptions& _debugOptions );
 
+    // RLP counterpart of printTrace. Each frame is encoded as
+    // [type, from, to, gas, gasUsed, value, input, output, error, revertReason, logs, calls]
+    void printTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost, int64_t _depth,
+        const TraceOptions& _debugOptions );
+
+    // same as printTraceRLP for the top call, where geth prints transaction gas limit,
+    // and for contract creation transaction input and deployed contract address
+    void printTopTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost,
+        const TraceOptions& _debugOptions, const u256& _gas, const Address& _to,
+        const bytes& _input );
+
     void addLogEntry( const vector< uint8_t >& _data, const vector< u256 >& _topics );
 
     void printParityFunctionTrace( Json::Value& _outputArray, Json::Value _address );
@@ -90,6 +102,10 @@ public:
     static uint32_t bytesToUint32( const std::vector< uint8_t >& _bytes, size_t _startIndex );
 
 private:
+    void appendTraceRLP( RLPStream& _rlpTrace, const HistoricState& _statePost, int64_t _depth,
+        const TraceOptions& _debugOptions, const u256& _gas, const Address& _to,
+        const bytes& _input );
+
     Instruction m_type;
     Address m_from;
     Address m_to;
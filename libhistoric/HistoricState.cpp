@@ -45,7 +45,8 @@ HistoricState::HistoricState( HistoricState const& _s )
       m_nonExistingAccountsCache( _s.m_nonExistingAccountsCache ),
       m_unrevertablyTouched( _s.m_unrevertablyTouched ),
       m_accountStartNonce( _s.m_accountStartNonce ),
-      m_totalTimeSpentInStateCommitsPerBlock( _s.m_totalTimeSpentInStateCommitsPerBlock ) {}
+      m_totalTimeSpentInStateCommitsPerBlock( _s.m_totalTimeSpentInStateCommitsPerBlock ),
+      m_compactor( _s.m_compactor ) {}
 
 OverlayDB HistoricState::openDB(
     fs::path const& _basePath, h256 const& _genesisHash, WithExisting _we ) {
@@ -139,6 +140,7 @@ HistoricState& HistoricState::operator=( HistoricState const& _s ) {
     m_unrevertablyTouched = _s.m_unrevertablyTouched;
     m_accountStartNonce = _s.m_accountStartNonce;
     m_totalTimeSpentInStateCommitsPerBlock = _s.m_totalTimeSpentInStateCommitsPerBlock;
+    m_compactor = _s.m_compactor;
     return *this;
 }
 
@@ -198,6 +200,8 @@ void HistoricState::clearCacheIfTooLarge() const {
 void HistoricState::commitExternalChanges( AccountMap const& _accountMap ) {
     auto historicStateStart = dev::db::LevelDB::getCurrentTimeMs();
     commitExternalChangesIntoTrieDB( _accountMap, m_state );
+    if ( m_compactor )
+        m_compactor->noteCommittedNodes( m_db.keys() );
     m_state.db()->commit();
     m_changeLog.clear();
     m_cache.clear();
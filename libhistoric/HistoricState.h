@@ -5,6 +5,7 @@
 #pragma once
 
 #include "HistoricAccount.h"
+#include "HistoricStateCompactor.h"
 #include "SecureTrieDB.h"
 #include <libdevcore/Common.h>
 #include <libdevcore/OverlayDB.h>
@@ -142,6 +143,12 @@ public:
         WithExisting _we = WithExisting::Trust );
     OverlayDB const& db() const { return m_db; }
     OverlayDB& db() { return m_db; }
+    OverlayDB const& blockToStateRootDB() const { return m_blockToStateRootDB; }
+
+    /// Compactor that has to be notified about every commit of this state and its copies.
+    void setCompactor( std::shared_ptr< HistoricStateCompactor > const& _compactor ) {
+        m_compactor = _compactor;
+    }
 
 
     /// @returns the set containing all addresses currently in use in Ethereum.
@@ -349,6 +356,8 @@ private:
         AccountMap const& _cache, SecureTrieDB< Address, OverlayDB >& _state );
 
     uint64_t m_totalTimeSpentInStateCommitsPerBlock = 0;
+
+    std::shared_ptr< HistoricStateCompactor > m_compactor;
 };
 
 std::ostream& operator<<( std::ostream& _out, HistoricState const& _s );
@@ -0,0 +1,360 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HistoricStateCompactor.h"
+
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/Log.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieCommon.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+using namespace std;
+
+namespace dev::eth {
+
+namespace {
+inline db::Slice toSlice( h256 const& _h ) {
+    return db::Slice( reinterpret_cast< char const* >( _h.data() ), _h.size );
+}
+
+inline db::Slice toSlice( std::string const& _str ) {
+    return db::Slice( _str.data(), _str.size() );
+}
+
+// key under which the last block whose root mapping has been pruned is stored
+h256 const c_prunedUpToKey = sha3( "historicStatePrunedUpTo" );
+}  // namespace
+
+// about 64 bytes each
+const size_t HistoricStateCompactor::c_defaultMaxMarkedInMemory = 4000000;
+const size_t HistoricStateCompactor::c_sweepBatchSize = 10000;
+const size_t HistoricStateCompactor::c_maxUnreachablePerScan = 1000000;
+const std::chrono::milliseconds HistoricStateCompactor::c_sweepBatchPause( 50 );
+
+bool HistoricStateRetention::isRetained( uint64_t _blockNumber, uint64_t _latestBlock ) const {
+    if ( !enabled() || _blockNumber == 0 )
+        return true;
+    if ( _blockNumber + retainBlocks > _latestBlock )
+        return true;
+    return checkpointInterval > 0 && _blockNumber % checkpointInterval == 0;
+}
+
+HistoricStateCompactor::HistoricStateCompactor( OverlayDB const& _stateDB,
+    OverlayDB const& _blockToStateRootDB, HistoricStateRetention const& _retention,
+    boost::filesystem::path const& _marksPath, size_t _maxMarkedInMemory )
+    : m_stateDB( _stateDB.backingDB() ),
+      m_blockToStateRootDB( _blockToStateRootDB.backingDB() ),
+      m_retention( _retention ),
+      m_marksPath( _marksPath ),
+      m_maxMarkedInMemory( std::max< size_t >( _maxMarkedInMemory, 1 ) ) {
+    assert( m_stateDB && m_blockToStateRootDB );
+    // left by a pass interrupted by a crash
+    boost::system::error_code ec;
+    boost::filesystem::remove_all( m_marksPath, ec );
+}
+
+HistoricStateCompactor::~HistoricStateCompactor() {
+    stop();
+}
+
+uint64_t HistoricStateCompactor::compactionPeriod() const {
+    return m_retention.checkpointInterval > 0 ? m_retention.checkpointInterval :
+                                                m_retention.retainBlocks;
+}
+
+void HistoricStateCompactor::onBlockImported( uint64_t _blockNumber ) {
+    if ( !m_retention.enabled() || m_stop || m_running )
+        return;
+    if ( _blockNumber < m_lastPassBlock + compactionPeriod() )
+        return;
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+
+    // set before the thread starts so that every commit after this point is noted
+    {
+        std::lock_guard< std::mutex > lock( m_notedMutex );
+        m_noted.clear();
+        m_running = true;
+    }
+    m_lastPassBlock = _blockNumber;
+
+    m_thread = std::thread( [this, _blockNumber]() {
+        try {
+            compact( _blockNumber );
+        } catch ( std::exception const& ex ) {
+            cerror << "Historic state compaction failed: " << ex.what();
+        } catch ( ... ) {
+            cerror << "Historic state compaction failed with unknown exception";
+        }
+        dropMarks();
+        std::lock_guard< std::mutex > lock( m_notedMutex );
+        m_noted.clear();
+        m_running = false;
+    } );
+}
+
+void HistoricStateCompactor::noteCommittedNodes( h256Hash const& _keys ) {
+    std::lock_guard< std::mutex > lock( m_notedMutex );
+    if ( !m_running )
+        return;
+    m_noted.insert( _keys.begin(), _keys.end() );
+}
+
+void HistoricStateCompactor::stop() {
+    m_stop = true;
+    wait();
+}
+
+void HistoricStateCompactor::wait() {
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+void HistoricStateCompactor::compact( uint64_t _latestBlock ) {
+    auto const startMs = db::LevelDB::getCurrentTimeMs();
+    clog( VerbosityInfo, "historic" ) << "Historic state compaction started at block "
+                                      << _latestBlock;
+
+    pruneRoots( _latestBlock );
+
+    for ( auto const& root : retainedRoots( _latestBlock ) ) {
+        if ( m_stop )
+            return;
+        markTrie( root, true );
+    }
+    // an interrupted mark phase must never be followed by a sweep
+    if ( m_stop )
+        return;
+    auto const markedNodes = m_markedCount;
+
+    m_lastPassDeletedNodes = sweep();
+
+    if ( auto* levelDB = dynamic_cast< db::LevelDB* >( m_stateDB.get() ) )
+        levelDB->doCompaction();
+
+    clog( VerbosityInfo, "historic" )
+        << "Historic state compaction finished: " << markedNodes << " nodes retained, "
+        << m_lastPassDeletedNodes << " nodes deleted in "
+        << db::LevelDB::getCurrentTimeMs() - startMs << " ms";
+}
+
+uint64_t HistoricStateCompactor::readPrunedUpTo() const {
+    std::string const value = m_blockToStateRootDB->lookup( toSlice( c_prunedUpToKey ) );
+    return value.empty() ? 0 : boost::lexical_cast< uint64_t >( value );
+}
+
+void HistoricStateCompactor::pruneRoots( uint64_t _latestBlock ) {
+    if ( _latestBlock < m_retention.retainBlocks )
+        return;
+    uint64_t const pruneTo = _latestBlock - m_retention.retainBlocks;
+    uint64_t const prunedUpTo = readPrunedUpTo();
+    if ( pruneTo <= prunedUpTo )
+        return;
+
+    auto batch = m_blockToStateRootDB->createWriteBatch();
+    for ( uint64_t blockNumber = prunedUpTo + 1; blockNumber <= pruneTo; ++blockNumber )
+        if ( !m_retention.isRetained( blockNumber, _latestBlock ) )
+            batch->kill( toSlice( h256( blockNumber ) ) );
+
+    std::string const value = to_string( pruneTo );
+    batch->insert( toSlice( c_prunedUpToKey ), toSlice( value ) );
+    m_blockToStateRootDB->commit( std::move( batch ) );
+}
+
+std::vector< h256 > HistoricStateCompactor::retainedRoots( uint64_t _latestBlock ) const {
+    h256Hash roots;
+    auto addRoot = [&]( uint64_t _blockNumber ) {
+        std::string const value = m_blockToStateRootDB->lookup( toSlice( h256( _blockNumber ) ) );
+        if ( value.size() == h256::size )
+            roots.insert( h256( value, h256::ConstructFromStringType::FromBinary ) );
+    };
+
+    uint64_t const firstFull = _latestBlock >= m_retention.retainBlocks ?
+                                   _latestBlock - m_retention.retainBlocks + 1 :
+                                   0;
+    for ( uint64_t blockNumber = firstFull; blockNumber <= _latestBlock; ++blockNumber )
+        addRoot( blockNumber );
+
+    addRoot( 0 );
+    if ( m_retention.checkpointInterval > 0 )
+        for ( uint64_t blockNumber = m_retention.checkpointInterval; blockNumber < firstFull;
+              blockNumber += m_retention.checkpointInterval )
+            addRoot( blockNumber );
+
+    return std::vector< h256 >( roots.begin(), roots.end() );
+}
+
+bool HistoricStateCompactor::markNode( h256 const& _hash ) {
+    if ( m_spilledMarks && m_spilledMarks->exists( toSlice( _hash ) ) )
+        return false;
+    if ( !m_marked.insert( _hash ).second )
+        return false;
+    ++m_markedCount;
+    if ( m_marked.size() >= m_maxMarkedInMemory )
+        spillMarks();
+    return true;
+}
+
+bool HistoricStateCompactor::isMarked( h256 const& _hash ) const {
+    return m_marked.count( _hash ) ||
+           ( m_spilledMarks && m_spilledMarks->exists( toSlice( _hash ) ) );
+}
+
+void HistoricStateCompactor::spillMarks() {
+    if ( !m_spilledMarks ) {
+        boost::filesystem::remove_all( m_marksPath );
+        boost::filesystem::create_directories( m_marksPath );
+        m_spilledMarks = std::make_unique< db::LevelDB >( m_marksPath );
+        clog( VerbosityInfo, "historic" )
+            << "Historic state compaction: more than " << m_maxMarkedInMemory
+            << " nodes retained, keeping marks in " << m_marksPath;
+    }
+    auto batch = m_spilledMarks->createWriteBatch();
+    for ( auto const& hash : m_marked )
+        batch->insert( toSlice( hash ), db::Slice() );
+    m_spilledMarks->commit( std::move( batch ) );
+    m_marked.clear();
+}
+
+void HistoricStateCompactor::dropMarks() {
+    m_marked.clear();
+    m_markedCount = 0;
+    if ( !m_spilledMarks )
+        return;
+    m_spilledMarks.reset();
+    boost::system::error_code ec;
+    boost::filesystem::remove_all( m_marksPath, ec );
+}
+
+void HistoricStateCompactor::markTrie( h256 const& _root, bool _isAccountTrie ) {
+    // payloads of nodes that are marked but whose children are not visited yet
+    std::vector< std::string > pending;
+
+    auto visitReference = [&]( RLP const& _ref ) {
+        if ( _ref.isList() ) {
+            // node shorter than 32 bytes is embedded into its parent
+            pending.emplace_back( _ref.data().toString() );
+            return;
+        }
+        if ( _ref.isEmpty() )
+            return;
+        h256 const hash = _ref.toHash< h256 >( RLP::VeryStrict );
+        if ( !markNode( hash ) )
+            return;  // whole subtree was already visited from another root
+        std::string node = m_stateDB->lookup( toSlice( hash ) );
+        if ( node.empty() ) {
+            cwarn << "Historic state compaction: missing trie node " << hash;
+            return;
+        }
+        pending.emplace_back( std::move( node ) );
+    };
+
+    auto visitValue = [&]( RLP const& _value ) {
+        if ( !_isAccountTrie || _value.isEmpty() )
+            return;
+        RLP const account( _value.payload() );
+        h256 const storageRoot = account[2].toHash< h256 >();
+        h256 const codeHash = account[3].toHash< h256 >();
+        if ( storageRoot != EmptyTrie )
+            markTrie( storageRoot, false );
+        if ( codeHash != EmptySHA3 )
+            markNode( codeHash );
+    };
+
+    if ( !markNode( _root ) )
+        return;
+    std::string rootNode = m_stateDB->lookup( toSlice( _root ) );
+    if ( rootNode.empty() ) {
+        if ( _root != EmptyTrie )
+            cwarn << "Historic state compaction: missing trie root " << _root;
+        return;
+    }
+    pending.emplace_back( std::move( rootNode ) );
+
+    while ( !pending.empty() && !m_stop ) {
+        std::string const node = std::move( pending.back() );
+        pending.pop_back();
+
+        RLP const rlp( node );
+        if ( rlp.itemCount() == 17 ) {
+            for ( unsigned i = 0; i < 16; ++i )
+                visitReference( rlp[i] );
+            visitValue( rlp[16] );
+        } else if ( rlp.itemCount() == 2 ) {
+            if ( isLeaf( rlp ) )
+                visitValue( rlp[1] );
+            else
+                visitReference( rlp[1] );
+        }
+    }
+}
+
+uint64_t HistoricStateCompactor::sweep() {
+    uint64_t deleted = 0;
+    // the database is scanned again while a scan finds more nodes than fit into memory,
+    // deleted ones are not found again
+    bool scanAgain = true;
+    while ( scanAgain && !m_stop ) {
+        std::vector< h256 > unreachable;
+        m_stateDB->forEach( [&]( db::Slice _key, db::Slice ) {
+            // aux entries have 33-byte keys and are never removed
+            if ( _key.size() != h256::size )
+                return !m_stop;
+            h256 const hash(
+                reinterpret_cast< _byte_ const* >( _key.data() ), h256::ConstructFromPointer );
+            if ( !isMarked( hash ) )
+                unreachable.push_back( hash );
+            return !m_stop && unreachable.size() < c_maxUnreachablePerScan;
+        } );
+        uint64_t const scanDeleted = sweepNodes( unreachable );
+        // nodes committed during the pass are kept, so they may fill a scan
+        scanAgain = unreachable.size() >= c_maxUnreachablePerScan && scanDeleted > 0;
+        deleted += scanDeleted;
+    }
+    return deleted;
+}
+
+uint64_t HistoricStateCompactor::sweepNodes( std::vector< h256 > const& _unreachable ) {
+    uint64_t deleted = 0;
+    for ( size_t offset = 0; offset < _unreachable.size() && !m_stop;
+          offset += c_sweepBatchSize ) {
+        size_t const end = std::min( _unreachable.size(), offset + c_sweepBatchSize );
+        {
+            // hold the lock while writing so that a node cannot be re-committed between
+            // the check and the deletion
+            std::lock_guard< std::mutex > lock( m_notedMutex );
+            auto batch = m_stateDB->createWriteBatch();
+            for ( size_t i = offset; i < end; ++i )
+                if ( !m_noted.count( _unreachable[i] ) ) {
+                    batch->kill( toSlice( _unreachable[i] ) );
+                    ++deleted;
+                }
+            m_stateDB->commit( std::move( batch ) );
+        }
+        std::this_thread::sleep_for( c_sweepBatchPause );
+    }
+    return deleted;
+}
+
+}  // namespace dev::eth
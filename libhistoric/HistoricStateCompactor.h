@@ -0,0 +1,130 @@
+/*
+Copyright (C) 2023-present, SKALE Labs
+
+This file is part of skaled.
+
+skaled is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+skaled is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/OverlayDB.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dev::eth {
+
+/// Retention policy of the historic state.
+/// Full history is kept for the last retainBlocks blocks, older blocks are kept only
+/// if they are checkpoints (block number divisible by checkpointInterval).
+/// retainBlocks == 0 means full archive, checkpointInterval == 0 means no checkpoints.
+struct HistoricStateRetention {
+    uint64_t retainBlocks = 0;
+    uint64_t checkpointInterval = 0;
+
+    bool enabled() const { return retainBlocks > 0; }
+    bool isRetained( uint64_t _blockNumber, uint64_t _latestBlock ) const;
+};
+
+/// Removes historic state that is not covered by the retention policy.
+/// Each pass drops block->root mappings of blocks that fell out of the policy, marks all trie
+/// nodes reachable from the remaining roots, and deletes every other node from the historic
+/// state database. Passes run on a background thread and delete in small throttled batches,
+/// so that they do not compete with block import for the database.
+/// At most _maxMarkedInMemory marks are kept in memory, the rest go to a scratch database at
+/// _marksPath that is removed after the pass.
+class HistoricStateCompactor {
+public:
+    HistoricStateCompactor( OverlayDB const& _stateDB, OverlayDB const& _blockToStateRootDB,
+        HistoricStateRetention const& _retention, boost::filesystem::path const& _marksPath,
+        size_t _maxMarkedInMemory = c_defaultMaxMarkedInMemory );
+    ~HistoricStateCompactor();
+
+    HistoricStateCompactor( HistoricStateCompactor const& ) = delete;
+    HistoricStateCompactor& operator=( HistoricStateCompactor const& ) = delete;
+
+    HistoricStateRetention const& retention() const { return m_retention; }
+
+    /// Starts a new pass once per compaction period if no pass is running.
+    /// Must be called from the thread that commits historic state, after the root of
+    /// _blockNumber has been saved.
+    void onBlockImported( uint64_t _blockNumber );
+
+    /// Must be called with the keys of an overlay right before it is committed to disk.
+    /// Nodes committed while a pass is running are treated as reachable.
+    void noteCommittedNodes( h256Hash const& _keys );
+
+    /// Interrupts a running pass and waits for it to finish.
+    void stop();
+    /// Waits for a running pass to finish.
+    void wait();
+
+    bool isRunning() const { return m_running; }
+    uint64_t lastPassBlock() const { return m_lastPassBlock; }
+    uint64_t lastPassDeletedNodes() const { return m_lastPassDeletedNodes; }
+
+private:
+    void compact( uint64_t _latestBlock );
+    void pruneRoots( uint64_t _latestBlock );
+    std::vector< h256 > retainedRoots( uint64_t _latestBlock ) const;
+    void markTrie( h256 const& _root, bool _isAccountTrie );
+    bool markNode( h256 const& _hash );
+    bool isMarked( h256 const& _hash ) const;
+    void spillMarks();
+    void dropMarks();
+    uint64_t sweep();
+    uint64_t sweepNodes( std::vector< h256 > const& _unreachable );
+
+    uint64_t compactionPeriod() const;
+    uint64_t readPrunedUpTo() const;
+
+    std::shared_ptr< db::DatabaseFace > m_stateDB;
+    std::shared_ptr< db::DatabaseFace > m_blockToStateRootDB;
+    HistoricStateRetention const m_retention;
+
+    std::thread m_thread;
+    std::atomic< bool > m_running = false;
+    std::atomic< bool > m_stop = false;
+
+    /// Nodes reachable from retained roots, the most recently marked ones. Only touched by the
+    /// compaction thread, as m_spilledMarks and m_markedCount are.
+    h256Hash m_marked;
+    /// Older marks that did not fit into m_marked, null until the first spill of a pass
+    std::unique_ptr< db::DatabaseFace > m_spilledMarks;
+    uint64_t m_markedCount = 0;
+    boost::filesystem::path const m_marksPath;
+    size_t const m_maxMarkedInMemory;
+    /// Nodes committed while a pass is running.
+    h256Hash m_noted;
+    mutable std::mutex m_notedMutex;
+
+    std::atomic< uint64_t > m_lastPassBlock = 0;
+    std::atomic< uint64_t > m_lastPassDeletedNodes = 0;
+
+    static const size_t c_defaultMaxMarkedInMemory;
+    static const size_t c_sweepBatchSize;
+    static const size_t c_maxUnreachablePerScan;
+    static const std::chrono::milliseconds c_sweepBatchPause;
+};
+
+}  // namespace dev::eth
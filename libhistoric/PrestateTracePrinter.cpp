@@ -125,7 +125,7 @@ void PrestateTracePrinter::printAllAccessedAccountPreValues( Json::Value& _jsonT
     if ( accessedStoragedValues.count( _address ) ) {
         for ( auto&& storageAddressValuePair : accessedStoragedValues.at( _address ) ) {
             auto& storageAddress = storageAddressValuePair.first;
-            auto originalValue = _statePre.originalStorageValue( _address, storageAddress );
+            auto originalValue = getStorageValuePre( _statePre, _address, storageAddress );
             storagePairs[toHexPrefixed( storageAddress )] = toHexPrefixed( originalValue );
             // return limited number of values to prevent DOS attacks
             m_storageValuesReturnedAll++;
@@ -252,6 +252,16 @@ u256 PrestateTracePrinter::getBalancePre(
     return balancePre;
 }
 
+// pre-transaction storage values are recorded by the tracer during execution,
+// pre state is only read for slots that were not recorded
+u256 PrestateTracePrinter::getStorageValuePre(
+    const HistoricState& _statePre, const Address& _address, const u256& _key ) const {
+    auto recordedValue = m_trace.getOriginalStorageValue( _address, _key );
+    if ( recordedValue.has_value() )
+        return *recordedValue;
+    return _statePre.originalStorageValue( _address, _key );
+}
+
 u256 PrestateTracePrinter::getBalancePost(
     const HistoricState& _statePost, const Address& _address ) const {
     auto balancePost = _statePost.balance( _address );
@@ -283,7 +293,7 @@ void PrestateTracePrinter::printPreDiffStorage( const HistoricState& _statePre,
                 // storage has been deleted. Do not include
                 includePair = false;
             } else {
-                auto storageValuePre = _statePre.originalStorageValue( _address, storageAddress );
+                auto storageValuePre = getStorageValuePre( _statePre, _address, storageAddress );
                 includePair =
                     storageValuePre != storageValuePost &&
                     storageValuePre != 0;  // geth does not print storage in pre if it is zero
@@ -291,7 +301,7 @@ void PrestateTracePrinter::printPreDiffStorage( const HistoricState& _statePre,
 
             if ( includePair ) {
                 storagePairs[toHexPrefixed( it.first )] =
-                    toHexPrefixed( _statePre.originalStorageValue( _address, it.first ) );
+                    toHexPrefixed( getStorageValuePre( _statePre, _address, it.first ) );
                 // return limited number of storage pairs to prevent DOS attacks
                 m_storageValuesReturnedPre++;
                 if ( m_storageValuesReturnedPre >= MAX_STORAGE_VALUES_RETURNED )
@@ -423,7 +433,7 @@ void PrestateTracePrinter::printPostDiffStorage( const HistoricState& _statePre,
             } else {
                 // see if the storage value has been changed
                 includePair =
-                    _statePre.originalStorageValue( _address, storageAddress ) != storageValue;
+                    getStorageValuePre( _statePre, _address, storageAddress ) != storageValue;
             }
 
             if ( includePair ) {
@@ -81,5 +81,7 @@ private:
     uint64_t m_storageValuesReturnedAll = 0;
     u256 getBalancePost( const HistoricState& _statePost, const Address& _address ) const;
     u256 getBalancePre( const HistoricState& _statePre, const Address& _address ) const;
+    u256 getStorageValuePre(
+        const HistoricState& _statePre, const Address& _address, const u256& _key ) const;
 };
 }  // namespace dev::eth
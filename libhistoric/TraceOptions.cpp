@@ -36,6 +36,10 @@ const map< string, TraceType > TraceOptions::s_stringToTracerMap = {
     { "allTracer", TraceType::ALL_TRACER }
 };
 
+const map< string, TraceOutputFormat > TraceOptions::s_stringToOutputFormatMap = {
+    { "json", TraceOutputFormat::JSON }, { "rlp", TraceOutputFormat::RLP }
+};
+
 TraceOptions TraceOptions::make( Json::Value const& _json ) {
     TraceOptions op;
 
@@ -81,6 +85,24 @@ TraceOptions TraceOptions::make( Json::Value const& _json ) {
         }
     }
 
+    if ( !_json["format"].empty() ) {
+        auto formatStr = _json["format"].asString();
+
+        if ( s_stringToOutputFormatMap.count( formatStr ) ) {
+            op.outputFormat = s_stringToOutputFormatMap.at( formatStr );
+        } else {
+            BOOST_THROW_EXCEPTION( jsonrpc::JsonRpcException(
+                jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS, "Invalid trace format:" + formatStr ) );
+        }
+    }
+
+    // only tracers that are consumed by our own tooling have a binary encoding
+    if ( op.outputFormat == TraceOutputFormat::RLP && op.tracerType != TraceType::CALL_TRACER &&
+         op.tracerType != TraceType::FOUR_BYTE_TRACER ) {
+        BOOST_THROW_EXCEPTION( jsonrpc::JsonRpcException( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS,
+            "rlp format is supported only by callTracer and 4byteTracer" ) );
+    }
+
     return op;
 }
 }  // namespace dev::eth
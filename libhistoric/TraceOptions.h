@@ -36,6 +36,10 @@ enum class TraceType {
     ALL_TRACER
 };
 
+// JSON is the geth compatible output, RLP is a compact binary encoding of the same trace
+// returned as a single hex string
+enum class TraceOutputFormat { JSON, RLP };
+
 class TraceOptions {
 public:
     bool disableStorage = false;
@@ -57,13 +61,16 @@ public:
         s << prestateDiffMode;
         s << onlyTopCall;
         s << withLog;
+        s << ( uint64_t ) outputFormat;
         return s.str();
     }
 
 
     TraceType tracerType = TraceType::DEFAULT_TRACER;
+    TraceOutputFormat outputFormat = TraceOutputFormat::JSON;
 
     static const std::map< std::string, TraceType > s_stringToTracerMap;
+    static const std::map< std::string, TraceOutputFormat > s_stringToOutputFormatMap;
     [[nodiscard]] static TraceOptions make( Json::Value const& _json );
 };
 
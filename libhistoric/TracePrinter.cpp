@@ -76,6 +76,12 @@ const string& TracePrinter::getJsonName() const {
     return m_jsonName;
 }
 
+void TracePrinter::printRLP(
+    RLPStream&, const ExecutionResult&, const HistoricState&, const HistoricState& ) {
+    // this should never happen since options are validated before tracing
+    STATE_CHECK( false );
+}
+
 
 // this will return true if the contract existed before the transaction happened
 bool TracePrinter::isPreExistingContract(
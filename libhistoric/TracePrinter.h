@@ -28,6 +28,10 @@ namespace Json {
 class Value;
 }
 
+namespace dev {
+class RLPStream;
+}
+
 namespace dev::eth {
 
 struct ExecutionResult;
@@ -41,6 +45,11 @@ public:
     virtual void print( Json::Value& _jsonTrace, const ExecutionResult&, const HistoricState&,
         const HistoricState& ) = 0;
 
+    // binary counterpart of print() used when TraceOutputFormat::RLP is requested.
+    // Only printers allowed by TraceOptions::make() override it
+    virtual void printRLP( RLPStream& _rlpTrace, const ExecutionResult&, const HistoricState&,
+        const HistoricState& );
+
     [[nodiscard]] const std::string& getJsonName() const;
 
     static std::string getEvmErrorDescription( evmc_status_code _error );
@@ -0,0 +1,140 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file MetricsExporter.cpp
+ * @date 2023
+ */
+
+#include "MetricsExporter.h"
+
+#include <libdevcore/Log.h>
+#include <libdevcore/Metrics.h>
+#include <libethereum/Client.h>
+
+#include <skutils/http.h>
+
+#include <chrono>
+
+using namespace dev;
+using namespace dev::metrics;
+
+namespace skale {
+
+namespace {
+const char c_blockNumber[] = "skaled_block_number";
+const char c_transactionQueue[] = "skaled_transaction_queue_size";
+const char c_dbSize[] = "skaled_db_size_bytes";
+const char c_extrasCache[] = "skaled_blockchain_extras_cache_lookups_total";
+
+const char* const c_queueKinds[] = { "current", "future", "unverified" };
+const char* const c_dbNames[] = { "blocks", "state", "historic_state", "historic_roots" };
+}  // namespace
+
+MetricsExporter::MetricsExporter( std::string const& _address, int _port )
+    : m_address( _address ), m_port( _port ) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    // requests are handled synchronously on the listening thread
+    m_server.reset( new skutils::http::server( 1, false ) );
+    m_server->Get(
+        "/metrics", []( const skutils::http::request&, skutils::http::response& _response ) {
+            _response.set_content(
+                Registry::instance().exposition(), "text/plain; version=0.0.4" );
+        } );
+
+    int const ipVer = m_address.find( ':' ) != std::string::npos ? 6 : 4;
+    m_failed = false;
+    m_thread = std::thread( [this, ipVer]() {
+        setThreadName( "metrics" );
+        if ( !m_server->listen( ipVer, m_address.c_str(), m_port ) )
+            m_failed = true;
+    } );
+    while ( !m_server->is_running() && !m_failed )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+    if ( m_failed ) {
+        cwarn << "Could not start metrics exporter on " << m_address << ":" << m_port;
+        stop();
+        return false;
+    }
+    clog( VerbosityInfo, "metrics" ) << "Metrics exporter listens on " << m_address << ":"
+                                     << m_port << "/metrics";
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if ( m_server )
+        m_server->stop();
+    if ( m_thread.joinable() )
+        m_thread.join();
+    m_server.reset();
+}
+
+void MetricsExporter::registerClientMetrics( eth::Client& _client ) {
+    Registry& registry = Registry::instance();
+    eth::Client* client = &_client;
+
+    registry.gauge( c_blockNumber, "Number of the latest imported block", {},
+        [client]() { return double( client->number() ); } );
+
+    std::string const queueHelp = "Count of transactions in the transaction queue";
+    registry.gauge( c_transactionQueue, queueHelp, { { "queue", "current" } },
+        [client]() { return double( client->transactionQueueStatus().current ); } );
+    registry.gauge( c_transactionQueue, queueHelp, { { "queue", "future" } },
+        [client]() { return double( client->transactionQueueStatus().future ); } );
+    registry.gauge( c_transactionQueue, queueHelp, { { "queue", "unverified" } },
+        [client]() { return double( client->transactionQueueStatus().unverified ); } );
+
+    // sizes are taken from the disk, so they are read only when scraped
+    std::string const dbHelp = "Disk usage of databases";
+    registry.gauge( c_dbSize, dbHelp, { { "db", "blocks" } },
+        [client]() { return double( client->getBlocksDbUsage().first ); } );
+    registry.gauge( c_dbSize, dbHelp, { { "db", "state" } },
+        [client]() { return double( client->getStateDbUsage().first ); } );
+#ifdef HISTORIC_STATE
+    registry.gauge( c_dbSize, dbHelp, { { "db", "historic_state" } },
+        [client]() { return double( client->getHistoricStateDbUsage() ); } );
+    registry.gauge( c_dbSize, dbHelp, { { "db", "historic_roots" } },
+        [client]() { return double( client->getHistoricRootsDbUsage() ); } );
+#endif  // HISTORIC_STATE
+
+    registry.counterFunction( c_extrasCache, "Lookups of block extras by result",
+        { { "result", "hit" } },
+        [client]() { return double( client->blockChain().extrasCacheHits() ); } );
+    registry.counterFunction( c_extrasCache, "Lookups of block extras by result",
+        { { "result", "miss" } },
+        [client]() { return double( client->blockChain().extrasCacheMisses() ); } );
+}
+
+void MetricsExporter::unregisterClientMetrics() {
+    Registry& registry = Registry::instance();
+    registry.removeGauge( c_blockNumber );
+    for ( char const* kind : c_queueKinds )
+        registry.removeGauge( c_transactionQueue, { { "queue", kind } } );
+    for ( char const* db : c_dbNames )
+        registry.removeGauge( c_dbSize, { { "db", db } } );
+    registry.removeGauge( c_extrasCache, { { "result", "hit" } } );
+    registry.removeGauge( c_extrasCache, { { "result", "miss" } } );
+}
+
+}  // namespace skale
@@ -0,0 +1,68 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file MetricsExporter.h
+ * @date 2023
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace skutils::http {
+class server;
+}
+
+namespace dev::eth {
+class Client;
+}
+
+namespace skale {
+
+/// Serves dev::metrics::Registry in Prometheus text format on GET /metrics.
+/// Runs on its own port and thread, so scrapes never queue behind JSON RPC calls.
+class MetricsExporter {
+public:
+    MetricsExporter( std::string const& _address, int _port );
+    ~MetricsExporter();
+
+    MetricsExporter( MetricsExporter const& ) = delete;
+    MetricsExporter& operator=( MetricsExporter const& ) = delete;
+
+    /// @returns false if the port cannot be listened on
+    bool start();
+    void stop();
+
+    /// Registers gauges that read the client state on every scrape.
+    /// unregisterClientMetrics() must be called before the client is destroyed.
+    static void registerClientMetrics( dev::eth::Client& _client );
+    static void unregisterClientMetrics();
+
+private:
+    std::string m_address;
+    int m_port;
+    std::unique_ptr< skutils::http::server > m_server;
+    std::thread m_thread;
+    std::atomic< bool > m_failed = false;
+};
+
+}  // namespace skale
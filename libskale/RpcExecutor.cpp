@@ -0,0 +1,247 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file RpcExecutor.cpp
+ * @date 2023
+ */
+
+#include "RpcExecutor.h"
+
+#include <libdevcore/Log.h>
+#include <libdevcore/Metrics.h>
+
+#include <algorithm>
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace skale {
+
+namespace {
+// how often a waiting caller checks whether its client is gone
+const std::chrono::milliseconds c_cancellationPollInterval{ 50 };
+}  // namespace
+
+std::map< std::string, RpcExecutor::MethodPolicy > RpcExecutor::Options::defaultMethods() {
+    // calls are short and used by dapps interactively, logs and traces can scan many blocks
+    return {
+        { "eth_call", { 2, 0 } },
+        { "eth_estimateGas", { 2, 0 } },
+        { "eth_getLogs", { 1, 2 } },
+        { "eth_getFilterLogs", { 1, 2 } },
+        { "debug_traceTransaction", { 0, 1 } },
+        { "debug_traceBlockByNumber", { 0, 1 } },
+        { "debug_traceBlockByHash", { 0, 1 } },
+        { "debug_traceBlockRange", { 0, 1 } },
+        { "debug_traceCall", { 0, 1 } },
+    };
+}
+
+RpcExecutor::Options RpcExecutor::Options::fromJson( nlohmann::json const& _jo ) {
+    Options options;
+    if ( !_jo.is_object() )
+        return options;
+    if ( _jo.count( "threads" ) )
+        options.threads = _jo["threads"].get< size_t >();
+    if ( _jo.count( "cpus" ) )
+        options.cpus = _jo["cpus"].get< std::vector< int > >();
+    if ( _jo.count( "niceness" ) )
+        options.niceness = _jo["niceness"].get< int >();
+    if ( _jo.count( "maxQueueMilliseconds" ) )
+        options.maxQueueTime =
+            std::chrono::milliseconds( _jo["maxQueueMilliseconds"].get< size_t >() );
+    if ( _jo.count( "maxQueueSize" ) )
+        options.maxQueueSize = _jo["maxQueueSize"].get< size_t >();
+    if ( _jo.count( "methods" ) ) {
+        options.methods.clear();
+        for ( auto const& [name, joPolicy] : _jo["methods"].items() ) {
+            MethodPolicy policy;
+            if ( joPolicy.count( "priority" ) )
+                policy.priority = joPolicy["priority"].get< int >();
+            if ( joPolicy.count( "maxConcurrency" ) )
+                policy.maxConcurrency = joPolicy["maxConcurrency"].get< size_t >();
+            options.methods[name] = policy;
+        }
+    }
+    return options;
+}
+
+RpcExecutor::RpcExecutor( Options const& _options ) : m_options( _options ) {
+    for ( size_t i = 0; i < m_options.threads; ++i )
+        m_workers.emplace_back( &RpcExecutor::workerThread, this, i );
+}
+
+RpcExecutor::~RpcExecutor() {
+    std::vector< std::shared_ptr< Task > > pending;
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_stop = true;
+        pending.swap( m_pending );
+    }
+    m_cv.notify_all();
+    for ( auto& task : pending )
+        task->done.set_exception(
+            std::make_exception_ptr( std::runtime_error( "server is shutting down" ) ) );
+    for ( auto& worker : m_workers )
+        worker.join();
+}
+
+RpcExecutor::Status RpcExecutor::run( std::string const& _method, std::function< void() > _fn,
+    std::function< bool() > _isCancelled ) {
+    auto const itPolicy = m_options.methods.find( _method );
+    if ( itPolicy == m_options.methods.end() || m_workers.empty() ) {
+        _fn();
+        return Status::Done;
+    }
+
+    auto task = std::make_shared< Task >();
+    task->policy = &itPolicy->second;
+    task->method = _method;
+    task->fn = std::move( _fn );
+    std::future< void > done = task->done.get_future();
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if ( m_stop || m_pending.size() >= m_options.maxQueueSize ) {
+            countDropped( _method, Status::Rejected );
+            return Status::Rejected;
+        }
+        task->sequence = m_nextSequence++;
+        m_pending.push_back( task );
+    }
+    m_cv.notify_one();
+
+    auto const deadline = std::chrono::steady_clock::now() + m_options.maxQueueTime;
+    for ( ;; ) {
+        auto const now = std::chrono::steady_clock::now();
+        auto const wait = _isCancelled ? std::min< std::chrono::steady_clock::duration >(
+                                             c_cancellationPollInterval, deadline - now ) :
+                                         deadline - now;
+        if ( now < deadline && done.wait_for( wait ) == std::future_status::ready )
+            break;
+        bool const expired = std::chrono::steady_clock::now() >= deadline;
+        if ( !expired && !( _isCancelled && _isCancelled() ) )
+            continue;
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if ( removePending( task ) ) {
+            Status const status = expired ? Status::Expired : Status::Cancelled;
+            countDropped( _method, status );
+            return status;
+        }
+        // already running, it cannot be interrupted
+        break;
+    }
+    done.get();
+    return Status::Done;
+}
+
+size_t RpcExecutor::queueSize() {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_pending.size();
+}
+
+char const* RpcExecutor::statusToString( Status _status ) {
+    switch ( _status ) {
+    case Status::Done:
+        return "done";
+    case Status::Rejected:
+        return "rejected";
+    case Status::Expired:
+        return "expired";
+    case Status::Cancelled:
+        return "cancelled";
+    }
+    return "unknown";
+}
+
+void RpcExecutor::workerThread( size_t _index ) {
+    dev::setThreadName( "rpc-exec" + std::to_string( _index ) );
+
+    if ( !m_options.cpus.empty() ) {
+        cpu_set_t cpus;
+        CPU_ZERO( &cpus );
+        for ( int cpu : m_options.cpus )
+            CPU_SET( cpu, &cpus );
+        if ( pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus ) != 0 )
+            cwarn << "Could not pin RPC executor thread to CPUs";
+    }
+    // on Linux nice value is per thread
+    if ( m_options.niceness != 0 &&
+         ::setpriority( PRIO_PROCESS, ::syscall( SYS_gettid ), m_options.niceness ) != 0 )
+        cwarn << "Could not set nice value of RPC executor thread";
+
+    std::unique_lock< std::mutex > lock( m_mutex );
+    for ( ;; ) {
+        std::shared_ptr< Task > task;
+        m_cv.wait( lock, [&]() { return m_stop || ( task = takeRunnableTask() ) != nullptr; } );
+        if ( m_stop )
+            return;
+
+        ++m_running[task->method];
+        lock.unlock();
+        try {
+            task->fn();
+            task->done.set_value();
+        } catch ( ... ) {
+            task->done.set_exception( std::current_exception() );
+        }
+        lock.lock();
+        --m_running[task->method];
+        // a call of the same method may be waiting for this slot
+        m_cv.notify_all();
+    }
+}
+
+std::shared_ptr< RpcExecutor::Task > RpcExecutor::takeRunnableTask() {
+    auto best = m_pending.end();
+    for ( auto it = m_pending.begin(); it != m_pending.end(); ++it ) {
+        Task const& task = **it;
+        size_t const limit = task.policy->maxConcurrency;
+        if ( limit != 0 && m_running[task.method] >= limit )
+            continue;
+        if ( best == m_pending.end() || task.policy->priority > ( *best )->policy->priority ||
+             ( task.policy->priority == ( *best )->policy->priority &&
+                 task.sequence < ( *best )->sequence ) )
+            best = it;
+    }
+    if ( best == m_pending.end() )
+        return nullptr;
+    std::shared_ptr< Task > task = std::move( *best );
+    m_pending.erase( best );
+    return task;
+}
+
+bool RpcExecutor::removePending( std::shared_ptr< Task > const& _task ) {
+    auto it = std::find( m_pending.begin(), m_pending.end(), _task );
+    if ( it == m_pending.end() )
+        return false;
+    m_pending.erase( it );
+    return true;
+}
+
+void RpcExecutor::countDropped( std::string const& _method, Status _status ) {
+    dev::metrics::Registry::instance()
+        .counter( "skaled_rpc_executor_dropped_total",
+            "Calls dropped by RPC executor before running",
+            { { "method", _method }, { "reason", statusToString( _status ) } } )
+        .inc();
+}
+
+}  // namespace skale
@@ -0,0 +1,122 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file RpcExecutor.h
+ * @date 2023
+ */
+
+#pragma once
+
+#include <json.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skale {
+
+/// Runs expensive read-only JSON RPC methods (eth_call, eth_getLogs, traces) on a dedicated
+/// pool of threads, so a burst of them is bounded and cannot take all CPUs from block import
+/// and consensus. Worker threads can be pinned to CPUs and run with lower priority.
+/// Each method has a priority and a limit of concurrently running calls. Calls that wait in
+/// the queue longer than maxQueueTime, or whose client is gone, are dropped before they run.
+class RpcExecutor {
+public:
+    struct MethodPolicy {
+        /// calls with higher priority are started first
+        int priority = 0;
+        /// 0 means limited only by count of threads
+        size_t maxConcurrency = 0;
+    };
+
+    struct Options {
+        /// 0 disables the executor, methods are handled on server threads then
+        size_t threads = 0;
+        /// CPUs the workers are pinned to, empty means no pinning
+        std::vector< int > cpus;
+        /// nice value of worker threads
+        int niceness = 0;
+        std::chrono::milliseconds maxQueueTime{ 2000 };
+        size_t maxQueueSize = 1024;
+        std::map< std::string, MethodPolicy > methods = defaultMethods();
+
+        static std::map< std::string, MethodPolicy > defaultMethods();
+        /// Reads {"threads", "cpus", "niceness", "maxQueueMilliseconds", "maxQueueSize",
+        /// "methods": {"<name>": {"priority", "maxConcurrency"}}}, missing fields keep defaults
+        static Options fromJson( nlohmann::json const& _jo );
+    };
+
+    enum class Status { Done, Rejected, Expired, Cancelled };
+
+    explicit RpcExecutor( Options const& _options );
+    ~RpcExecutor();
+
+    RpcExecutor( RpcExecutor const& ) = delete;
+    RpcExecutor& operator=( RpcExecutor const& ) = delete;
+
+    bool handles( std::string const& _method ) const {
+        return m_options.methods.count( _method ) != 0;
+    }
+
+    /// Runs _fn on a worker and waits for it. Exceptions of _fn are rethrown to the caller.
+    /// _isCancelled is polled while the call waits in the queue.
+    Status run( std::string const& _method, std::function< void() > _fn,
+        std::function< bool() > _isCancelled = {} );
+
+    /// @returns count of calls waiting for a worker
+    size_t queueSize();
+
+    static char const* statusToString( Status _status );
+
+private:
+    struct Task {
+        MethodPolicy const* policy;
+        std::string method;
+        std::function< void() > fn;
+        uint64_t sequence;
+        std::promise< void > done;
+    };
+
+    void workerThread( size_t _index );
+    // must be called under m_mutex, @returns nullptr if no call may start now
+    std::shared_ptr< Task > takeRunnableTask();
+    // must be called under m_mutex, @returns false if a worker has taken the task already
+    bool removePending( std::shared_ptr< Task > const& _task );
+    void countDropped( std::string const& _method, Status _status );
+
+    Options const m_options;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector< std::shared_ptr< Task > > m_pending;
+    std::map< std::string, size_t > m_running;
+    uint64_t m_nextSequence = 0;
+    bool m_stop = false;
+
+    std::vector< std::thread > m_workers;
+};
+
+}  // namespace skale
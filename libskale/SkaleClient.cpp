@@ -65,6 +65,20 @@ std::string SkaleClient::skale_receiveTransaction( const std::string& _rlp ) {
             jsonrpc::Errors::ERROR_CLIENT_INVALID_RESPONSE, result.toStyledString() );
 }
 
+std::string SkaleClient::skale_receiveTransactions( const std::string& _rlpList ) {
+    Json::Value p;
+    Json::Value result;
+    p.append( _rlpList );
+
+    result = this->CallMethod( "skale_receiveTransactions", p );
+
+    if ( result.isString() ) {
+        return result.asString();
+    } else
+        throw jsonrpc::JsonRpcException(
+            jsonrpc::Errors::ERROR_CLIENT_INVALID_RESPONSE, result.toStyledString() );
+}
+
 Json::Value SkaleClient::skale_getSnapshotSignature( unsigned blockNumber ) {
     Json::Value p;
     Json::Value result;
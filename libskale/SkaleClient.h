@@ -37,6 +37,8 @@ public:
 
     std::string skale_receiveTransaction( std::string const& _rlp ) noexcept( false );
 
+    std::string skale_receiveTransactions( std::string const& _rlpList ) noexcept( false );
+
     std::string skale_shutdownInstance() noexcept( false );
 
     Json::Value skale_getSnapshotSignature( unsigned blockNumber ) noexcept( false );
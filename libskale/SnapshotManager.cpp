@@ -34,6 +34,7 @@
 #include <libbatched-io/batched_io.h>
 #include <libdevcore/LevelDB.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/ValueCodec.h>
 #include <libdevcrypto/Hash.h>
 #include <skutils/btrfs.h>
 #include <boost/filesystem/operations.hpp>
@@ -483,8 +484,8 @@ bool SnapshotManager::isSnapshotHashPresent( unsigned _blockNumber ) const {
     }
 }
 
-void SnapshotManager::computeDatabaseHash(
-    const boost::filesystem::path& _dbDir, secp256k1_sha256_t* ctx ) const try {
+void SnapshotManager::computeDatabaseHash( const boost::filesystem::path& _dbDir,
+    secp256k1_sha256_t* ctx, bool _decodeValues ) const try {
     if ( !boost::filesystem::exists( _dbDir ) ) {
         BOOST_THROW_EXCEPTION( InvalidPath( _dbDir ) );
     }
@@ -494,13 +495,16 @@ void SnapshotManager::computeDatabaseHash(
 
     std::string lastHashedKey = "start";
     bool isContinue = true;
+    std::function< void( std::string& ) > normalizeValue;
+    if ( _decodeValues )
+        normalizeValue = dev::db::ValueCodec::decodeIfEncoded;
 
     while ( isContinue ) {
         std::unique_ptr< dev::db::LevelDB > m_db( new dev::db::LevelDB( _dbDir.string(),
             dev::db::LevelDB::defaultSnapshotReadOptions(), dev::db::LevelDB::defaultWriteOptions(),
             dev::db::LevelDB::defaultSnapshotDBOptions() ) );
 
-        isContinue = m_db->hashBasePartially( &dbCtx, lastHashedKey );
+        isContinue = m_db->hashBasePartially( &dbCtx, lastHashedKey, normalizeValue );
     }
 
     dev::h256 dbHash;
@@ -689,7 +693,8 @@ void SnapshotManager::computeAllVolumesHash(
     for ( auto& content : contents ) {
         if ( cnt++ >= 5 )
             break;
-        this->computeDatabaseHash( content, ctx );
+        // the hash must not depend on codec settings of the node
+        this->computeDatabaseHash( content, ctx, true );
     }
 
     // filestorage
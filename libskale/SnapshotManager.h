@@ -201,8 +201,9 @@ private:
     void proceedDirectory( const boost::filesystem::path& path, secp256k1_sha256_t* ctx ) const;
     void computeAllVolumesHash(
         unsigned _blockNumber, secp256k1_sha256_t* ctx, bool is_checking ) const;
-    void computeDatabaseHash(
-        const boost::filesystem::path& _dbDir, secp256k1_sha256_t* ctx ) const;
+    // _decodeValues hashes plain values of ones stored by dev::db::ValueCodec
+    void computeDatabaseHash( const boost::filesystem::path& _dbDir, secp256k1_sha256_t* ctx,
+        bool _decodeValues = false ) const;
     void addLastPriceToHash( unsigned _blockNumber, secp256k1_sha256_t* ctx ) const;
 };
 
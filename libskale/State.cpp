@@ -32,7 +32,9 @@
 
 #include <libdevcore/DBImpl.h>
 #include <libethcore/SealEngine.h>
+#include <libethereum/BlockImportTimeline.h>
 #include <libethereum/CodeSizeCache.h>
+#include <libethereum/ContractProfiler.h>
 #include <libethereum/Defaults.h>
 #include <libethereum/StateImporter.h>
 
@@ -450,6 +452,7 @@ eth::Account* State::account( Address const& _address ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
 
+        dev::eth::ContractProfiler::noteDbMiss();
         stateBack = asBytes( m_db_ptr->lookup( _address ) );
     }
     if ( stateBack.empty() ) {
@@ -498,6 +501,7 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
         removeEmptyAccounts();
 
     {
+        dev::eth::BlockImportTimeline::ScopedStage timelineStage( "state_commit", "commit" );
         if ( !m_db_write_lock ) {
             BOOST_THROW_EXCEPTION( AttemptToWriteToNotLockedStateObject() );
         }
@@ -549,7 +553,10 @@ void State::commit( dev::eth::CommitBehaviour _commitBehaviour ) {
 
 
 #ifdef HISTORIC_STATE
-    m_historicState.commitExternalChanges( m_cache );
+    {
+        dev::eth::BlockImportTimeline::ScopedStage timelineStage( "historic_commit", "commit" );
+        m_historicState.commitExternalChanges( m_cache );
+    }
 #endif
 
     m_changeLog.clear();
@@ -721,6 +728,7 @@ u256 State::storage( Address const& _id, u256 const& _key ) const {
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
+        dev::eth::ContractProfiler::noteDbMiss();
         u256 value = m_db_ptr->lookup( _id, _key );
         acc->setStorageCache( _key, value );
         return value;
@@ -779,6 +787,7 @@ u256 State::originalStorageValue( Address const& _contract, u256 const& _key ) c
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
+        dev::eth::ContractProfiler::noteDbMiss();
         u256 value = m_db_ptr->lookup( _contract, _key );
         acc->setStorageCache( _key, value );
         return value;
@@ -837,6 +846,7 @@ bytes const& State::code( Address const& _addr ) const {
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
+        dev::eth::ContractProfiler::noteDbMiss();
         mutableAccount->noteCode( m_db_ptr->lookupAuxiliary( _addr, Auxiliary::CODE ) );
         eth::CodeSizeCache::instance().store( a->codeHash(), a->code().size() );
     }
@@ -1029,6 +1039,8 @@ std::pair< ExecutionResult, TransactionReceipt > State::execute( EnvInfo const&
     // TODO Not sure that 1st 0 as timestamp is acceptable here
     Executive e( *this, _envInfo, _chainParams, 0, 0, _p != Permanence::Committed );
     ExecutionResult res;
+    // only transactions of blocks are profiled, not calls
+    dev::eth::ContractProfiler::TransactionScope profilerScope( _p == Permanence::Committed );
     e.setResultRecipient( res );
 
     bool isCacheEnabled = RevertableFSPatch::isEnabledWhen( _envInfo.committedBlockTimestamp() );
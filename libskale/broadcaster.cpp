@@ -24,6 +24,8 @@
 
 #include "broadcaster.h"
 
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/RLP.h>
 #include <libethereum/Client.h>
 #include <libethereum/SkaleHost.h>
 #include <libskale/SkaleClient.h>
@@ -34,13 +36,25 @@
 
 #include <string>
 
+namespace {
+// marks ZMQ messages with a batch of transactions, single transactions are sent as plain hex
+const std::string c_batchPrefix = "batch:";
+}  // namespace
+
 Broadcaster::~Broadcaster() {}
 
-HttpBroadcaster::HttpBroadcaster( dev::eth::Client& _client ) : m_client( _client ) {
+const size_t HttpBroadcaster::c_maxQueuedBatches = 1024;
+
+HttpBroadcaster::HttpBroadcaster( dev::eth::Client& _client )
+    : m_client( _client ), m_need_exit( false ) {
     const dev::eth::ChainParams& ch = _client.chainParams();
     initClients( ch.sChain, ch.nodeInfo );
 }
 
+HttpBroadcaster::~HttpBroadcaster() {
+    stopService();
+}
+
 void HttpBroadcaster::initClients( dev::eth::SChain sChain, dev::eth::NodeInfo nodeInfo ) {
     for ( const auto& node : sChain.nodes ) {
         if ( nodeInfo.id == node.id ) {
@@ -48,8 +62,51 @@ void HttpBroadcaster::initClients( dev::eth::SChain sChain, dev::eth::NodeInfo n
         }
         auto c = new jsonrpc::HttpClient( getHttpUrl( node ) );
 
-        auto skaleClient = std::make_shared< SkaleClient >( *c );
-        m_nodeClients.push_back( skaleClient );
+        auto peer = std::make_unique< PeerSender >();
+        peer->client = std::make_shared< SkaleClient >( *c );
+        m_peers.push_back( std::move( peer ) );
+    }
+}
+
+void HttpBroadcaster::startService() {
+    for ( auto& peer : m_peers )
+        if ( !peer->thread.joinable() )
+            peer->thread =
+                std::thread( &HttpBroadcaster::peerSenderThread, this, std::ref( *peer ) );
+}
+
+void HttpBroadcaster::stopService() {
+    m_need_exit = true;
+    for ( auto& peer : m_peers ) {
+        {
+            std::lock_guard< std::mutex > lock( peer->mutex );
+            peer->cv.notify_all();
+        }
+        if ( peer->thread.joinable() )
+            peer->thread.join();
+    }
+    // broadcastBatch() starts the threads again
+    m_need_exit = false;
+}
+
+void HttpBroadcaster::peerSenderThread( PeerSender& _peer ) {
+    dev::setThreadName( "HttpBroadcaster" );
+    while ( !m_need_exit ) {
+        std::string batch;
+        {
+            std::unique_lock< std::mutex > lock( _peer.mutex );
+            _peer.cv.wait( lock, [&]() { return m_need_exit || !_peer.batches.empty(); } );
+            if ( m_need_exit )
+                return;
+            batch = std::move( _peer.batches.front() );
+            _peer.batches.pop_front();
+        }
+        try {
+            _peer.client->skale_receiveTransactions( batch );
+        } catch ( const std::exception& ex ) {
+            clog( dev::VerbosityDebug, "broadcaster" )
+                << "Failed to send transactions to peer: " << ex.what();
+        }
     }
 }
 
@@ -64,8 +121,21 @@ void HttpBroadcaster::broadcast( const std::string& _rlp ) {
     if ( _rlp.empty() )
         return;
 
-    for ( const auto& node : m_nodeClients ) {
-        node->skale_receiveTransaction( _rlp );
+    dev::RLPStream rlpList( 1 );
+    rlpList.append( dev::jsToBytes( _rlp, dev::OnFailed::Throw ) );
+    broadcastBatch( dev::toJS( rlpList.out() ) );
+}
+
+void HttpBroadcaster::broadcastBatch( const std::string& _rlpList ) {
+    startService();
+    for ( auto& peer : m_peers ) {
+        std::lock_guard< std::mutex > lock( peer->mutex );
+        if ( peer->batches.size() >= c_maxQueuedBatches ) {
+            clog( dev::VerbosityDebug, "broadcaster" ) << "Peer queue is full, dropping a batch";
+            peer->batches.pop_front();
+        }
+        peer->batches.push_back( _rlpList );
+        peer->cv.notify_one();
     }
 }
 
@@ -195,7 +265,10 @@ void ZmqBroadcaster::startService() {
                 std::string str( static_cast< char* >( data ), size );
 
                 try {
-                    m_skaleHost.receiveTransaction( str );
+                    if ( str.compare( 0, c_batchPrefix.size(), c_batchPrefix ) == 0 )
+                        m_skaleHost.receiveTransactions( str.substr( c_batchPrefix.size() ) );
+                    else
+                        m_skaleHost.receiveTransaction( str );
                 } catch ( const std::exception& ex ) {
                     clog( dev::VerbosityDebug, "skale-host" )
                         << "Received bad transaction through broadcast: " << ex.what();
@@ -245,3 +318,8 @@ void ZmqBroadcaster::broadcast( const std::string& _rlp ) {
         throw std::runtime_error( "Zmq can't send data" );
     }
 }
+
+void ZmqBroadcaster::broadcastBatch( const std::string& _rlpList ) {
+    // one message for the whole batch, ZMQ PUB socket queues it for all peers without blocking
+    broadcast( c_batchPrefix + _rlpList );
+}
@@ -28,7 +28,11 @@
 
 #include <libethereum/ChainParams.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -53,6 +57,9 @@ public:
     virtual ~Broadcaster();
 
     virtual void broadcast( const std::string& _rlp ) = 0;
+    /// Sends hex-encoded RLP list of transactions, receivers import it with
+    /// SkaleHost::receiveTransactions
+    virtual void broadcastBatch( const std::string& _rlpList ) = 0;
 
     virtual void startService() = 0;
     virtual void stopService() = 0;
@@ -61,18 +68,34 @@ public:
 class HttpBroadcaster : public Broadcaster {
 public:
     HttpBroadcaster( dev::eth::Client& _client );
-    virtual ~HttpBroadcaster() {}
+    virtual ~HttpBroadcaster();
 
     virtual void broadcast( const std::string& _rlp );
-    virtual void startService() {}
-    virtual void stopService() {}
+    virtual void broadcastBatch( const std::string& _rlpList );
+    virtual void startService();
+    virtual void stopService();
 
 private:
+    // each peer is served by its own thread, so a slow peer does not delay the others
+    // and broadcast() does not wait for the network
+    struct PeerSender {
+        std::shared_ptr< SkaleClient > client;
+        std::deque< std::string > batches;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
     dev::eth::Client& m_client;
-    std::vector< std::shared_ptr< SkaleClient > > m_nodeClients;
+    std::vector< std::unique_ptr< PeerSender > > m_peers;
+    std::atomic_bool m_need_exit;
+
+    // older batches are dropped if a peer does not keep up
+    static const size_t c_maxQueuedBatches;
 
     void initClients( dev::eth::SChain, dev::eth::NodeInfo );
     std::string getHttpUrl( const dev::eth::sChainNode& );
+    void peerSenderThread( PeerSender& _peer );
 };
 
 class ZmqBroadcaster : public Broadcaster {
@@ -81,6 +104,7 @@ public:
     virtual ~ZmqBroadcaster();
 
     virtual void broadcast( const std::string& _rlp );
+    virtual void broadcastBatch( const std::string& _rlpList );
 
     virtual void startService();
     virtual void stopService();
@@ -23,20 +23,27 @@
  */
 
 #include "httpserveroverride.h"
+#include "RpcExecutor.h"
 
 #include <libdevcore/microprofile.h>
 
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/Metrics.h>
 
 #include <jsonrpccpp/common/specificationparser.h>
 
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <exception>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -63,6 +70,7 @@
 #include <libweb3jsonrpc/Skale.h>
 
 #include <skutils/eth_utils.h>
+#include <skutils/http_pg.h>
 #include <skutils/multithreading.h>
 #include <skutils/network.h>
 #include <skutils/task_performance.h>
@@ -161,51 +169,17 @@ nlohmann::json nljsBlockNumber( dev::eth::BlockNumber uBlockNumber ) {
     return dev::toJS( uBlockNumber );
 }
 
-nlohmann::json toJson( std::unordered_map< dev::h256, dev::eth::LocalisedLogEntries > const& eb,
-    std::vector< dev::h256 > const& order ) {
-    nlohmann::json res = nlohmann::json::array();
-    for ( auto const& i : order ) {
-        auto entries = eb.at( i );
-        nlohmann::json currentBlock = nlohmann::json::object();
-        dev::eth::LocalisedLogEntry entry = entries[0];
-        if ( entry.mined ) {
-            currentBlock["blockNumber"] = nljsBlockNumber( entry.blockNumber );
-            currentBlock["blockHash"] = toJS( entry.blockHash );
-            currentBlock["type"] = "mined";
-        } else
-            currentBlock["type"] = "pending";
-        currentBlock["polarity"] = entry.polarity == dev::eth::BlockPolarity::Live ? true : false;
-        currentBlock["logs"] = nlohmann::json::array();
-        for ( dev::eth::LocalisedLogEntry const& e : entries ) {
-            nlohmann::json log = nlohmann::json::object();
-            log["logIndex"] = e.logIndex;
-            log["transactionIndex"] = e.transactionIndex;
-            log["transactionHash"] = toJS( e.transactionHash );
-            log["address"] = dev::toJS( e.address );
-            log["data"] = dev::toJS( e.data );
-            log["topics"] = nlohmann::json::array();
-            for ( auto const& t : e.topics )
-                log["topics"].push_back( dev::toJS( t ) );
-            currentBlock["logs"].push_back( log );
-        }
-        res.push_back( currentBlock );
-    }
-    return res;
-}
-
-nlohmann::json toJsonByBlock( dev::eth::LocalisedLogEntries const& le ) {
-    std::vector< dev::h256 > order;
-    std::unordered_map< dev::h256, dev::eth::LocalisedLogEntries > entriesByBlock;
-    for ( dev::eth::LocalisedLogEntry const& e : le ) {
-        if ( e.isSpecial )  // skip special log
-            continue;
-        if ( entriesByBlock.count( e.blockHash ) == 0 ) {
-            entriesByBlock[e.blockHash] = dev::eth::LocalisedLogEntries();
-            order.push_back( e.blockHash );
-        }
-        entriesByBlock[e.blockHash].push_back( e );
-    }
-    return toJson( entriesByBlock, order );
+nlohmann::json log_entry_to_json( const dev::eth::LocalisedLogEntry& e ) {
+    nlohmann::json log = nlohmann::json::object();
+    log["logIndex"] = e.logIndex;
+    log["transactionIndex"] = e.transactionIndex;
+    log["transactionHash"] = toJS( e.transactionHash );
+    log["address"] = dev::toJS( e.address );
+    log["data"] = dev::toJS( e.data );
+    log["topics"] = nlohmann::json::array();
+    for ( auto const& t : e.topics )
+        log["topics"].push_back( dev::toJS( t ) );
+    return log;
 }
 
 bool checkParamsPresent(
@@ -263,6 +237,56 @@ bool checkParamsIsObject( const char* strMethodName, const rapidjson::Document&
     return false;
 }
 
+// composed as text, so the result shared by all subscribers is not parsed or dumped again,
+// keys are in the same order as nlohmann::json::dump() writes them
+std::string make_subscription_notification(
+    const std::string& strSubscription, const std::string& strResult ) {
+    static const std::string g_strHead =
+        "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{\"result\":";
+    static const std::string g_strSubscription = ",\"subscription\":\"";
+    std::string strNotification;
+    strNotification.reserve( g_strHead.size() + strResult.size() + g_strSubscription.size() +
+                             strSubscription.size() + 4 );
+    strNotification += g_strHead;
+    strNotification += strResult;
+    strNotification += g_strSubscription;
+    strNotification += strSubscription;
+    strNotification += "\"}}";
+    return strNotification;
+}
+
+shared_result_cache::result_ptr_t shared_result_cache::get(
+    const std::string& strKey, const std::function< std::string() >& fnMake ) {
+    {
+        std::lock_guard< std::mutex > lock( mtx_ );
+        auto it = map_.find( strKey );
+        if ( it != map_.end() )
+            return it->second;
+    }
+    // made outside of lock, peers racing for the same new event make it more than once
+    result_ptr_t pResult = std::make_shared< const std::string >( fnMake() );
+    std::lock_guard< std::mutex > lock( mtx_ );
+    auto [it, isInserted] = map_.emplace( strKey, pResult );
+    if ( !isInserted )
+        return it->second;
+    order_.push_back( strKey );
+    while ( order_.size() > nMaxEntries_ ) {
+        map_.erase( order_.front() );
+        order_.pop_front();
+    }
+    return pResult;
+}
+
+size_t shared_result_cache::size() const {
+    std::lock_guard< std::mutex > lock( mtx_ );
+    return map_.size();
+}
+
+shared_result_cache& shared_result_cache::instance() {
+    static shared_result_cache g_cache;
+    return g_cache;
+}
+
 };  // namespace helper
 };  // namespace server
 };  // namespace skale
@@ -270,240 +294,184 @@ bool checkParamsIsObject( const char* strMethodName, const rapidjson::Document&
 
 namespace stats {
 
+// RPC call counters are kept per (subsystem, method) pair. Each pair is interned once into a
+// record with a stable address, and every server thread caches pointers to records it has
+// seen, so registering an event touches only relaxed atomics of the thread's own shard of
+// the record. Shards are summed and rates are computed only when stats are read.
+
 typedef skutils::multithreading::recursive_mutex_type mutex_type_stats;
 typedef std::lock_guard< mutex_type_stats > lock_type_stats;
+// serializes readers of stats, writers never take it
 static skutils::multithreading::recursive_mutex_type g_mtx_stats( "RMTX-NMA-PEER-ALL" );
 
-struct map_method_call_stats_t
-    : public std::map< std::string, skutils::stats::named_event_stats* > {
-    typedef std::map< std::string, skutils::stats::named_event_stats* > my_base_t;
-    void clear() {
-        iterator itWalk = begin(), itEnd = end();
-        for ( ; itWalk != itEnd; ++itWalk ) {
-            skutils::stats::named_event_stats* x = itWalk->second;
-            if ( x )
-                delete x;
-        }
-        my_base_t::clear();
-    }
-    map_method_call_stats_t() = default;
-    ~map_method_call_stats_t() { clear(); }
-    map_method_call_stats_t( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t( map_method_call_stats_t&& ) = delete;
-    map_method_call_stats_t& operator=( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t& operator=( map_method_call_stats_t&& ) = delete;
+static const size_t g_nCountOfStatsShards = 16;
+
+struct stats_counters_t {
+    uint64_t nCalls = 0, nAnswers = 0, nErrors = 0, nExceptions = 0;
+    uint64_t nBytesRecv = 0, nBytesSent = 0;
 };
 
-map_method_call_stats_t g_map_method_call_stats;
-map_method_call_stats_t g_map_method_answer_stats;
-map_method_call_stats_t g_map_method_error_stats;
-map_method_call_stats_t g_map_method_exception_stats;
-map_method_call_stats_t g_map_method_traffic_stats_in;
-map_method_call_stats_t g_map_method_traffic_stats_out;
-static size_t g_nSizeDefaultOnQueueAdd = 10;
+struct alignas( 64 ) stats_shard_t {
+    std::atomic< uint64_t > nCalls{ 0 }, nAnswers{ 0 }, nErrors{ 0 }, nExceptions{ 0 };
+    std::atomic< uint64_t > nBytesRecv{ 0 }, nBytesSent{ 0 };
+};
 
-static skutils::stats::named_event_stats& stat_subsystem_call_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_call_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_call_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_call_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_answer_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_answer_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_answer_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_answer_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_error_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_error_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_error_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_error_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_exception_queue(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_exception_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_exception_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
+struct method_stats_t {
+    std::string strMethodName;
+    stats_shard_t shards[g_nCountOfStatsShards];
+    // previous read used for rates, guarded by g_mtx_stats
+    stats_counters_t countersLast;
+    skutils::stats::time_point tpLast = skutils::stats::clock::now();
+    double lfCps = 0.0, lfAps = 0.0, lfErps = 0.0, lfExps = 0.0;
+    double lfBpsRecv = 0.0, lfBpsSent = 0.0;
+
+    stats_counters_t sum() const {
+        stats_counters_t c;
+        for ( const stats_shard_t& shard : shards ) {
+            c.nCalls += shard.nCalls.load( std::memory_order_relaxed );
+            c.nAnswers += shard.nAnswers.load( std::memory_order_relaxed );
+            c.nErrors += shard.nErrors.load( std::memory_order_relaxed );
+            c.nExceptions += shard.nExceptions.load( std::memory_order_relaxed );
+            c.nBytesRecv += shard.nBytesRecv.load( std::memory_order_relaxed );
+            c.nBytesSent += shard.nBytesSent.load( std::memory_order_relaxed );
+        }
+        return c;
     }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_exception_stats[strSubSystem] = x;
-    return ( *x );
-}
+};
 
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_in(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_in.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_in ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_in[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_out(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_out.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_out ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
+static std::shared_mutex g_mtx_stats_records;
+// records are never removed, subsystem name -> method name -> record; callers pass only
+// methods the server has (see SkaleServerOverride::statsMethodName()), so the count of records
+// does not depend on what clients send
+static std::map< std::string, std::map< std::string, std::unique_ptr< method_stats_t > > >
+    g_map_subsystem_stats;
+
+static method_stats_t& stat_intern_record(
+    const std::string& strSubSystem, const std::string& strMethodName ) {
+    {
+        std::shared_lock< std::shared_mutex > lock( g_mtx_stats_records );
+        auto itSubSystem = g_map_subsystem_stats.find( strSubSystem );
+        if ( itSubSystem != g_map_subsystem_stats.end() ) {
+            auto itMethod = itSubSystem->second.find( strMethodName );
+            if ( itMethod != itSubSystem->second.end() )
+                return *itMethod->second;
+        }
     }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_out[strSubSystem] = x;
-    return ( *x );
+    std::unique_lock< std::shared_mutex > lock( g_mtx_stats_records );
+    auto& mapMethods = g_map_subsystem_stats[strSubSystem];
+    auto itMethod = mapMethods.find( strMethodName );
+    if ( itMethod != mapMethods.end() )
+        return *itMethod->second;
+    std::unique_ptr< method_stats_t > pRecord( new method_stats_t );
+    pRecord->strMethodName = strMethodName;
+    method_stats_t& record = *pRecord;
+    mapMethods[strMethodName] = std::move( pRecord );
+    return record;
+}
+
+// thread's own shard of the record, lookups go through a per-thread cache of records
+static stats_shard_t& stat_shard( const char* strSubSystem, const char* strMethodName ) {
+    static std::atomic_size_t g_nNextShardIndex( 0 );
+    thread_local const size_t nShardIndex = g_nNextShardIndex++ % g_nCountOfStatsShards;
+    thread_local std::unordered_map< std::string, method_stats_t* > mapCache;
+    thread_local std::string strKey;
+    strKey.assign( strSubSystem );
+    strKey += '\t';
+    strKey += strMethodName;
+    auto itFind = mapCache.find( strKey );
+    if ( itFind != mapCache.end() )
+        return itFind->second->shards[nShardIndex];
+    method_stats_t& record = stat_intern_record( strSubSystem, strMethodName );
+    mapCache.emplace( strKey, &record );
+    return record.shards[nShardIndex];
 }
 
-
 void register_stats_message(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    cq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    cq.event_add( strMethodName );
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_in( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    tq.event_add( strMethodName, nJsonSize );
+    stats_shard_t& shard = stat_shard( strSubSystem, strMethodName );
+    shard.nCalls.fetch_add( 1, std::memory_order_relaxed );
+    shard.nBytesRecv.fetch_add( nJsonSize, std::memory_order_relaxed );
 }
 void register_stats_answer(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    aq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    aq.event_add( strMethodName );
-
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_out( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    tq.event_add( strMethodName, nJsonSize );
+    stats_shard_t& shard = stat_shard( strSubSystem, strMethodName );
+    shard.nAnswers.fetch_add( 1, std::memory_order_relaxed );
+    shard.nBytesSent.fetch_add( nJsonSize, std::memory_order_relaxed );
 }
 void register_stats_error( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_error_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    eq.event_add( strMethodName );
+    stat_shard( strSubSystem, strMethodName ).nErrors.fetch_add( 1, std::memory_order_relaxed );
 }
 void register_stats_exception( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_exception_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    eq.event_add( strMethodName );
-}
-
-void register_stats_message( const char* strSubSystem, const nlohmann::json& joMessage ) {
-    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joMessage, "method" );
-    std::string txt = joMessage.dump();
-    size_t txt_len = txt.length();
-    register_stats_message( strSubSystem, strMethodName.c_str(), txt_len );
-}
-void register_stats_answer(
-    const char* strSubSystem, const nlohmann::json& joMessage, const nlohmann::json& joAnswer ) {
-    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joMessage, "method" );
-    std::string txt = joAnswer.dump();
-    size_t txt_len = txt.length();
-    register_stats_answer( strSubSystem, strMethodName.c_str(), txt_len );
-}
-void register_stats_error( const char* strSubSystem, const nlohmann::json& joMessage ) {
-    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joMessage, "method" );
-    register_stats_error( strSubSystem, strMethodName.c_str() );
-}
-void register_stats_exception( const char* strSubSystem, const nlohmann::json& joMessage ) {
-    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joMessage, "method" );
-    register_stats_exception( strSubSystem, strMethodName.c_str() );
+    stat_shard( strSubSystem, strMethodName )
+        .nExceptions.fetch_add( 1, std::memory_order_relaxed );
 }
 
 static nlohmann::json generate_subsystem_stats( const char* strSubSystem ) {
     lock_type_stats lock( g_mtx_stats );
     nlohmann::json jo = nlohmann::json::object();
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    skutils::stats::named_event_stats& erq = stat_subsystem_error_queue( strSubSystem );
-    skutils::stats::named_event_stats& exq = stat_subsystem_exception_queue( strSubSystem );
-    skutils::stats::named_event_stats& tq_in = stat_subsystem_traffic_queue_in( strSubSystem );
-    skutils::stats::named_event_stats& tq_out = stat_subsystem_traffic_queue_out( strSubSystem );
-    std::set< std::string > setNames = cq.all_queue_names(), setNames_aq = aq.all_queue_names(),
-                            setNames_erq = erq.all_queue_names(),
-                            setNames_exq = exq.all_queue_names(),
-                            setNames_tq_in = tq_in.all_queue_names(),
-                            setNames_tq_out = tq_out.all_queue_names();
-    std::set< std::string >::const_iterator itNameWalk, itNameEnd;
-    for ( itNameWalk = setNames_aq.cbegin(), itNameEnd = setNames_aq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_erq.cbegin(), itNameEnd = setNames_erq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_exq.cbegin(), itNameEnd = setNames_exq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_in.cbegin(), itNameEnd = setNames_tq_in.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_out.cbegin(), itNameEnd = setNames_tq_out.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames.cbegin(), itNameEnd = setNames.cend(); itNameWalk != itNameEnd;
-          ++itNameWalk ) {
-        const std::string& strMethodName = ( *itNameWalk );
-        size_t nCalls = 0, nAnswers = 0, nErrors = 0, nExceptions = 0;
-        skutils::stats::bytes_count_t nBytesRecv = 0, nBytesSent = 0;
-        skutils::stats::time_point tpNow = skutils::stats::clock::now();
-        double lfCallsPerSecond = cq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nCalls );
-        double lfAnswersPerSecond =
-            aq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nAnswers );
-        double lfErrorsPerSecond =
-            erq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nErrors );
-        double lfExceptionsPerSecond =
-            exq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nExceptions );
-        double lfBytesPerSecondRecv = tq_in.compute_eps_smooth( strMethodName, tpNow, &nBytesRecv );
-        double lfBytesPerSecondSent =
-            tq_out.compute_eps_smooth( strMethodName, tpNow, &nBytesSent );
+    std::vector< method_stats_t* > vecRecords;
+    {
+        std::shared_lock< std::shared_mutex > lockRecords( g_mtx_stats_records );
+        auto itSubSystem = g_map_subsystem_stats.find( strSubSystem );
+        if ( itSubSystem == g_map_subsystem_stats.end() )
+            return jo;
+        for ( const auto& entry : itSubSystem->second )
+            vecRecords.push_back( entry.second.get() );
+    }
+    skutils::stats::time_point tpNow = skutils::stats::clock::now();
+    for ( method_stats_t* pRecord : vecRecords ) {
+        method_stats_t& record = *pRecord;
+        stats_counters_t c = record.sum();
+        // rates are averaged over at least one second since the previous read
+        double lfSeconds = std::chrono::duration< double >( tpNow - record.tpLast ).count();
+        if ( lfSeconds >= 1.0 ) {
+            const stats_counters_t& l = record.countersLast;
+            record.lfCps = ( c.nCalls - l.nCalls ) / lfSeconds;
+            record.lfAps = ( c.nAnswers - l.nAnswers ) / lfSeconds;
+            record.lfErps = ( c.nErrors - l.nErrors ) / lfSeconds;
+            record.lfExps = ( c.nExceptions - l.nExceptions ) / lfSeconds;
+            record.lfBpsRecv = ( c.nBytesRecv - l.nBytesRecv ) / lfSeconds;
+            record.lfBpsSent = ( c.nBytesSent - l.nBytesSent ) / lfSeconds;
+            record.countersLast = c;
+            record.tpLast = tpNow;
+        }
         nlohmann::json joMethod = nlohmann::json::object();
-        joMethod["cps"] = lfCallsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["aps"] = lfAnswersPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["erps"] = lfErrorsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["exps"] = lfExceptionsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["bps_recv"] = lfBytesPerSecondRecv;
-        joMethod["bps_sent"] = lfBytesPerSecondSent;
-        joMethod["calls"] = nCalls;
-        joMethod["answers"] = nAnswers;
-        joMethod["errors"] = nErrors;
-        joMethod["exceptions"] = nExceptions;
-        joMethod["bytes_recv"] = nBytesRecv;
-        joMethod["bytes_sent"] = nBytesSent;
-        jo[strMethodName] = joMethod;
+        joMethod["cps"] = record.lfCps;
+        joMethod["aps"] = record.lfAps;
+        joMethod["erps"] = record.lfErps;
+        joMethod["exps"] = record.lfExps;
+        joMethod["bps_recv"] = record.lfBpsRecv;
+        joMethod["bps_sent"] = record.lfBpsSent;
+        joMethod["calls"] = c.nCalls;
+        joMethod["answers"] = c.nAnswers;
+        joMethod["errors"] = c.nErrors;
+        joMethod["exceptions"] = c.nExceptions;
+        joMethod["bytes_recv"] = c.nBytesRecv;
+        joMethod["bytes_sent"] = c.nBytesSent;
+        jo[record.strMethodName] = joMethod;
     }
     return jo;
 }
 
+// RPC latency histograms of the metrics registry, cached per thread. Methods are labelled
+// by SkaleServerOverride::metricsMethodLabel(), so the cache is limited by count of known ones
+static void observe_rpc_duration(
+    const char* strProtocol, const std::string& strMethod, double lfSeconds ) {
+    thread_local std::unordered_map< std::string, dev::metrics::Histogram* > mapCache;
+    thread_local std::string strKey;
+    strKey.assign( strProtocol );
+    strKey += '\t';
+    strKey += strMethod;
+    auto itFind = mapCache.find( strKey );
+    if ( itFind == mapCache.end() ) {
+        dev::metrics::Histogram& histogram = dev::metrics::Registry::instance().histogram(
+            "skaled_rpc_duration_seconds", "Duration of JSON RPC calls",
+            { { "protocol", strProtocol }, { "method", strMethod } } );
+        itFind = mapCache.emplace( strKey, &histogram ).first;
+    }
+    itFind->second->observe( lfSeconds );
+}
+
 };  // namespace stats
 
 
@@ -740,6 +708,7 @@ void SkaleWsPeer::onPeerRegister() {
 }
 void SkaleWsPeer::onPeerUnregister() {  // peer will no longer receive onMessage after call to
                                         // this
+    isUnregistered_ = true;
     m_pSSCTH.reset();
     SkaleServerOverride* pSO = pso();
     if ( pSO->opts_.isTraceCalls_ )
@@ -884,16 +853,17 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
     }  // switch( ehldr )
     //
     // WS-processing-lambda
-    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO,
-                                     isBatch]() -> void {  // WS-processing-lambda
-        nlohmann::json jarrBatchAnswer;
-        if ( isBatch )
-            jarrBatchAnswer = nlohmann::json::array();
+    // single request is dispatched as received, only batch items need to be re-serialized
+    std::string strSingleRequest = isBatch ? std::string() : msg;
+    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO, isBatch,
+                                     strSingleRequest]() -> void {  // WS-processing-lambda
+        std::string strBatchAnswer;
         for ( const nlohmann::json& joRequest : jarrRequest ) {
-            std::string strRequest = joRequest.dump();
+            std::string strRequest = isBatch ? joRequest.dump() : strSingleRequest;
             std::string strMethod =
                 skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
             nlohmann::json joID = joRequest["id"];
+            const std::string& strStatsMethod = pThis->statsMethodName( strMethod );
             //
             std::string strPerformanceQueueName =
                 skutils::tools::format( "rpc/%s/%zu/%s", pThis->getRelay().nfoGetSchemeUC().c_str(),
@@ -925,25 +895,28 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", nRequestSize );
                 stats::register_stats_message(
                     ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest );
-                stats::register_stats_message( "RPC", joRequest );
+                    strStatsMethod.c_str(), nRequestSize );
+                stats::register_stats_message( "RPC", strStatsMethod.c_str(), nRequestSize );
 
                 if ( !pThis.get_unconst()->handleWebSocketSpecificRequest(
-                         pThis->getRelay().esm_, joRequest, strResponse ) ) {
+                         pThis->getRelay().esm_, joRequest, strRequest, strResponse ) ) {
                     jsonrpc::IClientConnectionHandler* handler = pSO->GetHandler( "/" );
                     if ( handler == nullptr )
                         throw std::runtime_error( "No client connection handler found" );
-                    handler->HandleRequest( strRequest, strResponse );
+                    // a call waiting in the executor queue is dropped if the peer is gone
+                    pSO->implCallHandler( handler, strMethod, strRequest, strResponse,
+                        [pThis]() { return pThis->isUnregistered_.load(); } );
                 }
 
-                nlohmann::json joResponse = nlohmann::json::parse( strResponse );
                 stats::register_stats_answer(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
                 stats::register_stats_answer(
                     ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest, joResponse );
-                stats::register_stats_answer( "RPC", joRequest, joResponse );
-                a.set_json_out( joResponse );
+                    strStatsMethod.c_str(), strResponse.size() );
+                stats::register_stats_answer( "RPC", strStatsMethod.c_str(), strResponse.size() );
+                // response is parsed back only when performance tracking wants it
+                if ( !a.is_skipped() )
+                    a.set_json_out( nlohmann::json::parse( strResponse ) );
                 bPassed = true;
             } catch ( const std::exception& ex ) {
                 rttElement->setError();
@@ -966,7 +939,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
-                    stats::register_stats_exception( "RPC", strMethod.c_str() );
+                    stats::register_stats_exception( "RPC", strStatsMethod.c_str() );
                 }
                 a.set_json_err( joErrorResponce );
             } catch ( ... ) {
@@ -992,7 +965,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
-                    stats::register_stats_exception( "RPC", strMethod.c_str() );
+                    stats::register_stats_exception( "RPC", strStatsMethod.c_str() );
                 }
                 a.set_json_err( joErrorResponce );
             }
@@ -1006,8 +979,9 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                            pThis->desc() + cc::ws_tx( " <<< " ) +
                            pThis->implPreformatTrafficJsonMessage( strResponse, false ) );
             if ( isBatch ) {
-                nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
-                jarrBatchAnswer.push_back( joAnswerPart );
+                // answers are already serialized, batch answer is assembled as text
+                strBatchAnswer += strBatchAnswer.empty() ? "[" : ",";
+                strBatchAnswer += skutils::tools::trim_copy( strResponse );
             } else
                 pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
             if ( !bPassed )
@@ -1015,14 +989,16 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
             rttElement->stop();
             double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+            stats::observe_rpc_duration( pThis->getRelay().nfoGetSchemeUC().c_str(),
+                pSO->metricsMethodLabel( strMethod ), lfExecutionDuration );
             if ( lfExecutionDuration >= pSO->opts_.lfExecutionDurationMaxForPerformanceWarning_ )
                 pSO->logPerformanceWarning( lfExecutionDuration, -1,
                     pThis->getRelay().nfoGetSchemeUC().c_str(), pThis->getRelay().serverIndex(),
                     pThis->getRelay().esm_, pThis->getOrigin().c_str(), strMethod.c_str(), joID );
         }  // for( const nlohmann::json & joRequest : jarrRequest )
         if ( isBatch ) {
-            std::string strResponse = jarrBatchAnswer.dump();
-            pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
+            strBatchAnswer += strBatchAnswer.empty() ? "[]" : "]";
+            pThis.get_unconst()->sendMessage( strBatchAnswer );
         }
     };  // WS-processing-lambda
     skutils::dispatch::async( pThis->m_strPeerQueueID, fnAsyncMessageHandler );
@@ -1071,6 +1047,11 @@ SkaleServerOverride* SkaleWsPeer::pso() {
     SkaleServerOverride* pSO = getRelay().pso();
     return pSO;
 }
+const std::string& SkaleWsPeer::statsMethodName( const std::string& strMethod ) const {
+    if ( g_ws_rpc_map.count( strMethod ) )
+        return strMethod;
+    return pso()->statsMethodName( strMethod );
+}
 dev::eth::Interface* SkaleWsPeer::ethereum() const {
     const SkaleServerOverride* pSO = pso();
     return pSO->ethereum();
@@ -1117,14 +1098,15 @@ bool SkaleWsPeer::handleRequestWithBinaryAnswer(
             skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
         std::string s( buffer.begin(), buffer.end() );
         sendMessage( s, skutils::ws::opcv::binary );
-        stats::register_stats_answer( "RPC", strMethodName, buffer.size() );
+        stats::register_stats_answer(
+            "RPC", statsMethodName( strMethodName ).c_str(), buffer.size() );
         return true;
     }
     return false;
 }
 
-bool SkaleWsPeer::handleWebSocketSpecificRequest(
-    e_server_mode_t esm, const nlohmann::json& joRequest, std::string& strResponse ) {
+bool SkaleWsPeer::handleWebSocketSpecificRequest( e_server_mode_t esm,
+    const nlohmann::json& joRequest, const std::string& strRequest, std::string& strResponse ) {
     strResponse.clear();
     nlohmann::json joResponse = nlohmann::json::object();
     joResponse["jsonrpc"] = "2.0";
@@ -1132,38 +1114,18 @@ bool SkaleWsPeer::handleWebSocketSpecificRequest(
         joResponse["id"] = joRequest["id"];
     joResponse["result"] = nullptr;
 
-    rapidjson::Document joRequestRapidjson;
-    joRequestRapidjson.SetObject();
-    std::string strRequest = joRequest.dump();
-    joRequestRapidjson.Parse( strRequest.data() );
-
-    rapidjson::Document joResponseRapidjson;
-    joResponseRapidjson.SetObject();
-    std::string strResponseCopy = joResponse.dump();
-    joResponseRapidjson.Parse( strResponseCopy.data() );
-
     if ( handleWebSocketSpecificRequest( esm, joRequest, joResponse ) ) {
         strResponse = joResponse.dump();
         return true;
     }
 
-    bool isSkipProtocolSpecfic = false;
     std::string strMethod = joRequest["method"].get< std::string >();
 
     if ( esm == e_server_mode_t::esm_informational && strMethod == "eth_getBalance" )
-        isSkipProtocolSpecfic = true;
-
-    if ( ( !isSkipProtocolSpecfic ) && pso()->handleProtocolSpecificRequest( getRemoteIp(),
-                                           joRequestRapidjson, joResponseRapidjson ) ) {
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer< rapidjson::StringBuffer > writer( buffer );
-        joResponseRapidjson.Accept( writer );
-        strResponse = buffer.GetString();
-
-        return true;
-    }
+        return false;
 
-    return false;
+    return pso()->handleProtocolSpecificRequest(
+        getRemoteIp(), strMethod, strRequest, strResponse );
 }
 
 bool SkaleWsPeer::handleWebSocketSpecificRequest(
@@ -1262,88 +1224,73 @@ void SkaleWsPeer::eth_subscribe_logs(
             skutils::dispatch::async( "logs-rethread", [=]() -> void {
                 skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw]() -> void {
                     dev::eth::LocalisedLogEntries le = pThis->ethereum()->checkWatch( iw );
-                    nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
-
-                    if ( !joResult.is_array() )
-                        throw std::runtime_error( "Log entries should be array" );
-                    for ( const auto& joRW : joResult ) {
-                        if ( joRW.count( "logs" ) > 0 && joRW.count( "blockHash" ) > 0 &&
-                             joRW.count( "blockNumber" ) > 0 ) {
-                            const std::string strBlockHash = joRW["blockHash"].get< std::string >();
-                            std::string strBlockNumber = joRW["blockNumber"].get< std::string >();
-                            const nlohmann::json& joResultLogs = joRW["logs"];
-                            if ( !joResultLogs.is_array() )
-                                throw std::runtime_error( "Result logs should be array" );
-                            for ( const auto& joWalk : joResultLogs ) {
-                                if ( !joWalk.is_object() )
-                                    continue;
-                                nlohmann::json joLog = joWalk;  // copy
-                                joLog["blockHash"] = strBlockHash;
-                                joLog["blockNumber"] = strBlockNumber;
-                                nlohmann::json joParams = nlohmann::json::object();
-                                joParams["subscription"] = dev::toJS( iw );
-                                joParams["result"] = joLog;
-                                nlohmann::json joNotification = nlohmann::json::object();
-                                joNotification["jsonrpc"] = "2.0";
-                                joNotification["method"] = "eth_subscription";
-                                joNotification["params"] = joParams;
-                                std::string strNotification = joNotification.dump();
-                                const SkaleServerOverride* pSO = pThis->pso();
-                                if ( pSO->opts_.isTraceCalls_ )
-                                    clog( dev::VerbosityDebug,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::ws_tx_inv( " <<< " +
-                                                           pThis->getRelay().nfoGetSchemeUC() +
-                                                           "/TX <<< " ) )
-                                        << ( pThis->desc() + cc::ws_tx( " <<< " ) +
-                                               pThis->implPreformatTrafficJsonMessage(
-                                                   strNotification, false ) );
-                                bool bMessageSentOK = false;
-                                try {
-                                    bMessageSentOK = const_cast< SkaleWsPeer* >( pThis.get() )
-                                                         ->sendMessage( skutils::tools::trim_copy(
-                                                             strNotification ) );
-                                    if ( !bMessageSentOK )
-                                        throw std::runtime_error(
-                                            "eth_subscription/logs failed to sent "
-                                            "message" );
-                                    stats::register_stats_answer(
-                                        ( std::string( "RPC/" ) +
-                                            pThis->getRelay().nfoGetSchemeUC() )
-                                            .c_str(),
-                                        "eth_subscription/logs", strNotification.size() );
-                                    stats::register_stats_answer(
-                                        "RPC", "eth_subscription/logs", strNotification.size() );
-                                } catch ( std::exception& ex ) {
-                                    clog( dev::Verbosity::VerbosityError,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::debug( "/" ) +
-                                            cc::num10( pThis->getRelay().serverIndex() ) )
-                                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                                               cc::warn( "eth_subscription/logs" ) +
-                                               cc::error( " will uninstall watcher callback "
-                                                          "because of exception: " ) +
-                                               cc::warn( ex.what() ) );
-                                } catch ( ... ) {
-                                    clog( dev::Verbosity::VerbosityError,
-                                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                            cc::debug( "/" ) +
-                                            cc::num10( pThis->getRelay().serverIndex() ) )
-                                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                                               cc::warn( "eth_subscription/logs" ) +
-                                               cc::error( " will uninstall watcher callback "
-                                                          "because of unknown exception" ) );
-                                }
-                                if ( !bMessageSentOK ) {
-                                    stats::register_stats_error(
-                                        ( std::string( "RPC/" ) +
-                                            pThis->getRelay().nfoGetSchemeUC() )
-                                            .c_str(),
-                                        "eth_subscription/logs" );
-                                    stats::register_stats_error( "RPC", "eth_subscription/logs" );
-                                    pThis->ethereum()->uninstallWatch( iw );
-                                }
-                            }
+                    const std::string strSubscription = dev::toJS( iw );
+                    for ( const dev::eth::LocalisedLogEntry& e : le ) {
+                        // only mined logs are notified
+                        if ( e.isSpecial || !e.mined )
+                            continue;
+                        const std::string strKey = "logs/" + e.blockHash.hex() + "/" +
+                                                   e.transactionHash.hex() + "/" +
+                                                   std::to_string( e.logIndex );
+                        auto pResult = skale::server::helper::shared_result_cache::instance().get(
+                            strKey, [&e]() -> std::string {
+                                nlohmann::json joLog =
+                                    skale::server::helper::log_entry_to_json( e );
+                                joLog["blockHash"] = dev::toJS( e.blockHash );
+                                joLog["blockNumber"] =
+                                    skale::server::helper::nljsBlockNumber( e.blockNumber );
+                                return joLog.dump();
+                            } );
+                        std::string strNotification =
+                            skale::server::helper::make_subscription_notification(
+                                strSubscription, *pResult );
+                        const SkaleServerOverride* pSO = pThis->pso();
+                        if ( pSO->opts_.isTraceCalls_ )
+                            clog( dev::VerbosityDebug,
+                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
+                                    cc::ws_tx_inv( " <<< " + pThis->getRelay().nfoGetSchemeUC() +
+                                                   "/TX <<< " ) )
+                                << ( pThis->desc() + cc::ws_tx( " <<< " ) +
+                                       pThis->implPreformatTrafficJsonMessage(
+                                           strNotification, false ) );
+                        bool bMessageSentOK = false;
+                        try {
+                            bMessageSentOK = const_cast< SkaleWsPeer* >( pThis.get() )
+                                                 ->sendMessage( strNotification );
+                            if ( !bMessageSentOK )
+                                throw std::runtime_error(
+                                    "eth_subscription/logs failed to sent message" );
+                            stats::register_stats_answer(
+                                ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() )
+                                    .c_str(),
+                                "eth_subscription/logs", strNotification.size() );
+                            stats::register_stats_answer(
+                                "RPC", "eth_subscription/logs", strNotification.size() );
+                        } catch ( std::exception& ex ) {
+                            clog( dev::Verbosity::VerbosityError,
+                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
+                                    cc::num10( pThis->getRelay().serverIndex() ) )
+                                << ( pThis->desc() + " " + cc::error( "error in " ) +
+                                       cc::warn( "eth_subscription/logs" ) +
+                                       cc::error( " will uninstall watcher callback because of "
+                                                  "exception: " ) +
+                                       cc::warn( ex.what() ) );
+                        } catch ( ... ) {
+                            clog( dev::Verbosity::VerbosityError,
+                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
+                                    cc::num10( pThis->getRelay().serverIndex() ) )
+                                << ( pThis->desc() + " " + cc::error( "error in " ) +
+                                       cc::warn( "eth_subscription/logs" ) +
+                                       cc::error( " will uninstall watcher callback because of "
+                                                  "unknown exception" ) );
+                        }
+                        if ( !bMessageSentOK ) {
+                            stats::register_stats_error(
+                                ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() )
+                                    .c_str(),
+                                "eth_subscription/logs" );
+                            stats::register_stats_error( "RPC", "eth_subscription/logs" );
+                            pThis->ethereum()->uninstallWatch( iw );
                         }
                     }
                 } );
@@ -1400,15 +1347,9 @@ void SkaleWsPeer::eth_subscribe_newPendingTransactions(
                 const SkaleServerOverride* pSO = pThis->pso();
                 dev::h256 h = t.sha3();
                 //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] =
-                    dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION );
-                joParams["result"] = dev::toJS( h );  // h.hex()
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
+                std::string strNotification = skale::server::helper::make_subscription_notification(
+                    dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION ),
+                    "\"" + dev::toJS( h ) + "\"" );
                 if ( pSO->opts_.isTraceCalls_ )
                     clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
                         << ( cc::ws_tx_inv(
@@ -1418,8 +1359,7 @@ void SkaleWsPeer::eth_subscribe_newPendingTransactions(
                 bool bMessageSentOK = false;
                 try {
                     bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
+                        const_cast< SkaleWsPeer* >( pThis.get() )->sendMessage( strNotification );
                     if ( !bMessageSentOK )
                         throw std::runtime_error(
                             "eth_subscription/newPendingTransactions failed to sent message" );
@@ -1511,28 +1451,32 @@ void SkaleWsPeer::eth_subscribe_newHeads( e_server_mode_t /*esm*/,
             skutils::dispatch::async( [pThis, iw, block, bIncludeTransactions]() -> void {
                 const SkaleServerOverride* pSO = pThis->pso();
                 dev::h256 h = block.info().hash();
-                Json::Value jv;
-                if ( bIncludeTransactions )
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactions( h ), pThis->ethereum()->sealEngine() );
-                else
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactionHashes( h ),
-                        pThis->ethereum()->sealEngine() );
-                Json::FastWriter fastWriter;
-                std::string s = fastWriter.write( jv );
-                nlohmann::json joBlockDescription = nlohmann::json::parse( s );
+                // block description is the same for all subscribers, it is made by the first one
+                const std::string strKey =
+                    "newHeads/" + h.hex() + ( bIncludeTransactions ? "/full" : "" );
+                auto pResult = skale::server::helper::shared_result_cache::instance().get(
+                    strKey, [&pThis, &h, bIncludeTransactions]() -> std::string {
+                        Json::Value jv;
+                        if ( bIncludeTransactions )
+                            jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
+                                pThis->ethereum()->blockDetails( h ),
+                                pThis->ethereum()->uncleHashes( h ),
+                                pThis->ethereum()->transactions( h ),
+                                pThis->ethereum()->sealEngine() );
+                        else
+                            jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
+                                pThis->ethereum()->blockDetails( h ),
+                                pThis->ethereum()->uncleHashes( h ),
+                                pThis->ethereum()->transactionHashes( h ),
+                                pThis->ethereum()->sealEngine() );
+                        Json::FastWriter fastWriter;
+                        std::string s = fastWriter.write( jv );
+                        // re-dumped to keep formatting of notifications unchanged
+                        return nlohmann::json::parse( s ).dump();
+                    } );
                 //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] = dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK );
-                joParams["result"] = joBlockDescription;
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
+                std::string strNotification = skale::server::helper::make_subscription_notification(
+                    dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK ), *pResult );
                 if ( pSO->opts_.isTraceCalls_ )
                     clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
                         << ( cc::ws_tx_inv(
@@ -1544,8 +1488,7 @@ void SkaleWsPeer::eth_subscribe_newHeads( e_server_mode_t /*esm*/,
                 bool bMessageSentOK = false;
                 try {
                     bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
+                        const_cast< SkaleWsPeer* >( pThis.get() )->sendMessage( strNotification );
                     if ( !bMessageSentOK )
                         throw std::runtime_error(
                             "eth_subscription/newHeads failed to sent message" );
@@ -2155,6 +2098,36 @@ bool SkaleServerOverride::checkAdminOriginAllowed( const std::string& origin ) c
     return chainParams().checkAdminOriginAllowed( origin );
 }
 
+const std::string& SkaleServerOverride::metricsMethodLabel( const std::string& strMethod ) const {
+    static const std::string g_strOther( "other" );
+    if ( opts_.setKnownMethods_.count( strMethod ) )
+        return strMethod;
+    return g_strOther;
+}
+
+const std::string& SkaleServerOverride::statsMethodName( const std::string& strMethod ) const {
+    static const std::string g_strOther( "<other>" );
+    if ( opts_.setKnownMethods_.count( strMethod ) || g_protocol_rpc_map.count( strMethod ) ||
+         g_informational_rpc_map.count( strMethod ) || g_http_rpc_map.count( strMethod ) )
+        return strMethod;
+    return g_strOther;
+}
+
+void SkaleServerOverride::implCallHandler( jsonrpc::IClientConnectionHandler* handler,
+    const std::string& strMethod, const std::string& strRequest, std::string& strResponse,
+    std::function< bool() > fnIsCancelled ) {
+    if ( !rpcExecutor_ || !rpcExecutor_->handles( strMethod ) ) {
+        handler->HandleRequest( strRequest, strResponse );
+        return;
+    }
+    skale::RpcExecutor::Status status = rpcExecutor_->run(
+        strMethod, [&]() { handler->HandleRequest( strRequest, strResponse ); },
+        fnIsCancelled );
+    if ( status != skale::RpcExecutor::Status::Done )
+        throw std::runtime_error( std::string( "server too busy, call " ) +
+                                  skale::RpcExecutor::statusToString( status ) );
+}
+
 jsonrpc::IClientConnectionHandler* SkaleServerOverride::GetHandler( const std::string& url ) {
     if ( jsonrpc::AbstractServerConnector::GetHandler() != nullptr )
         return AbstractServerConnector::GetHandler();
@@ -2308,8 +2281,8 @@ string hostname_to_ip( string hostname ) {
 }
 
 skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
-    const nlohmann::json& joIn, const std::string& strProtocol, int nServerIndex,
-    std::string strOrigin, int ipVer, int nPort, e_server_mode_t esm ) {
+    const nlohmann::json& joIn, const std::string& strBody, const std::string& strProtocol,
+    int nServerIndex, std::string strOrigin, int ipVer, int nPort, e_server_mode_t esm ) {
     skutils::result_of_http_request rslt;
     rslt.isBinary_ = false;
     std::string strMethod;
@@ -2383,135 +2356,189 @@ skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequest(
     }  // switch( ehldr )
     //
     //
-    nlohmann::json jarrBatchAnswer;
-    if ( isBatch )
-        jarrBatchAnswer = nlohmann::json::array();
-    for ( const nlohmann::json& joRequest : jarrRequest ) {
-        std::string strBody = joRequest.dump();  // = req.body_;
-        std::string strPerformanceQueueName =
-            skutils::tools::format( "rpc/%s/%zu", strProtocol.c_str(), nServerIndex );
-        std::string strPerformanceActionName = skutils::tools::format(
-            "%s task %zu, %s", strProtocol.c_str(), nTaskNumberCall_++, strMethod.c_str() );
-        skutils::task::performance::action a( strPerformanceQueueName, strPerformanceActionName );
-        //
-        skutils::stats::time_tracker::element_ptr_t rttElement;
-        rttElement.emplace( "RPC", strProtocol.c_str(), strMethod.c_str(), nServerIndex, ipVer );
-        //
-        SkaleServerConnectionsTrackHelper sscth( *this );
-        if ( methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
-            logTraceServerTraffic( true, methodTraceVerbosity( strMethod ), ipVer,
-                strProtocol.c_str(), nServerIndex, esm, strOrigin.c_str(),
-                implPreformatTrafficJsonMessage( strBody, true ) );
-        std::string strResponse;
-        bool bPassed = false;
-        try {
-            if ( is_connection_limit_overflow() ) {
-                on_connection_overflow_peer_closed(
-                    ipVer, strProtocol.c_str(), nServerIndex, nPort, esm );
-                throw std::runtime_error( "server too busy" );
-            }
-            strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
-            if ( !handleAdminOriginFilter( strMethod, strOrigin ) ) {
-                throw std::runtime_error( "origin not allowed for call attempt" );
-            }
-            jsonrpc::IClientConnectionHandler* handler = GetHandler( "/" );
-            if ( handler == nullptr )
-                throw std::runtime_error( "No client connection handler found" );
-            //
-            stats::register_stats_message( strProtocol.c_str(), "POST", strBody.size() );
-            stats::register_stats_message( ( "RPC/" + strProtocol ).c_str(), joRequest );
-            stats::register_stats_message( "RPC", joRequest );
-            //
-            std::vector< uint8_t > buffer;
-            if ( handleRequestWithBinaryAnswer( esm, joRequest, buffer ) ) {
-                stats::register_stats_answer( strProtocol.c_str(), "POST", buffer.size() );
-                rttElement->stop();
-                rslt.isBinary_ = true;
-                rslt.vecBytes_ = buffer;
-                return rslt;
-            }
-            if ( !handleHttpSpecificRequest( strOrigin, esm, strBody, strResponse ) ) {
-                handler->HandleRequest( strBody.c_str(), strResponse );
-            }
-            //
-            stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
-            nlohmann::json joResponse = nlohmann::json::parse( strResponse );
-            stats::register_stats_answer( ( "RPC/" + strProtocol ).c_str(), joRequest, joResponse );
-            stats::register_stats_answer( "RPC", joRequest, joResponse );
-            //
-            if ( !isBatch ) {
-                rslt.isBinary_ = false;
-                rslt.joOut_ = nlohmann::json::parse( strResponse );
-            }
-            a.set_json_out( joResponse );
-            bPassed = true;
-        } catch ( const std::exception& ex ) {
-            rttElement->setError();
-            logTraceServerTraffic( false, dev::VerbosityError, ipVer, strProtocol.c_str(),
-                nServerIndex, esm, strOrigin.c_str(), cc::warn( ex.what() ) );
-            nlohmann::json joErrorResponce;
-            joErrorResponce["id"] = joID;
-            nlohmann::json joErrorObj;
-            joErrorObj["code"] = -32000;
-            joErrorObj["message"] = std::string( ex.what() );
-            joErrorResponce["error"] = joErrorObj;
-            strResponse = joErrorResponce.dump();
-            stats::register_stats_exception( strProtocol.c_str(), "POST" );
-            if ( !strMethod.empty() ) {
-                stats::register_stats_exception( strProtocol.c_str(), strMethod.c_str() );
-                stats::register_stats_exception( "RPC", strMethod.c_str() );
-            }
-            if ( !isBatch ) {
-                rslt.isBinary_ = false;
-                rslt.joOut_ = joErrorResponce;
-            }
-            a.set_json_err( joErrorResponce );
-        } catch ( ... ) {
-            rttElement->setError();
-            const char* e = "unknown exception in SkaleServerOverride";
-            logTraceServerTraffic( false, dev::VerbosityError, ipVer, strProtocol.c_str(),
-                nServerIndex, esm, strOrigin.c_str(), cc::warn( e ) );
-            nlohmann::json joErrorResponce;
-            joErrorResponce["id"] = joID;
-            nlohmann::json joErrorObj;
-            joErrorObj["code"] = -32000;
-            joErrorObj["message"] = std::string( e );
-            joErrorResponce["error"] = joErrorObj;
-            strResponse = joErrorResponce.dump();
-            stats::register_stats_exception( strProtocol.c_str(), "POST" );
-            if ( !strMethod.empty() ) {
-                stats::register_stats_exception( strProtocol.c_str(), strMethod.c_str() );
-                stats::register_stats_exception( "RPC", strMethod.c_str() );
-            }
-            if ( !isBatch ) {
-                rslt.isBinary_ = false;
-                rslt.joOut_ = joErrorResponce;
+    // single request is dispatched as received, only batch items need to be re-serialized
+    if ( !isBatch )
+        return implHandleHttpRequestItem(
+            jarrRequest[0], strBody, strProtocol, nServerIndex, strOrigin, ipVer, nPort, esm );
+    //
+    // batch items are independent, they are handled by this thread together with jobs on the
+    // dispatch thread pool. At most maxParallelismInBatchJsonRpcRequest_ items of one batch
+    // are in flight, so that a single client cannot occupy the whole pool
+    struct batch_state_t {
+        nlohmann::json jarrRequest;
+        std::vector< skutils::result_of_http_request > vecAnswers;
+        std::atomic_size_t nNextIndex = 0;
+        size_t cntDone = 0;
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+    auto pState = std::make_shared< batch_state_t >();
+    const size_t cntInBatch = jarrRequest.size();
+    pState->jarrRequest = std::move( jarrRequest );
+    pState->vecAnswers.resize( cntInBatch );
+    // jobs that start after the whole batch is done only look at nNextIndex
+    auto fnBatchWorker = [this, pState, cntInBatch, strProtocol, nServerIndex, strOrigin, ipVer,
+                             nPort, esm]() -> void {
+        for ( size_t i = pState->nNextIndex++; i < cntInBatch; i = pState->nNextIndex++ ) {
+            try {
+                pState->vecAnswers[i] = implHandleHttpRequestItem( pState->jarrRequest[i],
+                    pState->jarrRequest[i].dump(), strProtocol, nServerIndex, strOrigin, ipVer,
+                    nPort, esm );
+            } catch ( ... ) {
+                // item must always be answered, otherwise the batch would never complete
+                pState->vecAnswers[i].isBinary_ = false;
+                pState->vecAnswers[i].strOut_ =
+                    skutils::http_pg::server_side_request_handler::answer_from_error_text(
+                        "internal error",
+                        pState->jarrRequest[i].value( "id", nlohmann::json( "-1" ) ) );
             }
-            a.set_json_err( joErrorResponce );
+            std::lock_guard< std::mutex > lock( pState->mtx );
+            if ( ++pState->cntDone == cntInBatch )
+                pState->cv.notify_all();
         }
-        if ( methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
-            logTraceServerTraffic( false, methodTraceVerbosity( strMethod ), ipVer,
-                strProtocol.c_str(), nServerIndex, esm, strOrigin.c_str(),
-                implPreformatTrafficJsonMessage( strResponse, false ) );
-        if ( isBatch ) {
-            nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
-            jarrBatchAnswer.push_back( joAnswerPart );
-        } else {
-            rslt.isBinary_ = false;
-            rslt.joOut_ = nlohmann::json::parse( strResponse );
+    };
+    size_t cntParallel = std::min( cntInBatch, maxParallelismInBatchJsonRpcRequest_ );
+    for ( size_t i = 1; i < cntParallel; ++i ) {
+        try {
+            skutils::dispatch::async( fnBatchWorker );
+        } catch ( ... ) {
+            break;  // remaining items will be handled by this thread
         }
-        if ( !bPassed )
-            stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
-        rttElement->stop();
-        double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
-        if ( lfExecutionDuration >= opts_.lfExecutionDurationMaxForPerformanceWarning_ )
-            logPerformanceWarning( lfExecutionDuration, ipVer, strProtocol.c_str(), nServerIndex,
-                esm, strOrigin.c_str(), strMethod.c_str(), joID );
-    }  // for( const nlohmann::json & joRequest : jarrRequest )
-    if ( isBatch ) {
-        rslt.isBinary_ = false;  // batch request can be only text/JSON
-        rslt.joOut_ = jarrBatchAnswer;
     }
+    fnBatchWorker();
+    {
+        std::unique_lock< std::mutex > lock( pState->mtx );
+        pState->cv.wait( lock, [&]() { return pState->cntDone == cntInBatch; } );
+    }
+    //
+    std::string strBatchAnswer;
+    for ( skutils::result_of_http_request& rsltItem : pState->vecAnswers ) {
+        if ( rsltItem.isBinary_ )
+            return rsltItem;
+        // answers are sent as serialized by the handlers, batch answer is assembled as text
+        strBatchAnswer += strBatchAnswer.empty() ? "[" : ",";
+        strBatchAnswer += rsltItem.strOut_;
+    }
+    rslt.isBinary_ = false;  // batch request can be only text/JSON
+    rslt.strOut_ = strBatchAnswer.empty() ? "[]" : strBatchAnswer + "]";
+    return rslt;
+}
+
+skutils::result_of_http_request SkaleServerOverride::implHandleHttpRequestItem(
+    const nlohmann::json& joRequest, const std::string& strBody, const std::string& strProtocol,
+    int nServerIndex, const std::string& strOrigin, int ipVer, int nPort, e_server_mode_t esm ) {
+    skutils::result_of_http_request rslt;
+    rslt.isBinary_ = false;
+    std::string strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+    nlohmann::json joID = joRequest.count( "id" ) > 0 ? joRequest["id"] : nlohmann::json( "-1" );
+    const std::string& strStatsMethod = statsMethodName( strMethod );
+    std::string strPerformanceQueueName =
+        skutils::tools::format( "rpc/%s/%zu", strProtocol.c_str(), nServerIndex );
+    std::string strPerformanceActionName = skutils::tools::format(
+        "%s task %zu, %s", strProtocol.c_str(), nTaskNumberCall_++, strMethod.c_str() );
+    skutils::task::performance::action a( strPerformanceQueueName, strPerformanceActionName );
+    //
+    skutils::stats::time_tracker::element_ptr_t rttElement;
+    rttElement.emplace( "RPC", strProtocol.c_str(), strMethod.c_str(), nServerIndex, ipVer );
+    //
+    SkaleServerConnectionsTrackHelper sscth( *this );
+    if ( methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
+        logTraceServerTraffic( true, methodTraceVerbosity( strMethod ), ipVer,
+            strProtocol.c_str(), nServerIndex, esm, strOrigin.c_str(),
+            implPreformatTrafficJsonMessage( strBody, true ) );
+    std::string strResponse;
+    bool bPassed = false;
+    try {
+        if ( is_connection_limit_overflow() ) {
+            on_connection_overflow_peer_closed(
+                ipVer, strProtocol.c_str(), nServerIndex, nPort, esm );
+            throw std::runtime_error( "server too busy" );
+        }
+        if ( !handleAdminOriginFilter( strMethod, strOrigin ) ) {
+            throw std::runtime_error( "origin not allowed for call attempt" );
+        }
+        jsonrpc::IClientConnectionHandler* handler = GetHandler( "/" );
+        if ( handler == nullptr )
+            throw std::runtime_error( "No client connection handler found" );
+        //
+        stats::register_stats_message( strProtocol.c_str(), "POST", strBody.size() );
+        stats::register_stats_message(
+            ( "RPC/" + strProtocol ).c_str(), strStatsMethod.c_str(), strBody.size() );
+        stats::register_stats_message( "RPC", strStatsMethod.c_str(), strBody.size() );
+        //
+        std::vector< uint8_t > buffer;
+        if ( handleRequestWithBinaryAnswer( esm, joRequest, buffer ) ) {
+            stats::register_stats_answer( strProtocol.c_str(), "POST", buffer.size() );
+            rttElement->stop();
+            rslt.isBinary_ = true;
+            rslt.vecBytes_ = buffer;
+            return rslt;
+        }
+        if ( !handleHttpSpecificRequest(
+                 strOrigin, esm, strMethod, joRequest, strBody, strResponse ) ) {
+            implCallHandler( handler, strMethod, strBody, strResponse );
+        }
+        //
+        stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
+        stats::register_stats_answer(
+            ( "RPC/" + strProtocol ).c_str(), strStatsMethod.c_str(), strResponse.size() );
+        stats::register_stats_answer( "RPC", strStatsMethod.c_str(), strResponse.size() );
+        //
+        // response is parsed back only when performance tracking wants it
+        if ( !a.is_skipped() )
+            a.set_json_out( nlohmann::json::parse( strResponse ) );
+        bPassed = true;
+    } catch ( const std::exception& ex ) {
+        rttElement->setError();
+        logTraceServerTraffic( false, dev::VerbosityError, ipVer, strProtocol.c_str(),
+            nServerIndex, esm, strOrigin.c_str(), cc::warn( ex.what() ) );
+        nlohmann::json joErrorResponce;
+        joErrorResponce["id"] = joID;
+        nlohmann::json joErrorObj;
+        joErrorObj["code"] = -32000;
+        joErrorObj["message"] = std::string( ex.what() );
+        joErrorResponce["error"] = joErrorObj;
+        strResponse = joErrorResponce.dump();
+        stats::register_stats_exception( strProtocol.c_str(), "POST" );
+        if ( !strMethod.empty() ) {
+            stats::register_stats_exception( strProtocol.c_str(), strStatsMethod.c_str() );
+            stats::register_stats_exception( "RPC", strStatsMethod.c_str() );
+        }
+        a.set_json_err( joErrorResponce );
+    } catch ( ... ) {
+        rttElement->setError();
+        const char* e = "unknown exception in SkaleServerOverride";
+        logTraceServerTraffic( false, dev::VerbosityError, ipVer, strProtocol.c_str(),
+            nServerIndex, esm, strOrigin.c_str(), cc::warn( e ) );
+        nlohmann::json joErrorResponce;
+        joErrorResponce["id"] = joID;
+        nlohmann::json joErrorObj;
+        joErrorObj["code"] = -32000;
+        joErrorObj["message"] = std::string( e );
+        joErrorResponce["error"] = joErrorObj;
+        strResponse = joErrorResponce.dump();
+        stats::register_stats_exception( strProtocol.c_str(), "POST" );
+        if ( !strMethod.empty() ) {
+            stats::register_stats_exception( strProtocol.c_str(), strStatsMethod.c_str() );
+            stats::register_stats_exception( "RPC", strStatsMethod.c_str() );
+        }
+        a.set_json_err( joErrorResponce );
+    }
+    if ( methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
+        logTraceServerTraffic( false, methodTraceVerbosity( strMethod ), ipVer,
+            strProtocol.c_str(), nServerIndex, esm, strOrigin.c_str(),
+            implPreformatTrafficJsonMessage( strResponse, false ) );
+    // answer is sent as serialized by the handler
+    rslt.strOut_ = strResponse;
+    if ( !bPassed )
+        stats::register_stats_answer( strProtocol.c_str(), "POST", strResponse.size() );
+    rttElement->stop();
+    double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+    stats::observe_rpc_duration(
+        strProtocol.c_str(), metricsMethodLabel( strMethod ), lfExecutionDuration );
+    if ( lfExecutionDuration >= opts_.lfExecutionDurationMaxForPerformanceWarning_ )
+        logPerformanceWarning( lfExecutionDuration, ipVer, strProtocol.c_str(), nServerIndex,
+            esm, strOrigin.c_str(), strMethod.c_str(), joID );
     return rslt;
 }
 
@@ -2872,8 +2899,8 @@ bool SkaleServerOverride::StartListening() {
          StartListening( e_server_mode_t::esm_informational ) ) {
         if ( skutils::http_pg::pg_accumulate_size() > 0 ) {
             skutils::http_pg::pg_on_request_handler_t fnHandler =
-                [=]( const nlohmann::json& joIn, const std::string& strOrigin, int ipVer,
-                    const std::string& strDstAddress,
+                [=]( const nlohmann::json& joIn, const std::string& strBody,
+                    const std::string& strOrigin, int ipVer, const std::string& strDstAddress,
                     int nDstPort ) -> skutils::result_of_http_request {
                 if ( isShutdownMode() )
                     throw std::runtime_error( "query was cancelled due to server shutdown mode" );
@@ -2892,7 +2919,7 @@ bool SkaleServerOverride::StartListening() {
                 int nServerIndex = 0;  // TO-FIX: detect server index here"
                 e_server_mode_t esm = implGuessProxygenRequestESM( strDstAddress, nDstPort );
                 skutils::result_of_http_request rslt = implHandleHttpRequest(
-                    joIn, strSchemeUC, nServerIndex, strOrigin, ipVer, nPort, esm );
+                    joIn, strBody, strSchemeUC, nServerIndex, strOrigin, ipVer, nPort, esm );
                 return rslt;
             };
             hProxygenServer_ =
@@ -3315,6 +3342,36 @@ bool SkaleServerOverride::handleProtocolSpecificRequest( const std::string& strO
     return true;
 }
 
+// methods without a protocol specific implementation are routed by name, so that only
+// requests that are really handled here are parsed by rapidjson
+bool SkaleServerOverride::handleProtocolSpecificRequest( const std::string& strOrigin,
+    const std::string& strMethod, const std::string& strRequest, std::string& strResponse ) {
+    if ( g_protocol_rpc_map.count( strMethod ) == 0 )
+        return false;
+    rapidjson::Document joRequest;
+    joRequest.Parse( strRequest.data(), strRequest.size() );
+    if ( joRequest.HasParseError() || !joRequest.IsObject() )
+        return false;
+    rapidjson::Document joResponse;
+    joResponse.SetObject();
+    joResponse.AddMember( "jsonrpc", "2.0", joResponse.GetAllocator() );
+    if ( joRequest.HasMember( "id" ) ) {
+        rapidjson::Value joID;
+        joID.CopyFrom( joRequest["id"], joResponse.GetAllocator() );
+        joResponse.AddMember( "id", joID, joResponse.GetAllocator() );
+    }
+    rapidjson::Value d;
+    d.SetObject();
+    joResponse.AddMember( "result", d, joResponse.GetAllocator() );
+    if ( !handleProtocolSpecificRequest( strOrigin, joRequest, joResponse ) )
+        return false;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer< rapidjson::StringBuffer > writer( buffer );
+    joResponse.Accept( writer );
+    strResponse.assign( buffer.GetString(), buffer.GetSize() );
+    return true;
+}
+
 const SkaleServerOverride::protocol_rpc_map_t SkaleServerOverride::g_protocol_rpc_map = {
     { "setSchainExitTime", &SkaleServerOverride::setSchainExitTime },
     { "eth_sendRawTransaction", &SkaleServerOverride::eth_sendRawTransaction },
@@ -3484,46 +3541,22 @@ void SkaleServerOverride::eth_getCode( const std::string& /*strOrigin*/,
 }
 
 bool SkaleServerOverride::handleHttpSpecificRequest( const std::string& strOrigin,
-    e_server_mode_t esm, const std::string& strRequest, std::string& strResponse ) {
+    e_server_mode_t esm, const std::string& strMethod, const nlohmann::json& joRequest,
+    const std::string& strRequest, std::string& strResponse ) {
     strResponse.clear();
-    rapidjson::Document joRequest;
-    joRequest.SetObject();
-    try {
-        joRequest.Parse( strRequest.data() );
-    } catch ( ... ) {
-        return false;
-    }
-    rapidjson::Document joResponse;
-    joResponse.SetObject();
-    joResponse.AddMember( "jsonrpc", "2.0", joResponse.GetAllocator() );
-    if ( joRequest.HasMember( "id" ) ) {
-        joResponse.AddMember( "id", rapidjson::Value(), joResponse.GetAllocator() );
-        joResponse["id"] = joRequest["id"];
-    }
-    rapidjson::Value d;
-    d.SetObject();
-    joResponse.AddMember( "result", d, joResponse.GetAllocator() );
-
-
-    rapidjson::StringBuffer bufferResponse;
-    rapidjson::Writer< rapidjson::StringBuffer > writerResponse( bufferResponse );
-    joResponse.Accept( writerResponse );
-    std::string strResponseCopy = bufferResponse.GetString();
-    nlohmann::json joResponseObj = nlohmann::json::parse( strResponseCopy );
-    nlohmann::json objRequest = nlohmann::json::parse( strRequest );
-    if ( handleHttpSpecificRequest( strOrigin, esm, objRequest, joResponseObj ) ) {
-        strResponse = joResponseObj.dump();
-        return true;
-    }
-    if ( !handleProtocolSpecificRequest( strOrigin, joRequest, joResponse ) ) {
-        return false;
-    } else {
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer< rapidjson::StringBuffer > writer( buffer );
-        joResponse.Accept( writer );
-        strResponse = buffer.GetString();
+    // informational and HTTP specific methods work on the already parsed request
+    if ( esm == e_server_mode_t::esm_informational || g_http_rpc_map.count( strMethod ) > 0 ) {
+        nlohmann::json joResponse = nlohmann::json::object();
+        joResponse["jsonrpc"] = "2.0";
+        if ( joRequest.count( "id" ) > 0 )
+            joResponse["id"] = joRequest["id"];
+        joResponse["result"] = nlohmann::json::object();
+        if ( handleHttpSpecificRequest( strOrigin, esm, joRequest, joResponse ) ) {
+            strResponse = joResponse.dump();
+            return true;
+        }
     }
-    return true;
+    return handleProtocolSpecificRequest( strOrigin, strMethod, strRequest, strResponse );
 }
 
 bool SkaleServerOverride::handleHttpSpecificRequest( const std::string& strOrigin,
@@ -53,12 +53,14 @@ typedef intptr_t ssize_t;
 #include <jsonrpccpp/server/abstractserverconnector.h>
 #include <microhttpd.h>
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include <skutils/console_colors.h>
 #include <skutils/dispatch.h>
@@ -82,6 +84,42 @@ class SkaleWsPeer;
 class SkaleRelayWS;
 class SkaleServerOverride;
 
+namespace skale {
+class RpcExecutor;
+
+namespace server {
+namespace helper {
+
+nlohmann::json log_entry_to_json( const dev::eth::LocalisedLogEntry& e );
+
+// eth_subscription notification around an already serialized result
+std::string make_subscription_notification(
+    const std::string& strSubscription, const std::string& strResult );
+
+// Results of eth_subscription notifications are the same for every subscriber of an event, so
+// each result is serialized once and shared by all peers. Only results of recent events are
+// kept, older ones are evicted in order of insertion.
+class shared_result_cache {
+public:
+    typedef std::shared_ptr< const std::string > result_ptr_t;
+    static const size_t g_nDefaultMaxEntries = 4096;
+    explicit shared_result_cache( size_t nMaxEntries = g_nDefaultMaxEntries )
+        : nMaxEntries_( nMaxEntries ) {}
+    result_ptr_t get( const std::string& strKey, const std::function< std::string() >& fnMake );
+    size_t size() const;
+    static shared_result_cache& instance();
+
+private:
+    const size_t nMaxEntries_;
+    mutable std::mutex mtx_;
+    std::unordered_map< std::string, result_ptr_t > map_;
+    std::deque< std::string > order_;
+};
+
+};  // namespace helper
+};  // namespace server
+}  // namespace skale
+
 
 enum class e_server_mode_t { esm_standard, esm_informational };
 
@@ -133,6 +171,7 @@ public:
     const std::string m_strPeerQueueID;
     std::unique_ptr< SkaleServerConnectionsTrackHelper > m_pSSCTH;
     std::string m_strUnDdosOrigin;
+    std::atomic_bool isUnregistered_ = false;
     SkaleWsPeer( skutils::ws::server& srv, const skutils::ws::hdl_t& hdl );
     ~SkaleWsPeer() override;
     void onPeerRegister() override;
@@ -152,6 +191,8 @@ public:
     SkaleServerOverride* pso();
     const SkaleServerOverride* pso() const { return const_cast< SkaleWsPeer* >( this )->pso(); }
     dev::eth::Interface* ethereum() const;
+    // name RPC stats of the call are kept under, see SkaleServerOverride::statsMethodName()
+    const std::string& statsMethodName( const std::string& strMethod ) const;
 
 protected:
     typedef std::set< unsigned > set_watche_ids_t;
@@ -162,8 +203,8 @@ protected:
 public:
     bool handleRequestWithBinaryAnswer( e_server_mode_t esm, const nlohmann::json& joRequest );
 
-    bool handleWebSocketSpecificRequest(
-        e_server_mode_t esm, const nlohmann::json& joRequest, std::string& strResponse );
+    bool handleWebSocketSpecificRequest( e_server_mode_t esm, const nlohmann::json& joRequest,
+        const std::string& strRequest, std::string& strResponse );
     bool handleWebSocketSpecificRequest(
         e_server_mode_t esm, const nlohmann::json& joRequest, nlohmann::json& joResponse );
 
@@ -300,6 +341,10 @@ public:
                                                                                // default 1 second
 
     size_t maxCountInBatchJsonRpcRequest_ = 128;
+    // how many requests of one batch are handled concurrently
+    size_t maxParallelismInBatchJsonRpcRequest_ = 4;
+    // runs expensive read-only methods outside of server threads, nullptr if disabled
+    std::shared_ptr< skale::RpcExecutor > rpcExecutor_;
 
     skutils::unddos::algorithm unddos_;
 
@@ -387,6 +432,8 @@ public:
         bool isTraceCalls_ = false;
         bool isTraceSpecialCalls_ = false;
         std::string strEthErc20Address_;
+        // methods served by the handler, calls of other methods share one label of RPC metrics
+        std::set< std::string > setKnownMethods_;
         opts_t() {}
         opts_t( const opts_t& other ) { assign( other ); }
         opts_t& operator=( const opts_t& other ) { return assign( other ); }
@@ -404,6 +451,7 @@ public:
                 other.lfExecutionDurationMaxForPerformanceWarning_;
             isTraceCalls_ = other.isTraceCalls_;
             strEthErc20Address_ = other.strEthErc20Address_;
+            setKnownMethods_ = other.setKnownMethods_;
             return ( *this );
         }
     };
@@ -418,11 +466,25 @@ public:
     const dev::eth::ChainParams& chainParams() const;
     dev::Verbosity methodTraceVerbosity( const std::string& strMethod ) const;
     bool checkAdminOriginAllowed( const std::string& origin ) const;
+    // method names come from clients, so unknown ones are reported as "other"
+    const std::string& metricsMethodLabel( const std::string& strMethod ) const;
+    // stats records are kept only for methods the server has, others are counted as "<other>"
+    const std::string& statsMethodName( const std::string& strMethod ) const;
+
+    // passes request to handler, on rpcExecutor_ if it handles the method
+    void implCallHandler( jsonrpc::IClientConnectionHandler* handler,
+        const std::string& strMethod, const std::string& strRequest, std::string& strResponse,
+        std::function< bool() > fnIsCancelled = {} );
 
 protected:
+    // strBody is the text joIn was parsed from
     skutils::result_of_http_request implHandleHttpRequest( const nlohmann::json& joIn,
-        const std::string& strProtocol, int nServerIndex, std::string strOrigin, int ipVer,
-        int nPort, e_server_mode_t esm );
+        const std::string& strBody, const std::string& strProtocol, int nServerIndex,
+        std::string strOrigin, int ipVer, int nPort, e_server_mode_t esm );
+    // strBody is the text of joRequest, it is dispatched to the handlers
+    skutils::result_of_http_request implHandleHttpRequestItem( const nlohmann::json& joRequest,
+        const std::string& strBody, const std::string& strProtocol, int nServerIndex,
+        const std::string& strOrigin, int ipVer, int nPort, e_server_mode_t esm );
 
 private:
     bool implStartListening(  // web socket
@@ -520,6 +582,8 @@ public:
 
     bool handleProtocolSpecificRequest( const std::string& strOrigin,
         const rapidjson::Document& joRequest, rapidjson::Document& joResponse );
+    bool handleProtocolSpecificRequest( const std::string& strOrigin, const std::string& strMethod,
+        const std::string& strRequest, std::string& strResponse );
 
 protected:
     typedef void ( SkaleServerOverride::*rpc_method_t )( const std::string& strOrigin,
@@ -562,6 +626,7 @@ protected:
     typedef std::map< std::string, rpc_http_method_t > http_rpc_map_t;
     static const http_rpc_map_t g_http_rpc_map;
     bool handleHttpSpecificRequest( const std::string& strOrigin, e_server_mode_t esm,
+        const std::string& strMethod, const nlohmann::json& joRequest,
         const std::string& strRequest, std::string& strResponse );
     bool handleHttpSpecificRequest( const std::string& strOrigin, e_server_mode_t esm,
         const nlohmann::json& joRequest, nlohmann::json& joResponse );
@@ -730,12 +730,15 @@ inline void stream::write_format( const char* fmt, const Args&... args ) {
 struct result_of_http_request {
     bool isBinary_ = false;
     nlohmann::json joOut_;
+    std::string strOut_;  // already serialized JSON answer, sent instead of joOut_ if not empty
     std::vector< uint8_t > vecBytes_;
 };  /// struct result_of_http_request
 
 namespace http_pg {
+// strBody is the request text joIn was parsed from
 typedef std::function< skutils::result_of_http_request( const nlohmann::json&,
-    const std::string& strOrigin, int ipVer, const std::string& strDstAddress, int nDstPort ) >
+    const std::string& strBody, const std::string& strOrigin, int ipVer,
+    const std::string& strDstAddress, int nDstPort ) >
     pg_on_request_handler_t;
 
 typedef void* wrapped_proxygen_server_handle;
@@ -11,6 +11,7 @@
 #pragma GCC diagnostic ignored "-Wattributes"
 
 #include <folly/Memory.h>
+#include <folly/io/IOBufQueue.h>
 #include <proxygen/httpserver/RequestHandler.h>
 
 #include <folly/io/async/EventBaseManager.h>
@@ -51,15 +52,30 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// answers smaller than this are not worth compressing
+extern const size_t g_nCompressionMinSize;
+
+// picks the Content-Encoding of an answer of nAnswerSize bytes from the Accept-Encoding header,
+// zstd is preferred over gzip, returns an empty string if the answer is sent as is
+std::string negotiate_encoding( const std::string& strAcceptEncoding, size_t nAnswerSize );
+
 class request_site : public proxygen::RequestHandler {
     request_sink& sink_;
+    // body parts are chained as they arrive and coalesced once at EOM
     std::unique_ptr< folly::IOBuf > body_;
     server_side_request_handler* pSSRQ_;
     static std::atomic_uint64_t g_instance_counter;
     uint64_t nInstanceNumber_;
     std::string strLogPrefix_;
     size_t nBodyPartNumber_ = 0;
-    std::string strBody_;
+    std::string strAcceptEncoding_;
+    // large answers are sent in chunks, the rest waits here while egress is paused
+    folly::IOBufQueue queueOut_{ folly::IOBufQueue::cacheChainLength() };
+    bool isEgressPaused_ = false;
+    bool isStreaming_ = false;
+
+    void send_answer( std::unique_ptr< folly::IOBuf > bufOut, const char* strContentType );
+    void send_pending_chunks();
 
 public:
     std::string strHttpMethod_, strOrigin_, strPath_, strDstAddress_;
@@ -71,6 +87,8 @@ public:
     void onRequest( std::unique_ptr< proxygen::HTTPMessage > headers ) noexcept override;
     void onBody( std::unique_ptr< folly::IOBuf > body ) noexcept override;
     void onEOM() noexcept override;
+    void onEgressPaused() noexcept override;
+    void onEgressResumed() noexcept override;
     void onUpgrade( proxygen::UpgradeProtocol proto ) noexcept override;
     void requestComplete() noexcept override;
     void onError( proxygen::ProxygenError err ) noexcept override;
@@ -105,8 +123,8 @@ public:
     static std::string answer_from_error_text(
         const char* strErrorDescription, const nlohmann::json& joID );
     virtual skutils::result_of_http_request onRequest( const nlohmann::json& joIn,
-        const std::string& strOrigin, int ipVer, const std::string& strDstAddress,
-        int nDstPort ) = 0;
+        const std::string& strBody, const std::string& strOrigin, int ipVer,
+        const std::string& strDstAddress, int nDstPort ) = 0;
 };  /// class server_side_request_handler
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -129,8 +147,8 @@ public:
     bool start();
     void stop();
     skutils::result_of_http_request onRequest( const nlohmann::json& joIn,
-        const std::string& strOrigin, int ipVer, const std::string& strDstAddress,
-        int nDstPort ) override;
+        const std::string& strBody, const std::string& strOrigin, int ipVer,
+        const std::string& strDstAddress, int nDstPort ) override;
 };  /// class server
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,12 @@
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/httpserver/ResponseBuilder.h>
 
+#if __has_include( <folly/compression/Compression.h> )
+#include <folly/compression/Compression.h>
+#else
+#include <folly/io/Compression.h>
+#endif
+
 #include <glog/logging.h>
 
 #pragma GCC diagnostic pop
@@ -71,6 +77,53 @@ void request_sink::OnRecordRequestCountIncrement() {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+const size_t g_nCompressionMinSize = 4096;
+
+namespace {
+
+// answers larger than this are streamed with chunked transfer encoding
+const size_t g_nChunkSize = 256 * 1024;
+
+folly::io::CodecType codec_of_encoding( const std::string& strEncodingName ) {
+    if ( strEncodingName == "zstd" )
+        return folly::io::CodecType::ZSTD;
+    if ( strEncodingName == "gzip" )
+        return folly::io::CodecType::GZIP;
+    return folly::io::CodecType::NO_COMPRESSION;
+}
+
+};  // namespace
+
+std::string negotiate_encoding( const std::string& strAcceptEncoding, size_t nAnswerSize ) {
+    if ( nAnswerSize < g_nCompressionMinSize )
+        return std::string();
+    bool bGzip = false, bZstd = false;
+    for ( const std::string& strItem : skutils::tools::split( strAcceptEncoding, ',' ) ) {
+        skutils::string_list_t lstParts = skutils::tools::split( strItem, ';' );
+        if ( lstParts.empty() )
+            continue;
+        std::string strName =
+            skutils::tools::to_lower( skutils::tools::trim_copy( lstParts.front() ) );
+        bool bRefused = false;
+        for ( const std::string& strParam : lstParts ) {
+            std::string strQ = skutils::tools::trim_copy( strParam );
+            if ( strQ.size() > 2 && strQ[0] == 'q' && strQ[1] == '=' )
+                bRefused = ( atof( strQ.c_str() + 2 ) <= 0.0 );
+        }
+        if ( bRefused )
+            continue;
+        if ( strName == "zstd" )
+            bZstd = true;
+        else if ( strName == "gzip" || strName == "*" )
+            bGzip = true;
+    }
+    if ( bZstd && folly::io::hasCodec( folly::io::CodecType::ZSTD ) )
+        return "zstd";
+    if ( bGzip && folly::io::hasCodec( folly::io::CodecType::GZIP ) )
+        return "gzip";
+    return std::string();
+}
+
 std::atomic_uint64_t request_site::g_instance_counter = 0;
 
 request_site::request_site( request_sink& a_sink, server_side_request_handler* pSSRQ )
@@ -100,6 +153,8 @@ void request_site::onRequest( std::unique_ptr< proxygen::HTTPMessage > req ) noe
     strOrigin_ = req->getScheme() + "://" + strAddressPart + ":" + req->getClientPort();
     strPath_ = req->getPath();
     strDstAddress_ = req->getDstAddress().getAddressStr();  // getFullyQualified()
+    strAcceptEncoding_ =
+        req->getHeaders().getSingleOrEmpty( proxygen::HTTP_HEADER_ACCEPT_ENCODING );
     std::string strDstPort = req->getDstPort();
     nDstPort_ = ( !strDstPort.empty() ) ? atoi( strDstPort.c_str() ) : 0;
     pg_log( strLogPrefix_ + cc::debug( "request query " ) + cc::sunny( strHttpMethod_ ) +
@@ -129,20 +184,13 @@ void request_site::onBody( std::unique_ptr< folly::IOBuf > body ) noexcept {
     pg_log( strLogPrefix_ + cc::info( strHttpMethod_ ) + cc::debug( " body query" ) + "\n" );
     if ( strHttpMethod_ == "OPTIONS" )
         return;
-    auto cnt = body->computeChainDataLength();
-    auto pData = body->data();
-    std::string strIn;
-    strIn.insert( strIn.end(), pData, pData + cnt );
+    size_t cnt = body->computeChainDataLength();
     pg_log( strLogPrefix_ + cc::debug( "got body part number " ) + cc::size10( nBodyPartNumber_ ) +
-            "\n" );
-    pg_log(
-        strLogPrefix_ + cc::debug( "got body part size " ) + cc::size10( strIn.size() ) + "\n" );
-    pg_log( strLogPrefix_ + cc::debug( "got body part content " ) + cc::normal( strIn ) + "\n" );
-    strBody_ += strIn;
-    pg_log( strLogPrefix_ + cc::debug( "accumulated so far body size " ) +
-            cc::size10( strBody_.size() ) + "\n" );
-    pg_log( strLogPrefix_ + cc::debug( "accumulated so far body content part(s) " ) +
-            cc::normal( strBody_ ) + "\n" );
+            cc::debug( ", size " ) + cc::size10( cnt ) + "\n" );
+    if ( body_ )
+        body_->prependChain( std::move( body ) );
+    else
+        body_ = std::move( body );
     ++nBodyPartNumber_;
 }
 
@@ -153,60 +201,126 @@ void request_site::onEOM() noexcept {
         proxygen::ResponseBuilder( downstream_ ).sendWithEOM();
         return;
     }
+    folly::ByteRange rangeBody = body_ ? body_->coalesce() : folly::ByteRange();
+    const char* pBodyBegin = reinterpret_cast< const char* >( rangeBody.begin() );
+    const char* pBodyEnd = reinterpret_cast< const char* >( rangeBody.end() );
     pg_log( strLogPrefix_ + cc::debug( "finally got " ) + cc::size10( nBodyPartNumber_ ) +
             cc::debug( " body part(s)" ) + "\n" );
-    pg_log( strLogPrefix_ + cc::debug( "finally got body size " ) + cc::size10( strBody_.size() ) +
-            "\n" );
-    pg_log(
-        strLogPrefix_ + cc::debug( "finally got body content " ) + cc::normal( strBody_ ) + "\n" );
+    pg_log( strLogPrefix_ + cc::debug( "finally got body size " ) +
+            cc::size10( rangeBody.size() ) + "\n" );
+    if ( pg_logging_get() )
+        pg_log( strLogPrefix_ + cc::debug( "finally got body content " ) +
+                cc::normal( std::string( pBodyBegin, pBodyEnd ) ) + "\n" );
     nlohmann::json joID = "0xBADF00D", joIn;
     skutils::result_of_http_request rslt;
     rslt.isBinary_ = false;
     try {
-        joIn = nlohmann::json::parse( strBody_ );
+        joIn = nlohmann::json::parse( pBodyBegin, pBodyEnd );
         pg_log( strLogPrefix_ + cc::debug( "got body JSON " ) + cc::j( joIn ) + "\n" );
         if ( joIn.count( "id" ) > 0 )
             joID = joIn["id"];
-        rslt = pSSRQ_->onRequest( joIn, strOrigin_, ipVer_, strDstAddress_, nDstPort_ );
+        // handlers get the body text too, so that it is not serialized again
+        rslt = pSSRQ_->onRequest( joIn, std::string( pBodyBegin, pBodyEnd ), strOrigin_, ipVer_,
+            strDstAddress_, nDstPort_ );
         if ( rslt.isBinary_ )
             pg_log( strLogPrefix_ + cc::debug( "got binary answer " ) +
                     cc::binary_table( ( const void* ) ( void* ) rslt.vecBytes_.data(),
                         size_t( rslt.vecBytes_.size() ) ) +
                     "\n" );
+        else if ( !rslt.strOut_.empty() )
+            pg_log( strLogPrefix_ + cc::debug( "got answer JSON " ) + cc::normal( rslt.strOut_ ) +
+                    "\n" );
         else
             pg_log( strLogPrefix_ + cc::debug( "got answer JSON " ) + cc::j( rslt.joOut_ ) + "\n" );
     } catch ( const std::exception& ex ) {
-        pg_log( strLogPrefix_ + cc::error( "problem with body " ) + cc::warn( strBody_ ) +
-                cc::error( ", error info: " ) + cc::warn( ex.what() ) + "\n" );
+        if ( pg_logging_get() )
+            pg_log( strLogPrefix_ + cc::error( "problem with body " ) +
+                    cc::warn( std::string( pBodyBegin, pBodyEnd ) ) +
+                    cc::error( ", error info: " ) + cc::warn( ex.what() ) + "\n" );
         rslt.isBinary_ = false;
+        rslt.strOut_.clear();
         rslt.joOut_ = server_side_request_handler::json_from_error_text( ex.what(), joID );
         pg_log(
             strLogPrefix_ + cc::error( "got error answer JSON " ) + cc::j( rslt.joOut_ ) + "\n" );
     } catch ( ... ) {
-        pg_log( strLogPrefix_ + cc::error( "problem with body " ) + cc::warn( strBody_ ) +
-                cc::error( ", error info: " ) + cc::warn( "unknown exception in HTTP handler" ) +
-                "\n" );
+        if ( pg_logging_get() )
+            pg_log( strLogPrefix_ + cc::error( "problem with body " ) +
+                    cc::warn( std::string( pBodyBegin, pBodyEnd ) ) +
+                    cc::error( ", error info: " ) +
+                    cc::warn( "unknown exception in HTTP handler" ) + "\n" );
         rslt.isBinary_ = false;
+        rslt.strOut_.clear();
         rslt.joOut_ = server_side_request_handler::json_from_error_text(
             "unknown exception in HTTP handler", joID );
         pg_log(
             strLogPrefix_ + cc::error( "got error answer JSON " ) + cc::j( rslt.joOut_ ) + "\n" );
     }
+    body_.reset();
+    if ( rslt.isBinary_ ) {
+        send_answer( folly::IOBuf::copyBuffer( rslt.vecBytes_.data(), rslt.vecBytes_.size() ),
+            "application/octet-stream" );
+    } else {
+        std::string strOut = rslt.strOut_.empty() ? rslt.joOut_.dump() : rslt.strOut_;
+        send_answer( folly::IOBuf::fromString( std::move( strOut ) ), "application/json" );
+    }
+}
+
+void request_site::send_answer(
+    std::unique_ptr< folly::IOBuf > bufOut, const char* strContentType ) {
+    // compression runs here, on the worker thread which has built the answer
+    std::string strEncodingName =
+        negotiate_encoding( strAcceptEncoding_, bufOut->computeChainDataLength() );
+    if ( !strEncodingName.empty() ) {
+        try {
+            bufOut = folly::io::getCodec( codec_of_encoding( strEncodingName ) )
+                         ->compress( bufOut.get() );
+        } catch ( const std::exception& ex ) {
+            pg_log( strLogPrefix_ + cc::error( "failed to compress answer: " ) +
+                    cc::warn( ex.what() ) + "\n" );
+            strEncodingName.clear();
+        }
+    }
+    size_t nSize = bufOut->computeChainDataLength();
     proxygen::ResponseBuilder bldr( downstream_ );
     bldr.status( 200, "OK" );
     bldr.header( "access-control-allow-origin", "*" );
-    if ( rslt.isBinary_ ) {
-        bldr.header( "content-length", skutils::tools::format( "%zu", rslt.vecBytes_.size() ) );
-        bldr.header( "Content-Type", "application/octet-stream" );
-        std::string buffer( rslt.vecBytes_.begin(), rslt.vecBytes_.end() );
-        bldr.body( buffer );
-    } else {
-        std::string strOut = rslt.joOut_.dump();
-        bldr.header( "content-length", skutils::tools::format( "%zu", strOut.size() ) );
-        bldr.header( "Content-Type", "application/json" );
-        bldr.body( strOut );
+    bldr.header( "Content-Type", strContentType );
+    bldr.header( "vary", "Accept-Encoding" );
+    if ( !strEncodingName.empty() )
+        bldr.header( "Content-Encoding", strEncodingName );
+    if ( nSize <= g_nChunkSize ) {
+        bldr.header( "content-length", skutils::tools::format( "%zu", nSize ) );
+        bldr.body( std::move( bufOut ) );
+        bldr.sendWithEOM();
+        return;
     }
-    bldr.sendWithEOM();
+    // headers without content length make proxygen use chunked transfer encoding
+    pg_log( strLogPrefix_ + cc::debug( "will stream answer of size " ) + cc::size10( nSize ) +
+            "\n" );
+    bldr.send();
+    isStreaming_ = true;
+    queueOut_.append( std::move( bufOut ) );
+    send_pending_chunks();
+}
+
+void request_site::send_pending_chunks() {
+    while ( !isEgressPaused_ && !queueOut_.empty() ) {
+        size_t nChunk = std::min( g_nChunkSize, queueOut_.chainLength() );
+        proxygen::ResponseBuilder( downstream_ ).body( queueOut_.split( nChunk ) ).send();
+    }
+    if ( isStreaming_ && queueOut_.empty() ) {
+        isStreaming_ = false;
+        proxygen::ResponseBuilder( downstream_ ).sendWithEOM();
+    }
+}
+
+void request_site::onEgressPaused() noexcept {
+    isEgressPaused_ = true;
+}
+
+void request_site::onEgressResumed() noexcept {
+    isEgressPaused_ = false;
+    send_pending_chunks();
 }
 
 void request_site::onUpgrade( proxygen::UpgradeProtocol /*protocol*/ ) noexcept {
@@ -257,8 +371,12 @@ nlohmann::json server_side_request_handler::json_from_error_text(
     const char* strErrorDescription, const nlohmann::json& joID ) {
     if ( strErrorDescription == nullptr || ( *strErrorDescription ) == '\0' )
         strErrorDescription = "unknown error";
+    nlohmann::json joError = nlohmann::json::object();
+    joError["code"] = -32000;
+    joError["message"] = skutils::tools::safe_ascii( strErrorDescription );
     nlohmann::json jo = nlohmann::json::object();
-    jo["error"] = skutils::tools::safe_ascii( strErrorDescription );
+    jo["jsonrpc"] = "2.0";
+    jo["error"] = joError;
     jo["id"] = joID;
     return jo;
 }
@@ -411,8 +529,10 @@ void server::stop() {
 }
 
 skutils::result_of_http_request server::onRequest( const nlohmann::json& joIn,
-    const std::string& strOrigin, int ipVer, const std::string& strDstAddress, int nDstPort ) {
-    skutils::result_of_http_request rslt = h_( joIn, strOrigin, ipVer, strDstAddress, nDstPort );
+    const std::string& strBody, const std::string& strOrigin, int ipVer,
+    const std::string& strDstAddress, int nDstPort ) {
+    skutils::result_of_http_request rslt =
+        h_( joIn, strBody, strOrigin, ipVer, strDstAddress, nDstPort );
     return rslt;
 }
 
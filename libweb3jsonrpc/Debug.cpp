@@ -9,7 +9,9 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/CommonJS.h>
 #include <libethcore/CommonJS.h>
+#include <libethereum/BlockImportTimeline.h>
 #include <libethereum/Client.h>
+#include <libethereum/ContractProfiler.h>
 #include <skutils/eth_utils.h>
 
 
@@ -117,3 +119,23 @@ Json::Value Debug::debug_getFutureTransactions() {
         t.removeMember( "data" );
     return res;
 }
+
+Json::Value Debug::debug_getBlockImportTimeline( int _blocks ) {
+    if ( _blocks <= 0 )
+        BOOST_THROW_EXCEPTION( jsonrpc::JsonRpcException( "Count of blocks must be positive" ) );
+    return BlockImportTimeline::instance().toChromeTrace( _blocks );
+}
+
+Json::Value Debug::debug_getContractProfile( int _count ) {
+    if ( _count <= 0 )
+        BOOST_THROW_EXCEPTION( jsonrpc::JsonRpcException( "Count must be positive" ) );
+    return ContractProfiler::instance().toJson( _count );
+}
+
+void Debug::debug_setContractProfilerSampleRate( int _rate ) {
+    if ( _rate < 0 )
+        BOOST_THROW_EXCEPTION( jsonrpc::JsonRpcException( "Sample rate must not be negative" ) );
+    ContractProfiler::instance().setSampleRate( _rate );
+    // results of different sample rates are not comparable
+    ContractProfiler::instance().reset();
+}
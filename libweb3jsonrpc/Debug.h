@@ -53,6 +53,11 @@ public:
 
     virtual Json::Value debug_getFutureTransactions() override;
 
+    virtual Json::Value debug_getBlockImportTimeline( int _blocks ) override;
+
+    virtual Json::Value debug_getContractProfile( int _count ) override;
+    virtual void debug_setContractProfilerSampleRate( int _rate ) override;
+
 private:
     eth::Client& m_eth;
     SkaleDebugInterface* m_debugInterface = nullptr;
@@ -88,6 +88,21 @@ public:
         this->bindAndAddMethod( jsonrpc::Procedure( "debug_getFutureTransactions",
                                     jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
             &dev::rpc::DebugFace::debug_getFutureTransactionsI );
+
+        this->bindAndAddMethod(
+            jsonrpc::Procedure( "debug_getBlockImportTimeline", jsonrpc::PARAMS_BY_POSITION,
+                jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL ),
+            &dev::rpc::DebugFace::debug_getBlockImportTimelineI );
+
+        this->bindAndAddMethod(
+            jsonrpc::Procedure( "debug_getContractProfile", jsonrpc::PARAMS_BY_POSITION,
+                jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_INTEGER, NULL ),
+            &dev::rpc::DebugFace::debug_getContractProfileI );
+
+        this->bindAndAddMethod(
+            jsonrpc::Procedure( "debug_setContractProfilerSampleRate", jsonrpc::PARAMS_BY_POSITION,
+                jsonrpc::JSON_BOOLEAN, "param1", jsonrpc::JSON_INTEGER, NULL ),
+            &dev::rpc::DebugFace::debug_setContractProfilerSampleRateI );
     }
     inline virtual void debug_accountRangeAtI( const Json::Value& request, Json::Value& response ) {
         response = this->debug_accountRangeAt( request[0u].asString(), request[1u].asInt(),
@@ -159,6 +174,21 @@ public:
         response = this->debug_getFutureTransactions();
     }
 
+    virtual void debug_getBlockImportTimelineI(
+        const Json::Value& request, Json::Value& response ) {
+        response = this->debug_getBlockImportTimeline( request[0u].asInt() );
+    }
+
+    virtual void debug_getContractProfileI( const Json::Value& request, Json::Value& response ) {
+        response = this->debug_getContractProfile( request[0u].asInt() );
+    }
+
+    virtual void debug_setContractProfilerSampleRateI(
+        const Json::Value& request, Json::Value& response ) {
+        this->debug_setContractProfilerSampleRate( request[0u].asInt() );
+        response = true;
+    }
+
     virtual Json::Value debug_accountRangeAt(
         const std::string& param1, int param2, const std::string& param3, int param4 ) = 0;
     virtual Json::Value debug_storageRangeAt( const std::string& param1, int param2,
@@ -181,6 +211,11 @@ public:
     virtual uint64_t debug_doBlocksDbCompaction() = 0;
 
     virtual Json::Value debug_getFutureTransactions() = 0;
+
+    virtual Json::Value debug_getBlockImportTimeline( int _blocks ) = 0;
+
+    virtual Json::Value debug_getContractProfile( int _count ) = 0;
+    virtual void debug_setContractProfilerSampleRate( int _rate ) = 0;
 };
 
 }  // namespace rpc
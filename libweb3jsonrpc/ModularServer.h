@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -83,6 +84,7 @@ public:
               jsonrpc::JSONRPC_SERVER_V2, *this ) ) {
         m_handler->AddProcedure( jsonrpc::Procedure(
             "rpc_modules", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL ) );
+        m_methodNames.insert( "rpc_modules" );
         m_implementedModules = Json::objectValue;
     }
     inline virtual void modules( const Json::Value& request, Json::Value& response ) {
@@ -125,11 +127,15 @@ public:
         return m_connectors.at( _i ).get();
     }
 
+    /// @returns names of all methods and notifications of the server
+    std::set< std::string > const& methodNames() const { return m_methodNames; }
+
 protected:
     std::vector< std::unique_ptr< jsonrpc::AbstractServerConnector > > m_connectors;
     std::unique_ptr< jsonrpc::IProtocolHandler > m_handler;
     /// Mapping for implemented modules, to be filled by subclasses during construction.
     Json::Value m_implementedModules;
+    std::set< std::string > m_methodNames;
 };
 
 template < class I, class... Is >
@@ -145,12 +151,14 @@ public:
         for ( auto const& method : m_interface->methods() ) {
             m_methods[std::get< 0 >( method ).GetProcedureName()] = std::get< 1 >( method );
             this->m_handler->AddProcedure( std::get< 0 >( method ) );
+            this->m_methodNames.insert( std::get< 0 >( method ).GetProcedureName() );
         }
 
         for ( auto const& notification : m_interface->notifications() ) {
             m_notifications[std::get< 0 >( notification ).GetProcedureName()] =
                 std::get< 1 >( notification );
             this->m_handler->AddProcedure( std::get< 0 >( notification ) );
+            this->m_methodNames.insert( std::get< 0 >( notification ).GetProcedureName() );
         }
         // Store module with version.
         for ( auto const& module : m_interface->implementedModules() )
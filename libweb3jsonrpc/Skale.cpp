@@ -142,6 +142,17 @@ std::string Skale::skale_receiveTransaction( std::string const& _rlp ) {
     }
 }
 
+std::string Skale::skale_receiveTransactions( std::string const& _rlpList ) {
+    try {
+        return toJS( m_client.skaleHost()->receiveTransactions( _rlpList ) );
+    } catch ( ValueTooLarge const& ) {
+        throw jsonrpc::JsonRpcException( "Too many transactions in batch, maximum is " +
+                                         std::to_string( SkaleHost::BROADCAST_BATCH_MAX_SIZE ) );
+    } catch ( Exception const& ) {
+        throw jsonrpc::JsonRpcException( exceptionToErrorMessage() );
+    }
+}
+
 size_t g_nMaxChunckSize = 100 * 1024 * 1024;
 
 //
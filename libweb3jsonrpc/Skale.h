@@ -66,6 +66,7 @@ public:
 
     std::string skale_protocolVersion() override;
     std::string skale_receiveTransaction( std::string const& _rlp ) override;
+    std::string skale_receiveTransactions( std::string const& _rlpList ) override;
     std::string skale_shutdownInstance() noexcept( false ) override;
     Json::Value skale_getSnapshot( const Json::Value& request ) override;
     Json::Value skale_downloadSnapshotFragment( const Json::Value& request ) override;
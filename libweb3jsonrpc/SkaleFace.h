@@ -43,6 +43,12 @@ class SkaleFace : public ServerInterface< SkaleFace > {
         response = this->skale_receiveTransaction( str );
     }
 
+    inline virtual void skale_receiveTransactionsI(
+        const Json::Value& request, Json::Value& response ) {
+        std::string str = request[0u].asString();
+        response = this->skale_receiveTransactions( str );
+    }
+
     inline virtual void skale_shutdownInstanceI(
         const Json::Value& request, Json::Value& response ) {
         ( void ) request;
@@ -92,6 +98,7 @@ class SkaleFace : public ServerInterface< SkaleFace > {
 
     virtual std::string skale_protocolVersion() = 0;
     virtual std::string skale_receiveTransaction( std::string const& _rlp ) = 0;
+    virtual std::string skale_receiveTransactions( std::string const& _rlpList ) = 0;
     virtual std::string skale_shutdownInstance() = 0;
     virtual Json::Value skale_getSnapshot( const Json::Value& request ) = 0;
     virtual Json::Value skale_downloadSnapshotFragment( const Json::Value& request ) = 0;
@@ -113,6 +120,11 @@ public:
                 jsonrpc::JSON_STRING, "param1", jsonrpc::JSON_STRING, NULL ),
             &dev::rpc::SkaleFace::skale_receiveTransactionI );
 
+        this->bindAndAddMethod(
+            jsonrpc::Procedure( "skale_receiveTransactions", jsonrpc::PARAMS_BY_POSITION,
+                jsonrpc::JSON_STRING, "param1", jsonrpc::JSON_STRING, NULL ),
+            &dev::rpc::SkaleFace::skale_receiveTransactionsI );
+
         this->bindAndAddMethod( jsonrpc::Procedure( "skale_shutdownInstance",
                                     jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
             &dev::rpc::SkaleFace::skale_shutdownInstanceI );
@@ -118,6 +118,62 @@ Json::Value Tracing::tracing_traceBlockByHash( string const&
 #endif
 }
 
+Json::Value Tracing::tracing_traceBlockRange( string const&
+#ifdef HISTORIC_STATE
+                                                  _fromBlock
+#endif
+    ,
+    string const&
+#ifdef HISTORIC_STATE
+        _toBlock
+#endif
+    ,
+    Json::Value const&
+#ifdef HISTORIC_STATE
+        _jsonTraceConfig
+#endif
+) {
+    checkHistoricStateEnabled();
+
+#ifdef HISTORIC_STATE
+    auto fromBN = jsToBlockNumber( _fromBlock );
+    auto toBN = jsToBlockNumber( _toBlock );
+
+    if ( fromBN == LatestBlock || fromBN == PendingBlock ) {
+        fromBN = m_eth.number();
+    }
+    if ( toBN == LatestBlock || toBN == PendingBlock ) {
+        toBN = m_eth.number();
+    }
+
+    if ( !m_eth.isKnown( toBN ) ) {
+        THROW_TRACE_JSON_EXCEPTION( "Unknown block number:" + _toBlock );
+    }
+
+    if ( fromBN == 0 ) {
+        THROW_TRACE_JSON_EXCEPTION( "Block number must be more than zero" );
+    }
+
+    if ( fromBN > toBN ) {
+        THROW_TRACE_JSON_EXCEPTION( "Invalid block range" );
+    }
+
+    if ( toBN - fromBN + 1 > MAX_TRACE_BLOCK_RANGE ) {
+        THROW_TRACE_JSON_EXCEPTION(
+            "Block range is too large, maximum is " + to_string( MAX_TRACE_BLOCK_RANGE ) );
+    }
+
+    try {
+        return m_eth.traceBlockRange( fromBN, toBN, _jsonTraceConfig );
+    } catch ( std::exception const& _e ) {
+        THROW_TRACE_JSON_EXCEPTION( _e.what() );
+    } catch ( ... ) {
+        THROW_TRACE_JSON_EXCEPTION( "Unknown server error" );
+    }
+#else
+    THROW_TRACE_JSON_EXCEPTION( "This API call is only supported on archive nodes" );
+#endif
+}
 
 Json::Value Tracing::tracing_traceTransaction( string const&
 #ifdef HISTORIC_STATE
@@ -156,6 +212,19 @@ Json::Value Tracing::tracing_traceTransaction( string const&
         Json::Value tracedBlock;
 
         tracedBlock = m_eth.traceBlock( blockNumber, _jsonTraceConfig );
+
+        // in binary format the block is a list of [txHash, trace] pairs
+        if ( TraceOptions::make( _jsonTraceConfig ).outputFormat == TraceOutputFormat::RLP ) {
+            STATE_CHECK( tracedBlock.isString() )
+            bytes const rlpBlock = fromHex( tracedBlock.asString() );
+            for ( auto const& transactionTrace : RLP( rlpBlock ) ) {
+                STATE_CHECK( transactionTrace.isList() && transactionTrace.itemCount() == 2 );
+                if ( transactionTrace[0].toHash< h256 >() == txHash )
+                    return toHexPrefixed( transactionTrace[1].data().toBytes() );
+            }
+            THROW_TRACE_JSON_EXCEPTION( "Transaction not found in block" );
+        }
+
         STATE_CHECK( tracedBlock.isArray() )
         STATE_CHECK( !tracedBlock.empty() )
 
@@ -39,6 +39,8 @@ public:
         std::string const& _blockNumber, Json::Value const& _json ) override;
     virtual Json::Value tracing_traceBlockByHash(
         std::string const& _blockHash, Json::Value const& _json ) override;
+    virtual Json::Value tracing_traceBlockRange( std::string const& _fromBlock,
+        std::string const& _toBlock, Json::Value const& _json ) override;
 
 private:
     eth::Client& m_eth;
@@ -18,6 +18,9 @@ public:
         this->bindAndAddMethod( jsonrpc::Procedure( "debug_traceBlockByHash",
                                     jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL ),
             &dev::rpc::TracingFace::tracing_traceBlockByHashI );
+        this->bindAndAddMethod( jsonrpc::Procedure( "debug_traceBlockRange",
+                                    jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL ),
+            &dev::rpc::TracingFace::tracing_traceBlockRangeI );
         this->bindAndAddMethod( jsonrpc::Procedure( "debug_traceCall", jsonrpc::PARAMS_BY_POSITION,
                                     jsonrpc::JSON_OBJECT, "param1", jsonrpc::JSON_OBJECT, "param2",
                                     jsonrpc::JSON_STRING, "param3", jsonrpc::JSON_OBJECT, NULL ),
@@ -54,6 +57,18 @@ public:
         const Json::Value& request, Json::Value& response ) {
         response = this->tracing_traceBlockByHash( request[0u].asString(), getTracer( request ) );
     }
+    inline virtual void tracing_traceBlockRangeI(
+        const Json::Value& request, Json::Value& response ) {
+        if ( !request.isArray() || request.size() < 2 || request.size() > 3 ||
+             !request[0u].isString() || !request[1u].isString() ||
+             ( request.size() == 3 && !request[2u].isObject() ) ) {
+            BOOST_THROW_EXCEPTION(
+                jsonrpc::JsonRpcException( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS ) );
+        }
+        Json::Value tracer = request.size() == 3 ? request[2u] : Json::Value( Json::objectValue );
+        response = this->tracing_traceBlockRange(
+            request[0u].asString(), request[1u].asString(), tracer );
+    }
     inline virtual void tracing_traceCallI( const Json::Value& request, Json::Value& response ) {
         response = this->tracing_traceCall( request[0u], request[1u].asString(), request[2u] );
     }
@@ -64,6 +79,8 @@ public:
         const std::string& param1, const Json::Value& param2 ) = 0;
     virtual Json::Value tracing_traceBlockByHash(
         const std::string& param1, const Json::Value& param2 ) = 0;
+    virtual Json::Value tracing_traceBlockRange( const std::string& param1,
+        const std::string& param2, const Json::Value& param3 ) = 0;
     virtual Json::Value tracing_traceCall( Json::Value const& _call,
         std::string const& _blockNumber, Json::Value const& _options ) = 0;
 };
@@ -58,6 +58,8 @@
 #include <libevm/VMFactory.h>
 
 #include <libskale/ConsensusGasPricer.h>
+#include <libskale/MetricsExporter.h>
+#include <libskale/RpcExecutor.h>
 #include <libskale/SnapshotManager.h>
 #include <libskale/UnsafeRegion.h>
 
@@ -215,7 +217,7 @@ void removeEmptyOptions( po::parsed_options& parsed ) {
         "http-port6", "https-port6", "ws-port6", "wss-port6", "info-http-port", "info-https-port",
         "info-ws-port", "info-wss-port", "info-http-port6", "info-https-port6", "info-ws-port6",
         "info-wss-port6", "ws-log", "ssl-key", "ssl-cert", "ssl-ca", "acceptors",
-        "info-acceptors" };
+        "info-acceptors", "metrics-port" };
     const set< string > emptyValues = { "NULL", "null", "None" };
 
     parsed.options.erase( remove_if( parsed.options.begin(), parsed.options.end(),
@@ -553,6 +555,7 @@ get_machine_ip_addresses_6() {  // first-interface name, second-address
 }
 
 static std::unique_ptr< Client > g_client;
+static std::unique_ptr< skale::MetricsExporter > g_metricsExporter;
 unique_ptr< ModularServer<> > g_jsonrpcIpcServer;
 
 int main( int argc, char** argv ) try {
@@ -594,6 +597,7 @@ int main( int argc, char** argv ) try {
     int nExplicitPortWSS4nfo = -1;
     int nExplicitPortWSS6std = -1;
     int nExplicitPortWSS6nfo = -1;
+    int nExplicitPortMetrics = -1;
     bool bTraceJsonRpcCalls = false;
     bool bTraceJsonRpcSpecialCalls = false;
     bool bEnabledAPIs_personal = false;
@@ -670,6 +674,8 @@ int main( int argc, char** argv ) try {
     addClientOption( "http-port", po::value< string >()->value_name( "<port>" ),
         "Run web3 HTTP(IPv4) server(s) on specified port(and next set of ports if --acceptors "
         "> 1)" );
+    addClientOption( "metrics-port", po::value< string >()->value_name( "<port>" ),
+        "Serve metrics in Prometheus text format on specified port" );
     addClientOption( "https-port", po::value< string >()->value_name( "<port>" ),
         "Run web3 HTTPS(IPv4) server(s) on specified port(and next set of ports if "
         "--acceptors > 1)" );
@@ -783,6 +789,11 @@ int main( int argc, char** argv ) try {
 
     addClientOption( "max-batch", po::value< size_t >()->value_name( "<count>" ),
         "Maximum count of requests in JSON RPC batch request array" );
+    addClientOption( "batch-parallelism", po::value< size_t >()->value_name( "<count>" ),
+        "Maximum count of requests of one JSON RPC batch handled concurrently" );
+    addClientOption( "rpc-executor-threads", po::value< size_t >()->value_name( "<count>" ),
+        "Count of threads running eth_call, eth_getLogs and traces apart from JSON RPC server "
+        "threads, 0 disables it" );
 
     addClientOption( "admin", po::value< string >()->value_name( "<password>" ),
         "Specify admin session key for JSON-RPC (default: auto-generated and printed at "
@@ -1226,6 +1237,7 @@ int main( int argc, char** argv ) try {
         nExplicitPortWSS6std = fnExtractPort( "wssRpcPort6", "wss-port6", "WSS/6/std port" );
         nExplicitPortWSS6nfo =
             fnExtractPort( "infoWssRpcPort6", "info-wss-port6", "WSS/6/nfo port" );
+        nExplicitPortMetrics = fnExtractPort( "metricsPort", "metrics-port", "metrics port" );
     }  // if ( chainConfigParsed )
 
     // First, get "web3-trace" from config.json
@@ -2179,7 +2191,7 @@ int main( int argc, char** argv ) try {
             //
             size_t maxConnections = 0,
                    max_http_handler_queues = __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__,
-                   cntServersStd = 1, cntServersNfo = 0, cntInBatch = 128;
+                   cntServersStd = 1, cntServersNfo = 0, cntInBatch = 128, cntBatchParallelism = 4;
             bool is_async_http_transfer_mode = true;
             int32_t pg_threads = 0;
             int32_t pg_threads_limit = 0;
@@ -2292,6 +2304,36 @@ int main( int argc, char** argv ) try {
                 cntInBatch = vm["max-batch"].as< size_t >();
             if ( cntInBatch < 1 )
                 cntInBatch = 1;
+            if ( chainConfigParsed ) {
+                try {
+                    cntBatchParallelism =
+                        joConfig["skaleConfig"]["nodeInfo"]["batch-parallelism"].get< size_t >();
+                } catch ( ... ) {
+                    cntBatchParallelism = 4;
+                }
+            }
+            if ( vm.count( "batch-parallelism" ) )
+                cntBatchParallelism = vm["batch-parallelism"].as< size_t >();
+            if ( cntBatchParallelism < 1 )
+                cntBatchParallelism = 1;
+
+            // First, get "rpc-executor" settings from config.json
+            // Second, get count of threads from command line parameter (higher priority source)
+            skale::RpcExecutor::Options rpcExecutorOptions;
+            if ( chainConfigParsed ) {
+                try {
+                    if ( joConfig["skaleConfig"]["nodeInfo"].count( "rpc-executor" ) > 0 )
+                        rpcExecutorOptions = skale::RpcExecutor::Options::fromJson(
+                            joConfig["skaleConfig"]["nodeInfo"]["rpc-executor"] );
+                } catch ( const std::exception& ex ) {
+                    clog( VerbosityWarning, "main" )
+                        << "Bad \"rpc-executor\" settings, RPC executor is disabled: "
+                        << ex.what();
+                    rpcExecutorOptions = skale::RpcExecutor::Options();
+                }
+            }
+            if ( vm.count( "rpc-executor-threads" ) )
+                rpcExecutorOptions.threads = vm["rpc-executor-threads"].as< size_t >();
 
             // First, get "ws-mode" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
@@ -2355,6 +2397,13 @@ int main( int argc, char** argv ) try {
             clog( VerbosityDebug, "main" )
                 << cc::debug( "...." ) + cc::info( "Max count in batch JSON RPC request" )
                 << cc::debug( "...... " ) << cc::size10( cntInBatch );
+            clog( VerbosityDebug, "main" )
+                << cc::debug( "...." ) + cc::info( "Parallel requests in batch JSON RPC" )
+                << cc::debug( "...... " ) << cc::size10( cntBatchParallelism );
+            clog( VerbosityDebug, "main" )
+                << cc::debug( "...." ) + cc::info( "RPC executor threads" )
+                << cc::debug( "..................... " )
+                << cc::size10( rpcExecutorOptions.threads );
             clog( VerbosityDebug, "main" )
                 << cc::debug( "...." ) + cc::info( "Parallel RPC connection acceptors" )
                 << cc::debug( "........ " ) << cc::size10( cntServersStd );
@@ -2441,6 +2490,7 @@ int main( int argc, char** argv ) try {
                                "\"ethERC20Address\" was not found in config JSON, assuming" ) +
                            " " + cc::info( serverOpts.strEthErc20Address_ ) );
             }
+            serverOpts.setKnownMethods_ = g_jsonrpcIpcServer->methodNames();
             auto skale_server_connector =
                 new SkaleServerOverride( chainParams, g_client.get(), serverOpts );
             //
@@ -2457,6 +2507,10 @@ int main( int argc, char** argv ) try {
             skale_server_connector->max_http_handler_queues_ = max_http_handler_queues;
             skale_server_connector->is_async_http_transfer_mode_ = is_async_http_transfer_mode;
             skale_server_connector->maxCountInBatchJsonRpcRequest_ = cntInBatch;
+            skale_server_connector->maxParallelismInBatchJsonRpcRequest_ = cntBatchParallelism;
+            if ( rpcExecutorOptions.threads > 0 )
+                skale_server_connector->rpcExecutor_ =
+                    std::make_shared< skale::RpcExecutor >( rpcExecutorOptions );
             skale_server_connector->pg_threads_ = pg_threads;
             skale_server_connector->pg_threads_limit_ = pg_threads_limit;
             //
@@ -2774,6 +2828,15 @@ int main( int argc, char** argv ) try {
             << cc::bright( "JSONRPC Admin Session Key: " ) << cc::sunny( strJsonAdminSessionKey );
     }  // if ( is_ipc || nExplicitPort...
 
+    if ( nExplicitPortMetrics > 0 ) {
+        g_metricsExporter.reset(
+            new skale::MetricsExporter( chainParams.nodeInfo.ip, nExplicitPortMetrics ) );
+        if ( g_client )
+            skale::MetricsExporter::registerClientMetrics( *g_client );
+        if ( !g_metricsExporter->start() )
+            g_metricsExporter.reset();
+    }
+
     if ( bEnabledShutdownViaWeb3 ) {
         clog( VerbosityWarning, "main" )
             << cc::warn( "Enabling programmatic shutdown via Web3..." );
@@ -2809,6 +2872,12 @@ int main( int argc, char** argv ) try {
             ( ExitHandler::requestedExitCode() == ExitHandler::ec_state_root_mismatch ) );
     }  // if
 
+    if ( g_metricsExporter ) {
+        g_metricsExporter->stop();
+        g_metricsExporter.reset();
+    }
+    skale::MetricsExporter::unregisterClientMetrics();
+
     if ( g_jsonrpcIpcServer.get() ) {
         g_jsonrpcIpcServer->StopListening();
         g_jsonrpcIpcServer.reset( nullptr );
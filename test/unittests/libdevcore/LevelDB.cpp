@@ -1,3 +1,4 @@
+#include <libdevcore/ArchiveSegment.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/Log.h>
@@ -226,4 +227,171 @@ BOOST_AUTO_TEST_CASE( rotation_reopen_test ){
     }// for pre_rotate
 }
 
+BOOST_AUTO_TEST_CASE( rotation_filter_test ) {
+    TransientDirectory td;
+    const int nPieces = 3;
+
+    {
+        auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, false );
+        db::ManuallyRotatingLevelDB rdb( batcher );
+        for ( int i = 0; i < nPieces; ++i ) {
+            auto batch = rdb.createWriteBatch();
+            batch->insert( "batch " + to_string( i ), "val " + to_string( i ) );
+            rdb.commit( std::move( batch ) );
+            rdb.insert( "single " + to_string( i ), "val " + to_string( i ) );
+            if ( i + 1 < nPieces )
+                rdb.rotate();
+        }
+
+        for ( int i = 0; i < nPieces; ++i ) {
+            BOOST_REQUIRE_EQUAL( rdb.lookup( "batch " + to_string( i ) ), "val " + to_string( i ) );
+            BOOST_REQUIRE( rdb.exists( "single " + to_string( i ) ) );
+        }
+        BOOST_REQUIRE( !rdb.exists( string( "missing" ) ) );
+    }
+
+    // filters of existing pieces are built in background, lookups are correct meanwhile
+    auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, false );
+    db::ManuallyRotatingLevelDB rdb( batcher );
+    for ( int attempt = 0; attempt < 2; ++attempt ) {
+        for ( int i = 0; i < nPieces; ++i ) {
+            BOOST_REQUIRE_EQUAL( rdb.lookup( "batch " + to_string( i ) ), "val " + to_string( i ) );
+            BOOST_REQUIRE( rdb.exists( "single " + to_string( i ) ) );
+        }
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "missing" ) ), "" );
+        this_thread::sleep_for( chrono::milliseconds( 100 ) );
+    }
+
+    rdb.rotate();
+    BOOST_REQUIRE( !rdb.exists( string( "batch 0" ) ) );
+    BOOST_REQUIRE_EQUAL( rdb.lookup( string( "batch 2" ) ), "val 2" );
+}
+
+BOOST_AUTO_TEST_CASE( rotation_while_building_filters_test ) {
+    TransientDirectory td;
+    const int nPieces = 3;
+    const int nKeys = 20000;
+
+    {
+        auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, true );
+        db::ManuallyRotatingLevelDB rdb( batcher );
+        for ( int i = 0; i < nPieces + 1; ++i ) {
+            auto batch = rdb.createWriteBatch();
+            for ( int j = 0; j < nKeys; ++j )
+                batch->insert( "key " + to_string( i ) + " " + to_string( j ), to_string( j ) );
+            rdb.commit( std::move( batch ) );
+            rdb.rotate();
+        }
+    }
+
+    // no memory for archive filters, rotations do not wait for scans of pieces
+    auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, true );
+    db::ManuallyRotatingLevelDB rdb( batcher, 0 );
+    for ( int i = 0; i < nPieces + 1; ++i ) {
+        rdb.rotate();
+        for ( int k = 0; k < nPieces + 1; ++k ) {
+            BOOST_REQUIRE_EQUAL(
+                rdb.lookup( "key " + to_string( k ) + " " + to_string( nKeys - 1 ) ),
+                to_string( nKeys - 1 ) );
+        }
+        BOOST_REQUIRE( !rdb.exists( string( "missing" ) ) );
+    }
+
+    this_thread::sleep_for( chrono::milliseconds( 300 ) );
+    for ( int k = 0; k < nPieces + 1; ++k )
+        BOOST_REQUIRE( rdb.exists( "key " + to_string( k ) + " 0" ) );
+    BOOST_REQUIRE_EQUAL( rdb.lookup( string( "missing" ) ), "" );
+}
+
+BOOST_AUTO_TEST_CASE( archive_segment_test ) {
+    TransientDirectory td;
+    db::LevelDB ldb( td.path() + "/piece.db" );
+    for ( int i = 0; i < 5000; ++i )
+        ldb.insert( "key " + to_string( i ), string( i % 700, 'a' + i % 26 ) );
+    ldb.insert( string( "big" ), string( 300000, 'b' ) );
+    ldb.insert( string( "pieceUsageBytes" ), string( "12345" ) );
+
+    BOOST_REQUIRE( db::ArchiveSegment::write( ldb, td.path() + "/piece.seg" ) );
+    db::ArchiveSegment segment( td.path() + "/piece.seg" );
+
+    ldb.forEach( [&]( db::Slice _key, db::Slice _value ) {
+        BOOST_REQUIRE( segment.exists( _key ) );
+        BOOST_REQUIRE_EQUAL( segment.lookup( _key ), _value.toString() );
+        return true;
+    } );
+    BOOST_REQUIRE( !segment.exists( string( "key" ) ) );
+    BOOST_REQUIRE( !segment.exists( string( "zzz" ) ) );
+    BOOST_REQUIRE_EQUAL( segment.lookup( string( "key 5000" ) ), "" );
+
+    int cnt = 0;
+    string prefix = "key 42";
+    segment.forEachWithPrefix( prefix, [&cnt]( db::Slice, db::Slice ) {
+        ++cnt;
+        return true;
+    } );
+    // "key 42" and "key 420".."key 429" and "key 4200".."key 4299"
+    BOOST_REQUIRE_EQUAL( cnt, 111 );
+
+    BOOST_REQUIRE_EQUAL( segment.hashBase(), ldb.hashBase() );
+    BOOST_REQUIRE_THROW( segment.insert( string( "a" ), string( "b" ) ), db::DatabaseError );
+    BOOST_REQUIRE_THROW( segment.kill( string( "key 1" ) ), db::DatabaseError );
+}
+
+BOOST_AUTO_TEST_CASE( rotation_freeze_archive_test ) {
+    TransientDirectory td;
+    const int nPieces = 3;
+
+    auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, true, true );
+    db::ManuallyRotatingLevelDB rdb( batcher );
+    for ( int i = 0; i < nPieces + 2; ++i ) {
+        rdb.insert( "key " + to_string( i ), "val " + to_string( i ) );
+        rdb.rotate();
+    }
+
+    // archive pieces are frozen in background
+    for ( int i = 0; i < 100 && !boost::filesystem::exists( td.path() + "/archive-2.seg" ); ++i )
+        this_thread::sleep_for( chrono::milliseconds( 100 ) );
+    BOOST_REQUIRE( boost::filesystem::exists( td.path() + "/archive-0.seg" ) );
+    BOOST_REQUIRE( boost::filesystem::exists( td.path() + "/archive-2.seg" ) );
+
+    for ( int i = 0; i < nPieces + 2; ++i )
+        BOOST_REQUIRE_EQUAL( rdb.lookup( "key " + to_string( i ) ), "val " + to_string( i ) );
+    BOOST_REQUIRE( !rdb.exists( string( "missing" ) ) );
+
+    // frozen pieces are skipped by compaction
+    rdb.doCompaction();
+    for ( int i = 0; i < nPieces + 2; ++i )
+        BOOST_REQUIRE_EQUAL( rdb.lookup( "key " + to_string( i ) ), "val " + to_string( i ) );
+
+    // keys of frozen pieces cannot be removed, the others can
+    BOOST_REQUIRE_THROW( rdb.kill( string( "key 0" ) ), db::DatabaseError );
+    BOOST_REQUIRE_EQUAL( rdb.lookup( string( "key 0" ) ), "val 0" );
+    rdb.kill( string( "missing" ) );
+    rdb.insert( string( "live" ), string( "val" ) );
+    rdb.kill( string( "live" ) );
+    BOOST_REQUIRE( !rdb.exists( string( "live" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( rotation_stale_segment_test ) {
+    TransientDirectory td;
+    const int nPieces = 3;
+
+    {
+        auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, true );
+        db::ManuallyRotatingLevelDB rdb( batcher );
+        for ( int i = 0; i < nPieces + 1; ++i ) {
+            rdb.insert( "key " + to_string( i ), "val " + to_string( i ) );
+            rdb.rotate();
+        }
+    }
+    BOOST_REQUIRE( boost::filesystem::exists( td.path() + "/archive-0.db" ) );
+
+    // as if freezing was interrupted by a crash
+    writeFile( td.path() + "/archive-0.seg.tmp", asBytes( "incomplete" ) );
+    auto batcher = make_shared<batched_io::rotating_db_io>( td.path(), nPieces, true );
+    BOOST_REQUIRE( !boost::filesystem::exists( td.path() + "/archive-0.seg.tmp" ) );
+    db::ManuallyRotatingLevelDB rdb( batcher );
+    BOOST_REQUIRE_EQUAL( rdb.lookup( string( "key 0" ) ), "val 0" );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
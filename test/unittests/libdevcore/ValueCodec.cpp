@@ -0,0 +1,156 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ValueCodec.cpp
+ * Encoding and decoding of database values by key family.
+ */
+
+#include <libdevcore/RLP.h>
+#include <libdevcore/ValueCodec.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+using namespace std;
+using namespace dev;
+using namespace dev::db;
+using namespace dev::test;
+
+namespace {
+
+// all keys belong to family 0, keys starting with 'x' are not classified
+ValueCodec makeCodec( ValueCodec::Method _method ) {
+    return ValueCodec( { { "test_codec_" + to_string( int( _method ) ), _method } },
+        []( Slice _key ) { return !_key.empty() && _key[0] == 'x' ? -1 : 0; } );
+}
+
+// RLP list, as the values of blocks and extras are
+string rlpValue( bytes const& _payload ) {
+    RLPStream s( 1 );
+    s << _payload;
+    return asString( s.out() );
+}
+
+string bloomLikeValue() {
+    bytes bloom( 261, 0 );
+    bloom[3] = 0x11;
+    bloom[100] = 0x22;
+    bloom[260] = 0x33;
+    return rlpValue( bloom );
+}
+
+string repetitiveValue() {
+    bytes payload;
+    for ( int i = 0; i < 1000; ++i )
+        payload.push_back( i % 7 );
+    return rlpValue( payload );
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ValueCodecSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( zstdRoundTrip ) {
+    ValueCodec const codec = makeCodec( ValueCodec::Method::Zstd );
+    string const plain = repetitiveValue();
+    string const stored = codec.encode( Slice( "key" ), Slice( plain ) );
+    BOOST_REQUIRE( ValueCodec::isEncoded( Slice( stored ) ) );
+    BOOST_REQUIRE_LT( stored.size(), plain.size() );
+    BOOST_REQUIRE_EQUAL( codec.decode( Slice( "key" ), stored ), plain );
+
+    // small and incompressible values are stored plain
+    string const small = rlpValue( bytes( 10, 1 ) );
+    BOOST_REQUIRE_EQUAL( codec.encode( Slice( "key" ), Slice( small ) ), small );
+    std::mt19937 generator( 1 );
+    bytes random( 300 );
+    for ( auto& byte : random )
+        byte = uint8_t( generator() );
+    string const incompressible = rlpValue( random );
+    string const storedRandom = codec.encode( Slice( "key" ), Slice( incompressible ) );
+    BOOST_REQUIRE( !ValueCodec::isEncoded( Slice( storedRandom ) ) );
+    BOOST_REQUIRE_EQUAL( codec.decode( Slice( "key" ), storedRandom ), incompressible );
+}
+
+BOOST_AUTO_TEST_CASE( sparseRoundTrip ) {
+    ValueCodec const codec = makeCodec( ValueCodec::Method::SparseZeros );
+    // not a multiple of 8 bytes, with a non-zero tail
+    string const plain = bloomLikeValue();
+    string const stored = codec.encode( Slice( "key" ), Slice( plain ) );
+    BOOST_REQUIRE( ValueCodec::isEncoded( Slice( stored ) ) );
+    BOOST_REQUIRE_LT( stored.size(), plain.size() );
+    BOOST_REQUIRE_EQUAL( codec.decode( Slice( "key" ), stored ), plain );
+
+    string const zeros = rlpValue( bytes( 512, 0 ) );
+    BOOST_REQUIRE_EQUAL(
+        codec.decode( Slice( "key" ), codec.encode( Slice( "key" ), Slice( zeros ) ) ), zeros );
+}
+
+BOOST_AUTO_TEST_CASE( plainPassthrough ) {
+    ValueCodec const none = makeCodec( ValueCodec::Method::None );
+    string const plain = repetitiveValue();
+    string const stored = none.encode( Slice( "key" ), Slice( plain ) );
+    BOOST_REQUIRE_EQUAL( stored, plain );
+    BOOST_REQUIRE_EQUAL( none.decode( Slice( "key" ), stored ), plain );
+
+    // values encoded while compression was on are still decoded
+    string const zstd =
+        makeCodec( ValueCodec::Method::Zstd ).encode( Slice( "key" ), Slice( plain ) );
+    string const sparse = makeCodec( ValueCodec::Method::SparseZeros )
+                              .encode( Slice( "key" ), Slice( bloomLikeValue() ) );
+    BOOST_REQUIRE_EQUAL( none.decode( Slice( "key" ), zstd ), plain );
+    BOOST_REQUIRE_EQUAL( none.decode( Slice( "key" ), sparse ), bloomLikeValue() );
+
+    // keys of no family are never encoded nor decoded
+    BOOST_REQUIRE_EQUAL(
+        makeCodec( ValueCodec::Method::Zstd ).encode( Slice( "xkey" ), Slice( plain ) ), plain );
+    BOOST_REQUIRE_EQUAL( none.decode( Slice( "xkey" ), zstd ), zstd );
+
+    string decoded = zstd;
+    ValueCodec::decodeIfEncoded( decoded );
+    BOOST_REQUIRE_EQUAL( decoded, plain );
+}
+
+BOOST_AUTO_TEST_CASE( corruptedInput ) {
+    string const zstd = makeCodec( ValueCodec::Method::Zstd )
+                            .encode( Slice( "key" ), Slice( repetitiveValue() ) );
+    string const sparse = makeCodec( ValueCodec::Method::SparseZeros )
+                              .encode( Slice( "key" ), Slice( bloomLikeValue() ) );
+    ValueCodec const none = makeCodec( ValueCodec::Method::None );
+
+    for ( string const& stored : { zstd, sparse } ) {
+        string const truncated = stored.substr( 0, stored.size() - 1 );
+        BOOST_REQUIRE( ValueCodec::isEncoded( Slice( truncated ) ) );
+        BOOST_REQUIRE_THROW( none.decode( Slice( "key" ), truncated ), DatabaseError );
+
+        // a broken value is kept as it is where families are not known
+        string kept = truncated;
+        ValueCodec::decodeIfEncoded( kept );
+        BOOST_REQUIRE_EQUAL( kept, truncated );
+
+        // header only
+        BOOST_REQUIRE( !ValueCodec::isEncoded( Slice( stored.substr( 0, 3 ) ) ) );
+    }
+
+    // sparse size field larger than the payload
+    string oversized = sparse;
+    oversized[3] = char( 0x7f );
+    BOOST_REQUIRE_THROW( none.decode( Slice( "key" ), oversized ), DatabaseError );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -93,6 +93,34 @@ BOOST_AUTO_TEST_CASE( emptySHA3Types,
     BOOST_REQUIRE_EQUAL( emptyListSHA3, EmptyListSHA3 );
 }
 
+BOOST_AUTO_TEST_CASE( sha3ManyMatchesSha3 ) {
+    // lengths around the Keccak block size, counts that do not fill all lanes
+    vector< bytes > inputs;
+    for ( size_t size : { 0, 1, 20, 32, 135, 136, 137, 271, 272, 300 } )
+        for ( size_t i = 0; i < 11; ++i )
+            inputs.push_back( bytes( size, uint8_t( size + i ) ) );
+    vector< bytesConstRef > refs;
+    for ( bytes const& input : inputs )
+        refs.emplace_back( &input );
+
+    // every kernel the host supports, not only the one chosen for it
+    for ( Sha3ManyKernel kernel :
+        { Sha3ManyKernel::Scalar, Sha3ManyKernel::Avx2, Sha3ManyKernel::Avx512 } ) {
+        if ( !setSha3ManyKernel( kernel ) ) {
+            BOOST_TEST_MESSAGE( "sha3_many kernel " << int( kernel ) << " is not supported" );
+            continue;
+        }
+        for ( size_t count = 0; count <= refs.size(); count += 7 ) {
+            vector< bytesConstRef > const part( refs.begin(), refs.begin() + count );
+            vector< h256 > const hashes = sha3_many( part );
+            BOOST_REQUIRE_EQUAL( hashes.size(), count );
+            for ( size_t i = 0; i < count; ++i )
+                BOOST_CHECK_EQUAL( hashes[i], sha3( part[i] ) );
+        }
+    }
+    BOOST_REQUIRE( setSha3ManyKernel( Sha3ManyKernel::Auto ) );
+}
+
 BOOST_AUTO_TEST_CASE( pubkeyOfZero, 
     *boost::unit_test::precondition( dev::test::run_not_express ) ) {
     auto pub = toPublic( {} );
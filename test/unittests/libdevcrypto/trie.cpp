@@ -29,6 +29,7 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/test/unit_test.hpp>
 #include <fstream>
+#include <future>
 
 using namespace std;
 using namespace dev;
@@ -513,6 +514,38 @@ BOOST_AUTO_TEST_CASE( hashedLowerBound ) {
     BOOST_CHECK( itHashToKey == hashToKey.end() );
 }
 
+BOOST_AUTO_TEST_CASE( orderedTrieRootMatchesTrieRootOver ) {
+    // short items are inlined into their parent nodes, long ones are hashed
+    for ( size_t count : { 0, 1, 2, 17, 128, 129, 300, 4097 } )
+        for ( size_t itemSize : { 1, 40 } ) {
+            std::vector< bytes > items;
+            for ( size_t i = 0; i < count; ++i )
+                items.push_back( bytes( itemSize, byte( i ) ) );
+            h256 const expected = trieRootOver(
+                items.size(), []( unsigned _i ) { return rlp( _i ); },
+                [&items]( unsigned _i ) { return items[_i]; } );
+            BOOST_CHECK_EQUAL( orderedTrieRoot( items ), expected );
+        }
+}
+
+BOOST_AUTO_TEST_CASE( orderedTrieRootConcurrentCalls ) {
+    std::vector< bytes > items;
+    for ( size_t i = 0; i < 5000; ++i )
+        items.push_back( bytes( 40, byte( i ) ) );
+    h256 const expected = trieRootOver(
+        items.size(), []( unsigned _i ) { return rlp( _i ); },
+        [&items]( unsigned _i ) { return items[_i]; } );
+
+    // the calls share spare threads, each one gets the right root
+    std::vector< std::future< h256 > > roots;
+    for ( int i = 0; i < 8; ++i )
+        roots.push_back(
+            std::async( std::launch::async, [&items]() { return orderedTrieRoot( items ); } ) );
+    for ( auto& root : roots )
+        BOOST_CHECK_EQUAL( root.get(), expected );
+    BOOST_CHECK_EQUAL( orderedTrieRoot( items ), expected );
+}
+
 BOOST_AUTO_TEST_CASE( trieStess, *boost::unit_test::precondition( dev::test::run_not_express ) ) {
     cnote << "Stress-testing Trie...";
     {
@@ -295,6 +295,115 @@ BOOST_AUTO_TEST_CASE( updateStats ) {
     bcRef.garbageCollect( true );
 }
 
+BOOST_AUTO_TEST_CASE( receiptPointLookups ) {
+    TestBlockChain bc( TestBlockChain::defaultGenesisBlock() );
+    BlockChain& bcRef = bc.interfaceUnsafe();
+
+    TestBlock block;
+    for ( u256 nonce = 1; nonce <= 3; ++nonce )
+        block.addTransaction( TestTransaction::defaultTransaction( nonce ) );
+    block.mine( bc );
+    bc.addBlock( block );
+
+    h256 const hash = bcRef.currentHash();
+    bcRef.clearCaches();
+    // full decoding of the stored receipts, they are cached after it
+    TransactionReceipts const receipts = bcRef.receipts( hash ).receipts;
+    BOOST_REQUIRE_EQUAL( receipts.size(), 3 );
+
+    auto const checkLookups = [&]() {
+        u256 previousGas = 0;
+        for ( unsigned i = 0; i < receipts.size(); ++i ) {
+            BOOST_REQUIRE( bcRef.transactionReceipt( hash, i ).rlp() == receipts[i].rlp() );
+            BOOST_REQUIRE_EQUAL( bcRef.transactionGasUsed( hash, i ),
+                receipts[i].cumulativeGasUsed() - previousGas );
+            previousGas = receipts[i].cumulativeGasUsed();
+        }
+        BOOST_REQUIRE_THROW( bcRef.transactionReceipt( hash, 3 ), std::out_of_range );
+        BOOST_REQUIRE_THROW( bcRef.transactionGasUsed( hash, 3 ), std::out_of_range );
+    };
+
+    uint64_t const hits = bcRef.extrasCacheHits();
+    checkLookups();
+    // out-of-range lookups throw before they are counted
+    BOOST_REQUIRE_EQUAL( bcRef.extrasCacheHits() - hits, 2 * receipts.size() );
+
+    // only the requested receipts are read from the database
+    bcRef.clearCaches();
+    uint64_t const misses = bcRef.extrasCacheMisses();
+    checkLookups();
+    BOOST_REQUIRE_EQUAL( bcRef.extrasCacheMisses() - misses, 2 * receipts.size() + 2 );
+    BOOST_REQUIRE_EQUAL( bcRef.usage( true ).memReceipts, 0 );
+
+    BOOST_REQUIRE_THROW( bcRef.transactionReceipt( h256( 1 ), 0 ), std::out_of_range );
+    BOOST_REQUIRE_THROW( bcRef.transactionGasUsed( h256( 1 ), 0 ), std::out_of_range );
+}
+
+BOOST_AUTO_TEST_CASE( valueCodecsSwitchedOff ) {
+    TestBlockChain bc( TestBlockChain::defaultGenesisBlock() );
+    TestBlock block;
+    block.addTransaction( TestTransaction::defaultTransaction() );
+    block.mine( bc );
+    bc.addBlock( block );
+    h256 const hash = bc.interfaceUnsafe().currentHash();
+    bytes const receipts = bc.interfaceUnsafe().receipts( hash ).rlp();
+    bytes const blooms = bc.interfaceUnsafe().logBlooms( hash ).rlp();
+
+    TestBlock genesis = TestBlockChain::defaultGenesisBlock();
+    TransientDirectory tempDir;
+    ChainParams p( genesisInfo( TestBlockChain::s_sealEngineNetwork ), genesis.bytes(),
+        genesis.accountMap() );
+    p.nodeInfo.blocksDbCodecs = {
+        { "blocks", "zstd" }, { "receipts", "zstd" }, { "logBlooms", "sparse" } };
+    {
+        BlockChain compressed( p, tempDir.path(), true, WithExisting::Kill );
+        compressed.import( block.bytes(), genesis.mutableState() );
+        BOOST_REQUIRE_EQUAL( compressed.currentHash(), hash );
+    }
+
+    // values written compressed are read back after the codecs are switched off
+    p.nodeInfo.blocksDbCodecs.clear();
+    BlockChain plain( p, tempDir.path(), true, WithExisting::Trust );
+    BOOST_REQUIRE_EQUAL( plain.currentHash(), hash );
+    BOOST_REQUIRE( plain.block( hash ) == block.bytes() );
+    BOOST_REQUIRE( plain.receipts( hash ).rlp() == receipts );
+    BOOST_REQUIRE( plain.logBlooms( hash ).rlp() == blooms );
+    BOOST_REQUIRE( plain.transactionReceipt( hash, 0 ).rlp() ==
+                   bc.interfaceUnsafe().transactionReceipt( hash, 0 ).rlp() );
+}
+
+BOOST_AUTO_TEST_CASE( extrasCacheEvictsUnused ) {
+    ExtrasCache< uint64_t, BlockHash > cache( "test" );
+    for ( uint64_t i = 0; i < 1000; ++i )
+        cache.put( i, BlockHash( h256( i ) ) );
+    BOOST_CHECK_EQUAL( cache.memoryUsage(), 1000 * ( BlockHash::size + 64 ) );
+
+    for ( uint64_t i = 0; i < 100; ++i )
+        BOOST_REQUIRE( cache.get( i )->value == h256( i ) );
+
+    uint64_t const toFree = 500 * ( BlockHash::size + 64 );
+    BOOST_CHECK_GE( cache.evict( toFree ), toFree );
+    BOOST_CHECK_LE( cache.memoryUsage(), 500 * ( BlockHash::size + 64 ) );
+    // entries read after insertion survive the sweep
+    for ( uint64_t i = 0; i < 100; ++i )
+        BOOST_CHECK( cache.contains( i ) );
+
+    BOOST_CHECK( !cache.get( 5000 ) );
+
+    // more than the cache holds, shards are emptied
+    uint64_t const left = cache.memoryUsage();
+    BOOST_CHECK_EQUAL( cache.evict( 2 * left ), left );
+    BOOST_CHECK_EQUAL( cache.memoryUsage(), 0 );
+    BOOST_CHECK( !cache.contains( 0 ) );
+    BOOST_CHECK_EQUAL( cache.evict( toFree ), 0 );
+
+    // the emptied cache works as usual
+    cache.put( 1, BlockHash( h256( 1 ) ) );
+    BOOST_REQUIRE( cache.get( 1 )->value == h256( 1 ) );
+    cache.clear();
+    BOOST_CHECK_EQUAL( cache.memoryUsage(), 0 );
+}
+
 BOOST_AUTO_TEST_CASE( invalidJsonThrows, *boost::unit_test::precondition( dev::test::run_not_express ) ) {
     h256 emptyStateRoot;
     /* Below, a comma is missing between fields. */
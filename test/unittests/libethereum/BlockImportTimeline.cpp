@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BlockImportTimeline.cpp
+ * Recording of block import stages.
+ */
+
+#include <libethereum/BlockImportTimeline.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+vector< string > stageNames( BlockImportTimeline::BlockTimeline const& _block ) {
+    vector< string > names;
+    for ( auto const& stage : _block.stages )
+        names.push_back( stage.name );
+    return names;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( BlockImportTimelineSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( stagesOfOpenBlock ) {
+    BlockImportTimeline& timeline = BlockImportTimeline::instance();
+    {
+        // no block is open, nothing is recorded
+        BlockImportTimeline::ScopedStage stage( "before" );
+    }
+    BOOST_REQUIRE( !timeline.isBlockOpen() );
+
+    {
+        BlockImportTimeline::ScopedBlock block( 7 );
+        BOOST_REQUIRE( timeline.isBlockOpen() );
+        { BlockImportTimeline::ScopedStage stage( "execute", "transaction", "0x01" ); }
+        auto const start = BlockImportTimeline::Sample::now();
+        timeline.addStage( "seal", "import", string(), start, BlockImportTimeline::Sample::now() );
+    }
+    BOOST_REQUIRE( !timeline.isBlockOpen() );
+    {
+        BlockImportTimeline::ScopedStage stage( "after" );
+    }
+
+    auto const blocks = timeline.lastBlocks( 1 );
+    BOOST_REQUIRE_EQUAL( blocks.size(), 1 );
+    BOOST_REQUIRE_EQUAL( blocks[0].number, 7 );
+    BOOST_REQUIRE( stageNames( blocks[0] ) == vector< string >( { "execute", "seal" } ) );
+    BOOST_REQUIRE_EQUAL( blocks[0].stages[0].category, "transaction" );
+    BOOST_REQUIRE_EQUAL( blocks[0].stages[0].detail, "0x01" );
+    BOOST_REQUIRE_EQUAL( blocks[0].stages[0].threadId, blocks[0].threadId );
+    BOOST_REQUIRE( blocks[0].start.wall <= blocks[0].stages[0].start.wall );
+    BOOST_REQUIRE( blocks[0].stages[1].finish.wall <= blocks[0].finish.wall );
+}
+
+BOOST_AUTO_TEST_CASE( stagesOfOtherThreadsAreIgnored ) {
+    BlockImportTimeline& timeline = BlockImportTimeline::instance();
+    {
+        BlockImportTimeline::ScopedBlock block( 10 );
+
+        // e.g. an RPC call executing a transaction while a block is imported
+        std::thread other( [&timeline]() {
+            BOOST_CHECK( !timeline.isBlockOpen() );
+            BlockImportTimeline::ScopedStage stage( "rpc_call" );
+        } );
+        other.join();
+
+        // blocks opened on other threads are recorded separately
+        std::thread importer( []() {
+            BlockImportTimeline::ScopedBlock block( 11 );
+            BlockImportTimeline::ScopedStage stage( "import_11" );
+        } );
+        importer.join();
+
+        BlockImportTimeline::ScopedStage stage( "import_10" );
+    }
+
+    auto const blocks = timeline.lastBlocks( 2 );
+    BOOST_REQUIRE_EQUAL( blocks.size(), 2 );
+    BOOST_REQUIRE_EQUAL( blocks[0].number, 11 );
+    BOOST_REQUIRE( stageNames( blocks[0] ) == vector< string >( { "import_11" } ) );
+    BOOST_REQUIRE_EQUAL( blocks[1].number, 10 );
+    BOOST_REQUIRE( stageNames( blocks[1] ) == vector< string >( { "import_10" } ) );
+    BOOST_REQUIRE_NE( blocks[0].threadId, blocks[1].threadId );
+}
+
+BOOST_AUTO_TEST_CASE( capacity ) {
+    BlockImportTimeline& timeline = BlockImportTimeline::instance();
+    timeline.setCapacity( 2 );
+    for ( uint64_t number = 20; number < 23; ++number )
+        BlockImportTimeline::ScopedBlock block( number );
+
+    auto const blocks = timeline.lastBlocks( 10 );
+    timeline.setCapacity( BlockImportTimeline::c_defaultCapacity );
+    BOOST_REQUIRE_EQUAL( blocks.size(), 2 );
+    BOOST_REQUIRE_EQUAL( blocks[0].number, 21 );
+    BOOST_REQUIRE_EQUAL( blocks[1].number, 22 );
+}
+
+BOOST_AUTO_TEST_CASE( chromeTrace ) {
+    BlockImportTimeline& timeline = BlockImportTimeline::instance();
+    {
+        BlockImportTimeline::ScopedBlock block( 30 );
+        BlockImportTimeline::ScopedStage stage( "execute", "transaction", "0x02" );
+    }
+
+    Json::Value const trace = timeline.toChromeTrace( 1 );
+    Json::Value const& events = trace["traceEvents"];
+    BOOST_REQUIRE_EQUAL( events.size(), 2 );
+
+    BOOST_REQUIRE_EQUAL( events[0]["name"].asString(), "block 30" );
+    BOOST_REQUIRE_EQUAL( events[0]["ph"].asString(), "X" );
+    BOOST_REQUIRE_EQUAL( events[0]["args"]["number"].asUInt64(), 30 );
+
+    BOOST_REQUIRE_EQUAL( events[1]["name"].asString(), "execute" );
+    BOOST_REQUIRE_EQUAL( events[1]["cat"].asString(), "transaction" );
+    BOOST_REQUIRE_EQUAL( events[1]["args"]["detail"].asString(), "0x02" );
+    BOOST_REQUIRE( events[1]["args"].isMember( "cpu_us" ) );
+    BOOST_REQUIRE_EQUAL( events[1]["tid"].asUInt64(), events[0]["tid"].asUInt64() );
+    // the stage lies within its block
+    BOOST_REQUIRE_GE( events[1]["ts"].asUInt64(), events[0]["ts"].asUInt64() );
+    BOOST_REQUIRE_LE( events[1]["ts"].asUInt64() + events[1]["dur"].asUInt64(),
+        events[0]["ts"].asUInt64() + events[0]["dur"].asUInt64() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
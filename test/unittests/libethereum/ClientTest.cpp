@@ -25,6 +25,7 @@
 #include <libethashseal/GenesisInfo.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/ClientTest.h>
+#include <libethereum/ContractProfiler.h>
 #include <libp2p/Network.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <test/tools/libtesteth/TestHelper.h>
@@ -842,6 +843,58 @@ BOOST_AUTO_TEST_CASE( consumptionWithReverts ) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( ContractProfilerClient )
+
+BOOST_AUTO_TEST_CASE( onlyCommittedTransactionsAreProfiled ) {
+    TestClientFixture fixture( c_genesisInfoSkaleTest );
+    ClientTest* testClient = asClientTest( fixture.ethereum() );
+
+    dev::eth::simulateMining( *( fixture.ethereum() ), 10 );
+
+    ContractProfiler& profiler = ContractProfiler::instance();
+    profiler.setSampleRate( 1 );
+    profiler.reset();
+
+    Address from = fixture.coinbase.address();
+    Address contractAddress( "0xD2001300000000000000000000000000000000D3" );
+
+    // data to call method setA(0)
+    bytes data =
+        jsToBytes( "0xee919d500000000000000000000000000000000000000000000000000000000000000000" );
+
+    // gas estimation executes the call with Permanence::Reverted
+    u256 estimate = testClient
+                        ->estimateGas( from, 0, contractAddress, data, 100000, 1000000,
+                            GasEstimationCallback() )
+                        .first;
+    Json::Value profile = profiler.toJson( 10 );
+    BOOST_CHECK_EQUAL( profile["sampledTransactions"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( profile["contracts"].size(), 0 );
+
+    Json::Value transaction;
+    transaction["from"] = toJS( from );
+    transaction["to"] = toJS( contractAddress );
+    transaction["data"] = toJS( data );
+    transaction["gas"] = toJS( estimate );
+    BOOST_REQUIRE( fixture.getTransactionStatus( transaction ) );
+
+    profile = profiler.toJson( 10 );
+    BOOST_CHECK_GE( profile["sampledTransactions"].asUInt64(), 1 );
+    bool found = false;
+    for ( Json::Value const& item : profile["contracts"] )
+        if ( item["address"].asString() == toJS( contractAddress ) &&
+             item["selector"].asString() == "0xee919d50" ) {
+            found = true;
+            BOOST_CHECK_GE( item["storageWrites"].asUInt64(), 2 );
+        }
+    BOOST_CHECK( found );
+
+    profiler.setSampleRate( 0 );
+    profiler.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( getHistoricNodesData )
 
 static std::string const c_genesisInfoSkaleIMABLSPublicKeyTest = std::string() +
@@ -0,0 +1,223 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ContractProfiler.cpp
+ * Sampling, attribution and top-K summary of contract execution time.
+ */
+
+#include <libdevcore/CommonJS.h>
+#include <libethereum/ContractProfiler.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+bytes const c_transferData = fromHex( "a9059cbb0000000000000000000000000000000000000001" );
+
+Json::Value findEntry(
+    Json::Value const& _profile, Address const& _address, string const& _selector ) {
+    for ( Json::Value const& item : _profile["contracts"] )
+        if ( item["address"].asString() == toJS( _address ) &&
+             item["selector"].asString() == _selector )
+            return item;
+    return Json::Value();
+}
+
+// one transaction with a single call frame
+void runTransaction( Address const& _address, bool _enabled = true ) {
+    ContractProfiler::TransactionScope scope( _enabled );
+    ContractProfiler::Frame frame( _address, ref( c_transferData ), false );
+}
+
+class ContractProfilerFixture : public TestOutputHelperFixture {
+public:
+    ContractProfilerFixture() {
+        profiler.setSampleRate( 1 );
+        profiler.reset();
+    }
+    ~ContractProfilerFixture() {
+        profiler.setSampleRate( 0 );
+        profiler.reset();
+    }
+
+    ContractProfiler& profiler = ContractProfiler::instance();
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( ContractProfilerSuite, ContractProfilerFixture )
+
+BOOST_AUTO_TEST_CASE( selfTimeExcludesNestedFrames ) {
+    Address const outerAddress( 1 );
+    Address const innerAddress( 2 );
+    {
+        ContractProfiler::TransactionScope scope( true );
+        ContractProfiler::Frame outer( outerAddress, ref( c_transferData ), false );
+        ContractProfiler::noteStorageWrite();
+        this_thread::sleep_for( chrono::milliseconds( 10 ) );
+        {
+            ContractProfiler::Frame inner( innerAddress, ref( c_transferData ), false );
+            ContractProfiler::noteStorageRead();
+            ContractProfiler::noteDbMiss();
+            this_thread::sleep_for( chrono::milliseconds( 100 ) );
+        }
+    }
+
+    Json::Value const profile = profiler.toJson( 10 );
+    BOOST_REQUIRE_EQUAL( profile["sampledTransactions"].asUInt64(), 1 );
+    BOOST_REQUIRE_EQUAL( profile["contracts"].size(), 2 );
+    Json::Value const outer = findEntry( profile, outerAddress, "0xa9059cbb" );
+    Json::Value const inner = findEntry( profile, innerAddress, "0xa9059cbb" );
+    BOOST_REQUIRE( !outer.isNull() && !inner.isNull() );
+
+    // the heaviest entry goes first
+    BOOST_CHECK_EQUAL( profile["contracts"][0]["address"].asString(), toJS( innerAddress ) );
+    BOOST_CHECK_GE( inner["timeMicroseconds"].asUInt64(), 100000 );
+    BOOST_CHECK_GE( outer["timeMicroseconds"].asUInt64(), 10000 );
+    BOOST_CHECK_LT( outer["timeMicroseconds"].asUInt64(), 100000 );
+
+    // counters go to the frame that was current
+    BOOST_CHECK_EQUAL( outer["storageWrites"].asUInt64(), 1 );
+    BOOST_CHECK_EQUAL( outer["storageReads"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( outer["dbMisses"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( inner["storageWrites"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( inner["storageReads"].asUInt64(), 1 );
+    BOOST_CHECK_EQUAL( inner["dbMisses"].asUInt64(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( callKinds ) {
+    Address const address( 1 );
+    bytes const shortData = fromHex( "a9059c" );
+    {
+        ContractProfiler::TransactionScope scope( true );
+        { ContractProfiler::Frame creation( address, ref( c_transferData ), true ); }
+        { ContractProfiler::Frame empty( address, bytesConstRef(), false ); }
+        { ContractProfiler::Frame noSelector( address, ref( shortData ), false ); }
+        { ContractProfiler::Frame first( address, ref( c_transferData ), false ); }
+        { ContractProfiler::Frame second( address, ref( c_transferData ), false ); }
+    }
+
+    Json::Value const profile = profiler.toJson( 10 );
+    BOOST_REQUIRE_EQUAL( profile["contracts"].size(), 3 );
+    BOOST_CHECK_EQUAL( findEntry( profile, address, "constructor" )["calls"].asUInt64(), 1 );
+    // calls with less than 4 bytes of data have no selector
+    BOOST_CHECK_EQUAL( findEntry( profile, address, "fallback" )["calls"].asUInt64(), 2 );
+    BOOST_CHECK_EQUAL( findEntry( profile, address, "0xa9059cbb" )["calls"].asUInt64(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( sampleRate ) {
+    Address const address( 1 );
+
+    profiler.setSampleRate( 0 );
+    for ( int i = 0; i < 3; ++i )
+        runTransaction( address );
+    BOOST_CHECK_EQUAL( profiler.toJson( 10 )["sampledTransactions"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( profiler.toJson( 10 )["contracts"].size(), 0 );
+
+    // every third transaction
+    profiler.setSampleRate( 3 );
+    for ( int i = 0; i < 6; ++i )
+        runTransaction( address );
+    Json::Value profile = profiler.toJson( 10 );
+    BOOST_CHECK_EQUAL( profile["sampleRate"].asUInt(), 3 );
+    BOOST_CHECK_EQUAL( profile["sampledTransactions"].asUInt64(), 2 );
+    BOOST_CHECK_EQUAL( findEntry( profile, address, "0xa9059cbb" )["calls"].asUInt64(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( nestedScopesAreOneTransaction ) {
+    Address const outerAddress( 1 );
+    Address const innerAddress( 2 );
+
+    // scopes opened during execution belong to the transaction being executed
+    profiler.setSampleRate( 2 );
+    for ( int i = 0; i < 4; ++i ) {
+        ContractProfiler::TransactionScope scope( true );
+        ContractProfiler::Frame outer( outerAddress, ref( c_transferData ), false );
+        runTransaction( innerAddress );
+    }
+    Json::Value const profile = profiler.toJson( 10 );
+    BOOST_CHECK_EQUAL( profile["sampledTransactions"].asUInt64(), 2 );
+    BOOST_CHECK_EQUAL(
+        findEntry( profile, outerAddress, "0xa9059cbb" )["calls"].asUInt64(), 2 );
+    BOOST_CHECK_EQUAL(
+        findEntry( profile, innerAddress, "0xa9059cbb" )["calls"].asUInt64(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( disabledScopesAreNotProfiled ) {
+    // State::execute() enables the scope only for Permanence::Committed,
+    // so calls and gas estimation are never sampled
+    runTransaction( Address( 1 ), false );
+    {
+        // nor is anything nested in them
+        ContractProfiler::TransactionScope scope( false );
+        runTransaction( Address( 2 ) );
+    }
+    Json::Value const profile = profiler.toJson( 10 );
+    BOOST_CHECK_EQUAL( profile["sampledTransactions"].asUInt64(), 0 );
+    BOOST_CHECK_EQUAL( profile["contracts"].size(), 0 );
+
+    runTransaction( Address( 3 ) );
+    BOOST_CHECK_EQUAL( profiler.toJson( 10 )["sampledTransactions"].asUInt64(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( evictionKeepsCapacity ) {
+    unsigned const capacity = ContractProfiler::c_capacity;
+    for ( unsigned i = 1; i <= capacity; ++i ) {
+        ContractProfiler::TransactionScope scope( true );
+        ContractProfiler::Frame frame( Address( i ), ref( c_transferData ), false );
+        this_thread::sleep_for( chrono::milliseconds( 1 ) );
+    }
+    Json::Value profile = profiler.toJson( capacity + 1 );
+    BOOST_REQUIRE_EQUAL( profile["contracts"].size(), capacity );
+    for ( Json::Value const& item : profile["contracts"] )
+        BOOST_REQUIRE_EQUAL( item["errorMicroseconds"].asUInt64(), 0 );
+
+    // one key more than fits takes over the lightest entry along with its time
+    Address const newcomer( capacity + 1 );
+    runTransaction( newcomer );
+    profile = profiler.toJson( capacity + 1 );
+    BOOST_REQUIRE_EQUAL( profile["contracts"].size(), capacity );
+    Json::Value const entry = findEntry( profile, newcomer, "0xa9059cbb" );
+    BOOST_REQUIRE( !entry.isNull() );
+    BOOST_CHECK_GE( entry["errorMicroseconds"].asUInt64(), 1000 );
+    BOOST_CHECK_GE( entry["timeMicroseconds"].asUInt64(), entry["errorMicroseconds"].asUInt64() );
+    BOOST_CHECK_EQUAL( entry["calls"].asUInt64(), 1 );
+
+    set< string > addresses;
+    for ( Json::Value const& item : profile["contracts"] ) {
+        addresses.insert( item["address"].asString() );
+        if ( item["address"].asString() != toJS( newcomer ) )
+            BOOST_CHECK_EQUAL( item["errorMicroseconds"].asUInt64(), 0 );
+    }
+    // exactly one of the old keys was evicted
+    BOOST_CHECK_EQUAL( addresses.size(), capacity );
+    size_t evicted = 0;
+    for ( unsigned i = 1; i <= capacity; ++i )
+        evicted += addresses.count( toJS( Address( i ) ) ) == 0 ? 1 : 0;
+    BOOST_CHECK_EQUAL( evicted, 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LogFilterIndex.cpp
+ * Lookup of installed log filters by address and topics.
+ */
+
+#include <libethereum/LogFilterIndex.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+TransactionReceipt receipt( LogEntries const& _log ) {
+    return TransactionReceipt( 1, 21000, _log );
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( LogFilterIndexSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( addressFilters ) {
+    Address const a( 0xa ), b( 0xb ), c( 0xc );
+    LogFilterIndex index;
+    index.insert( h256( 1 ), LogFilter().address( a ) );
+    index.insert( h256( 2 ), LogFilter().address( a ).address( b ) );
+    // addresses are used even when topics are given
+    index.insert( h256( 3 ), LogFilter().address( b ).topic( 0, h256( 0x100 ) ) );
+
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( a, {}, {} ) } ) ) ==
+                   h256Hash( { h256( 1 ), h256( 2 ) } ) );
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( b, { h256( 0x200 ) }, {} ) } ) ) ==
+                   h256Hash( { h256( 2 ), h256( 3 ) } ) );
+    BOOST_REQUIRE(
+        index.candidates( receipt( { LogEntry( c, { h256( 0x100 ) }, {} ) } ) ).empty() );
+    // candidates of all logs of the receipt
+    BOOST_REQUIRE(
+        index.candidates( receipt( { LogEntry( c, {}, {} ), LogEntry( b, {}, {} ) } ) ) ==
+        h256Hash( { h256( 2 ), h256( 3 ) } ) );
+}
+
+BOOST_AUTO_TEST_CASE( topicFilters ) {
+    h256 const x( 0x100 ), y( 0x200 ), z( 0x300 );
+    LogFilterIndex index;
+    index.insert( h256( 1 ), LogFilter().topic( 0, x ) );
+    // indexed under the first constrained topic only
+    index.insert( h256( 2 ), LogFilter().topic( 1, y ).topic( 2, z ) );
+    index.insert( h256( 3 ), LogFilter().topic( 0, y ).topic( 0, z ) );
+
+    Address const a( 0xa );
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( a, { x }, {} ) } ) ) ==
+                   h256Hash( { h256( 1 ) } ) );
+    // a topic is looked up at its own position
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( a, { z, y }, {} ) } ) ) ==
+                   h256Hash( { h256( 2 ), h256( 3 ) } ) );
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( a, { x, x, z }, {} ) } ) ) ==
+                   h256Hash( { h256( 1 ) } ) );
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( a, {}, {} ) } ) ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( rangeFilters ) {
+    LogFilterIndex index;
+    index.insert( h256( 1 ), LogFilter( 5, 10 ) );
+    index.insert( h256( 2 ), LogFilter().address( Address( 0xa ) ) );
+
+    // filters without addresses and topics are candidates for every log
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( Address( 0xb ), {}, {} ) } ) ) ==
+                   h256Hash( { h256( 1 ) } ) );
+    BOOST_REQUIRE( index.candidates( receipt( { LogEntry( Address( 0xa ), {}, {} ) } ) ) ==
+                   h256Hash( { h256( 1 ), h256( 2 ) } ) );
+    // but not for receipts without logs
+    BOOST_REQUIRE( index.candidates( receipt( {} ) ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( installAndUninstall ) {
+    Address const a( 0xa );
+    h256 const x( 0x100 );
+    LogFilter const byAddress = LogFilter().address( a );
+    LogFilter const byTopic = LogFilter().topic( 0, x );
+    LogFilter const range( 0, 100 );
+    TransactionReceipt const r = receipt( { LogEntry( a, { x }, {} ) } );
+
+    LogFilterIndex index;
+    index.insert( h256( 1 ), byAddress );
+    index.insert( h256( 2 ), byAddress );
+    index.insert( h256( 3 ), byTopic );
+    index.insert( h256( 4 ), range );
+    BOOST_REQUIRE_EQUAL( index.candidates( r ).size(), 4 );
+
+    index.erase( h256( 1 ), byAddress );
+    BOOST_REQUIRE( index.candidates( r ) == h256Hash( { h256( 2 ), h256( 3 ), h256( 4 ) } ) );
+    index.erase( h256( 3 ), byTopic );
+    index.erase( h256( 4 ), range );
+    BOOST_REQUIRE( index.candidates( r ) == h256Hash( { h256( 2 ) } ) );
+    // erasing an unknown filter changes nothing
+    index.erase( h256( 5 ), byAddress );
+    index.erase( h256( 5 ), byTopic );
+    BOOST_REQUIRE( index.candidates( r ) == h256Hash( { h256( 2 ) } ) );
+    index.erase( h256( 2 ), byAddress );
+    BOOST_REQUIRE( index.candidates( r ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( logWithFewerTopicsThanFilter ) {
+    Address const a( 0xa );
+    h256 const x( 0x100 ), y( 0x200 );
+    LogFilter const filter = LogFilter().topic( 1, y );
+    LogEntry const matching( a, { x, y }, {} );
+    // exactly one topic, so it has no topic 1 to compare
+    LogEntry const shorter( a, { x }, {} );
+
+    // the bloom of the receipt passes, the logs are checked one by one
+    LogEntries const matches = filter.matches( receipt( { shorter, matching, shorter } ) );
+    BOOST_REQUIRE_EQUAL( matches.size(), 1 );
+    BOOST_REQUIRE( matches[0].topics == matching.topics );
+    BOOST_REQUIRE( filter.matches( receipt( { shorter } ) ).empty() );
+
+    LogFilterIndex index;
+    index.insert( h256( 1 ), filter );
+    BOOST_REQUIRE( index.candidates( receipt( { shorter } ) ).empty() );
+    BOOST_REQUIRE( index.candidates( receipt( { shorter, matching } ) ) ==
+                   h256Hash( { h256( 1 ) } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1240,6 +1240,118 @@ BOOST_AUTO_TEST_CASE( partialCatchUp
     REQUIRE_BALANCE_DECREASE( senderAddress, 0 );
 }
 
+BOOST_AUTO_TEST_CASE( receiveTransactionsBatch ) {
+    SkaleHostFixture fixture;
+    auto& client = fixture.client;
+    auto& coinbase = fixture.coinbase;
+    auto& account2 = fixture.account2;
+    auto& skaleHost = fixture.skaleHost;
+    auto& tq = fixture.tq;
+
+    {
+        auto wr_state = client->state().createStateModifyCopy();
+        wr_state.addBalance( account2.address(), 1000 * dev::eth::ether );
+        wr_state.commit();
+    }
+
+    auto receiver = KeyPair::create();
+    Json::Value json;
+    json["from"] = toJS( coinbase.address() );
+    json["to"] = toJS( receiver.address() );
+    json["value"] = jsToDecimal( toJS( 10000 * dev::eth::szabo ) );
+    json["nonce"] = 0;
+    Transaction tx1 = fixture.tx_from_json( json );
+    json["from"] = toJS( account2.address() );
+    Transaction tx2 = fixture.tx_from_json( json );
+
+    // malformed and duplicate transactions are skipped, the rest of the batch is imported
+    RLPStream rlpList( 4 );
+    rlpList.append( tx1.toBytes() );
+    rlpList.append( bytes{ 0x01, 0x02, 0x03 } );
+    rlpList.append( tx2.toBytes() );
+    rlpList.append( tx1.toBytes() );
+    BOOST_REQUIRE_EQUAL( skaleHost->receiveTransactions( toJS( rlpList.out() ) ), 2 );
+    BOOST_REQUIRE( tq->isKnown( tx1.sha3() ) );
+    BOOST_REQUIRE( tq->isKnown( tx2.sha3() ) );
+    BOOST_REQUIRE_EQUAL( tq->knownTransactions().size(), 2 );
+
+    // nothing new in a batch received again
+    RLPStream again( 2 );
+    again.append( tx1.toBytes() );
+    again.append( tx2.toBytes() );
+    BOOST_REQUIRE_EQUAL( skaleHost->receiveTransactions( toJS( again.out() ) ), 0 );
+
+    // received transactions are proposed
+    sleep( 1 );
+    ConsensusExtFace::transactions_vector proposal = fixture.stub->pendingTransactions( 100 );
+    BOOST_REQUIRE_EQUAL( proposal.size(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( receiveTransactionsBatchLimit ) {
+    SkaleHostFixture fixture;
+    auto& coinbase = fixture.coinbase;
+    auto& skaleHost = fixture.skaleHost;
+
+    auto receiver = KeyPair::create();
+    Json::Value json;
+    json["from"] = toJS( coinbase.address() );
+    json["to"] = toJS( receiver.address() );
+    json["value"] = jsToDecimal( toJS( 10000 * dev::eth::szabo ) );
+    json["nonce"] = 0;
+    bytes const tx = fixture.bytes_from_json( json );
+
+    RLPStream tooLarge( SkaleHost::BROADCAST_BATCH_MAX_SIZE + 1 );
+    for ( size_t i = 0; i <= SkaleHost::BROADCAST_BATCH_MAX_SIZE; ++i )
+        tooLarge.append( tx );
+    BOOST_REQUIRE_THROW(
+        skaleHost->receiveTransactions( toJS( tooLarge.out() ) ), dev::ValueTooLarge );
+    BOOST_REQUIRE_EQUAL( fixture.tq->knownTransactions().size(), 0 );
+
+    RLPStream full( SkaleHost::BROADCAST_BATCH_MAX_SIZE );
+    for ( size_t i = 0; i < SkaleHost::BROADCAST_BATCH_MAX_SIZE; ++i )
+        full.append( tx );
+    BOOST_REQUIRE_EQUAL( skaleHost->receiveTransactions( toJS( full.out() ) ), 1 );
+
+    // the list itself must be valid
+    BOOST_REQUIRE_THROW( skaleHost->receiveTransactions( "0xzz" ), dev::Exception );
+}
+
+BOOST_AUTO_TEST_CASE( broadcastBatch ) {
+    SkaleHostFixture fixture;
+    auto& client = fixture.client;
+    auto& coinbase = fixture.coinbase;
+    auto& account2 = fixture.account2;
+    auto& stub = fixture.stub;
+
+    {
+        auto wr_state = client->state().createStateModifyCopy();
+        wr_state.addBalance( account2.address(), 1000 * dev::eth::ether );
+        wr_state.commit();
+    }
+
+    auto receiver = KeyPair::create();
+    Json::Value json;
+    json["from"] = toJS( coinbase.address() );
+    json["to"] = toJS( receiver.address() );
+    json["value"] = jsToDecimal( toJS( 10000 * dev::eth::szabo ) );
+    json["nonce"] = 0;
+    Transaction tx1 = fixture.tx_from_json( json );
+    json["from"] = toJS( account2.address() );
+    Transaction tx2 = fixture.tx_from_json( json );
+
+    // own transactions are proposed only after they are broadcast, both go in one batch
+    client->importTransaction( tx1 );
+    client->importTransaction( tx2 );
+    sleep( 1 );
+    ConsensusExtFace::transactions_vector proposal = stub->pendingTransactions( 100 );
+    BOOST_REQUIRE_EQUAL( proposal.size(), 2 );
+
+    CHECK_BLOCK_BEGIN;
+    BOOST_REQUIRE_NO_THROW( stub->createBlock( proposal, utcTime(), 1U ) );
+    REQUIRE_BLOCK_INCREASE( 1 );
+    REQUIRE_BLOCK_SIZE( 1, 2 );
+}
+
 BOOST_AUTO_TEST_CASE( getBlockRandom ) {
 
     SkaleHostFixture fixture;
@@ -31,6 +31,31 @@ using namespace dev;
 using namespace dev::eth;
 using namespace dev::test;
 
+namespace {
+
+// transactions of every sender go in nonce order, and heights over the lowest queued nonce of
+// the sender never decrease
+void requireNonceOrder( Transactions const& _top ) {
+    std::map< Address, u256 > lowest;
+    for ( Transaction const& t : _top ) {
+        auto it = lowest.find( t.from() );
+        if ( it == lowest.end() || t.nonce() < it->second )
+            lowest[t.from()] = t.nonce();
+    }
+    std::map< Address, u256 > last;
+    u256 lastHeight = 0;
+    for ( Transaction const& t : _top ) {
+        auto it = last.find( t.from() );
+        BOOST_REQUIRE( it == last.end() || it->second < t.nonce() );
+        last[t.from()] = t.nonce();
+        u256 const height = t.nonce() - lowest[t.from()];
+        BOOST_REQUIRE( lastHeight <= height );
+        lastHeight = height;
+    }
+}
+
+}  // namespace
+
 BOOST_FIXTURE_TEST_SUITE( TransactionQueueSuite, TestOutputHelperFixture )
 
 BOOST_AUTO_TEST_CASE( TransactionEIP86 ) {
@@ -581,4 +606,155 @@ BOOST_AUTO_TEST_CASE( tqEqueue ) {
     //    BOOST_REQUIRE( topTr.size() == 1 );
 }
 
+BOOST_AUTO_TEST_CASE( tqOrderLowerNonceAfterHigher ) {
+    dev::eth::TransactionQueue txq;
+
+    const u256 gasCostCheap = 10 * szabo;
+    const u256 gasCostHigh = 30 * szabo;
+    const u256 gas = 25000;
+    Address dest = Address( "0x095e7baea6a6c7c4c2dfeb977efac326af552d87" );
+    Secret sender1 = Secret( "0x3333333333333333333333333333333333333333333333333333333333333333" );
+    Secret sender2 = Secret( "0x4444444444444444444444444444444444444444444444444444444444444444" );
+
+    Transaction tx13( 0, gasCostCheap, gas, dest, bytes(), 3, sender1 );
+    Transaction tx14( 0, gasCostCheap, gas, dest, bytes(), 4, sender1 );
+    Transaction tx15( 0, gasCostCheap, gas, dest, bytes(), 5, sender1 );
+    Transaction tx16( 0, gasCostCheap, gas, dest, bytes(), 6, sender1 );
+    Transaction tx20( 0, gasCostHigh, gas, dest, bytes(), 0, sender2 );
+    Transaction tx21( 0, gasCostHigh, gas, dest, bytes(), 1, sender2 );
+
+    txq.import( tx15 );
+    txq.import( tx16 );
+    txq.import( tx20 );
+    txq.import( tx21 );
+    BOOST_REQUIRE( ( Transactions{ tx20, tx15, tx21, tx16 } ) == txq.topTransactions( 256 ) );
+
+    // every lower nonce moves the transactions queued before it one height up
+    txq.import( tx14 );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE(
+        ( Transactions{ tx20, tx14, tx21, tx15, tx16 } ) == txq.topTransactions( 256 ) );
+    txq.import( tx13 );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE(
+        ( Transactions{ tx20, tx13, tx21, tx14, tx15, tx16 } ) == txq.topTransactions( 256 ) );
+
+    // proposals moving transactions to another category keep the order too
+    BOOST_REQUIRE( ( Transactions{ tx20, tx13, tx21 } ) == txq.topTransactions( 3, 0, 1 ) );
+    requireNonceOrder( txq.topTransactions( 256, 1 ) );
+    BOOST_REQUIRE(
+        ( Transactions{ tx20, tx13, tx21, tx14, tx15, tx16 } ) == txq.topTransactions( 256, 1 ) );
+}
+
+BOOST_AUTO_TEST_CASE( tqOrderDropLowest ) {
+    dev::eth::TransactionQueue txq;
+
+    const u256 gasCostCheap = 10 * szabo;
+    const u256 gasCostHigh = 30 * szabo;
+    const u256 gas = 25000;
+    Address dest = Address( "0x095e7baea6a6c7c4c2dfeb977efac326af552d87" );
+    Secret sender1 = Secret( "0x3333333333333333333333333333333333333333333333333333333333333333" );
+    Secret sender2 = Secret( "0x4444444444444444444444444444444444444444444444444444444444444444" );
+
+    Transaction tx10( 0, gasCostCheap, gas, dest, bytes(), 0, sender1 );
+    Transaction tx11( 0, gasCostCheap, gas, dest, bytes(), 1, sender1 );
+    Transaction tx12( 0, gasCostCheap, gas, dest, bytes(), 2, sender1 );
+    Transaction tx13( 0, gasCostCheap, gas, dest, bytes(), 3, sender1 );
+    Transaction tx22( 0, gasCostHigh, gas, dest, bytes(), 2, sender2 );
+    Transaction tx23( 0, gasCostHigh, gas, dest, bytes(), 3, sender2 );
+
+    for ( Transaction const& t : { tx10, tx11, tx12, tx13, tx22, tx23 } )
+        txq.import( t );
+    BOOST_REQUIRE(
+        ( Transactions{ tx22, tx10, tx23, tx11, tx12, tx13 } ) == txq.topTransactions( 256 ) );
+
+    // the next nonce of the sender becomes its lowest one
+    txq.drop( tx10.sha3() );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE(
+        ( Transactions{ tx22, tx11, tx23, tx12, tx13 } ) == txq.topTransactions( 256 ) );
+    txq.drop( tx22.sha3() );
+    txq.drop( tx11.sha3() );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE( ( Transactions{ tx23, tx12, tx13 } ) == txq.topTransactions( 256 ) );
+}
+
+BOOST_AUTO_TEST_CASE( tqOrderSetFuture ) {
+    dev::eth::TransactionQueue txq;
+
+    const u256 gasCostCheap = 10 * szabo;
+    const u256 gasCostHigh = 30 * szabo;
+    const u256 gas = 25000;
+    Address dest = Address( "0x095e7baea6a6c7c4c2dfeb977efac326af552d87" );
+    Secret sender1 = Secret( "0x3333333333333333333333333333333333333333333333333333333333333333" );
+    Secret sender2 = Secret( "0x4444444444444444444444444444444444444444444444444444444444444444" );
+
+    Transaction tx10( 0, gasCostCheap, gas, dest, bytes(), 0, sender1 );
+    Transaction tx11( 0, gasCostCheap, gas, dest, bytes(), 1, sender1 );
+    Transaction tx12( 0, gasCostCheap, gas, dest, bytes(), 2, sender1 );
+    Transaction tx20( 0, gasCostHigh, gas, dest, bytes(), 0, sender2 );
+    Transaction tx21( 0, gasCostHigh, gas, dest, bytes(), 1, sender2 );
+    Transaction tx22( 0, gasCostHigh, gas, dest, bytes(), 2, sender2 );
+
+    for ( Transaction const& t : { tx10, tx11, tx12, tx20, tx21, tx22 } )
+        txq.import( t );
+
+    txq.setFuture( tx11.sha3() );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE( ( Transactions{ tx20, tx10, tx21, tx22 } ) == txq.topTransactions( 256 ) );
+
+    // all transactions of the sender go to future
+    txq.setFuture( tx20.sha3() );
+    BOOST_REQUIRE( ( Transactions{ tx10 } ) == txq.topTransactions( 256 ) );
+
+    // mined transaction brings the following ones back with a new lowest nonce
+    txq.dropGood( tx10 );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE( ( Transactions{ tx11, tx12 } ) == txq.topTransactions( 256 ) );
+
+    // re-imported future transaction brings the following ones back too
+    txq.import( tx20 );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+    BOOST_REQUIRE(
+        ( Transactions{ tx20, tx11, tx21, tx12, tx22 } ) == txq.topTransactions( 256 ) );
+}
+
+BOOST_AUTO_TEST_CASE( tqOrderMinedRemoved ) {
+    dev::eth::TransactionQueue txq;
+
+    const u256 gasCostCheap = 10 * szabo;
+    const u256 gasCostMed = 20 * szabo;
+    const u256 gasCostHigh = 30 * szabo;
+    const u256 gas = 25000;
+    Address dest = Address( "0x095e7baea6a6c7c4c2dfeb977efac326af552d87" );
+    Secret sender1 = Secret( "0x3333333333333333333333333333333333333333333333333333333333333333" );
+    Secret sender2 = Secret( "0x4444444444444444444444444444444444444444444444444444444444444444" );
+    Secret sender3 = Secret( "0x5555555555555555555555555555555555555555555555555555555555555555" );
+
+    Transactions all;
+    for ( unsigned nonce = 0; nonce < 4; ++nonce ) {
+        all.push_back( Transaction( 0, gasCostCheap, gas, dest, bytes(), nonce, sender1 ) );
+        all.push_back( Transaction( 0, gasCostMed, gas, dest, bytes(), nonce, sender2 ) );
+        all.push_back( Transaction( 0, gasCostHigh, gas, dest, bytes(), nonce + 5, sender3 ) );
+    }
+    for ( Transaction const& t : all )
+        txq.import( t );
+    requireNonceOrder( txq.topTransactions( 256 ) );
+
+    // blocks take senders' lowest nonces at different rates
+    size_t const mined[] = { 0, 1, 2, 3, 4, 6, 9, 5 };
+    for ( size_t i : mined ) {
+        txq.dropGood( all[i] );
+        Transactions const top = txq.topTransactions( 256 );
+        requireNonceOrder( top );
+        BOOST_REQUIRE( std::find( top.begin(), top.end(), all[i] ) == top.end() );
+    }
+    // the highest gas price goes first among equal heights
+    Address const from3 = all[2].from();
+    Transactions const top = txq.topTransactions( 256 );
+    BOOST_REQUIRE_EQUAL( top.size(), all.size() - std::size( mined ) );
+    BOOST_REQUIRE( top.front().from() == from3 );
+    BOOST_REQUIRE_EQUAL( top.front().nonce(), 7 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BlockTraceStore.cpp
+ * Persistence, rotation and tracing on import of block traces.
+ */
+
+#include <libdevcore/TransientDirectory.h>
+#include <libhistoric/BlockTraceStore.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+Json::Value makeTraces( uint64_t _blockNumber ) {
+    Json::Value traces( Json::arrayValue );
+    Json::Value trace;
+    trace["type"] = "CALL";
+    trace["gasUsed"] = "0x" + std::to_string( _blockNumber );
+    traces.append( trace );
+    return traces;
+}
+
+BlockTraceStore::TraceFunction noTracing() {
+    return []( uint64_t, Json::Value const& ) -> Json::Value {
+        BOOST_FAIL( "no tracers are configured" );
+        return {};
+    };
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( BlockTraceStoreSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( putGetAndRestart ) {
+    TransientDirectory td;
+    {
+        BlockTraceStore store( td.path(), {}, noTracing() );
+        BOOST_REQUIRE( !store.get( 1, "callTracer" ) );
+
+        store.put( 1, "callTracer", makeTraces( 1 ) );
+        store.put( 2, "callTracer", makeTraces( 2 ) );
+        store.put( 1, "prestateTracer", Json::Value( Json::objectValue ) );
+
+        BOOST_REQUIRE( store.get( 1, "callTracer" ) == makeTraces( 1 ) );
+        BOOST_REQUIRE( store.get( 2, "callTracer" ) == makeTraces( 2 ) );
+        BOOST_REQUIRE( store.get( 1, "prestateTracer" ) == Json::Value( Json::objectValue ) );
+        // keys of different blocks and options do not collide
+        BOOST_REQUIRE( !store.get( 3, "callTracer" ) );
+        BOOST_REQUIRE( !store.get( 2, "prestateTracer" ) );
+        BOOST_REQUIRE( !store.get( 12, "callTracer" ) );
+    }
+
+    // traces survive restart
+    BlockTraceStore store( td.path(), {}, noTracing() );
+    BOOST_REQUIRE( store.get( 1, "callTracer" ) == makeTraces( 1 ) );
+    BOOST_REQUIRE( store.get( 2, "callTracer" ) == makeTraces( 2 ) );
+}
+
+BOOST_AUTO_TEST_CASE( oldTracesArePrunedOnRotation ) {
+    TransientDirectory td;
+    BlockTraceStore store( td.path(), {}, noTracing() );
+    store.put( 1, "callTracer", makeTraces( 1 ) );
+
+    // the store rotates every 100000 blocks and keeps 4 pieces
+    store.onBlockImported( 99999 );
+    for ( uint64_t piece = 1; piece < 4; ++piece ) {
+        store.onBlockImported( piece * 100000 );
+        store.onBlockImported( piece * 100000 + 1 );
+        BOOST_REQUIRE( store.get( 1, "callTracer" ) == makeTraces( 1 ) );
+    }
+    store.put( 300001, "callTracer", makeTraces( 300001 ) );
+
+    store.onBlockImported( 400000 );
+    BOOST_REQUIRE( !store.get( 1, "callTracer" ) );
+    BOOST_REQUIRE( store.get( 300001, "callTracer" ) == makeTraces( 300001 ) );
+}
+
+BOOST_AUTO_TEST_CASE( importedBlocksAreTraced ) {
+    TransientDirectory td;
+    Json::Value callConfig;
+    callConfig["tracer"] = "callTracer";
+    Json::Value prestateConfig;
+    prestateConfig["tracer"] = "prestateTracer";
+
+    BlockTraceStore* storePtr = nullptr;
+    std::atomic< int > calls = 0;
+    BlockTraceStore store( td.path(), { callConfig, prestateConfig },
+        [&]( uint64_t _blockNumber, Json::Value const& _traceConfig ) {
+            ++calls;
+            Json::Value const traces = makeTraces( _blockNumber );
+            storePtr->put( _blockNumber, _traceConfig["tracer"].asString(), traces );
+            return traces;
+        } );
+    storePtr = &store;
+
+    // genesis is never traced
+    store.onBlockImported( 0 );
+    store.onBlockImported( 5 );
+
+    for ( int i = 0; i < 500 && !store.get( 5, "prestateTracer" ); ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    BOOST_REQUIRE( store.get( 5, "callTracer" ) == makeTraces( 5 ) );
+    BOOST_REQUIRE( store.get( 5, "prestateTracer" ) == makeTraces( 5 ) );
+    BOOST_REQUIRE( !store.get( 0, "callTracer" ) );
+    BOOST_REQUIRE_EQUAL( calls, 2 );
+    BOOST_REQUIRE_EQUAL( store.queueSize(), 0 );
+
+    store.stop();
+    store.onBlockImported( 6 );
+    BOOST_REQUIRE( !store.get( 6, "callTracer" ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file HistoricStateCompactor.cpp
+ * Retention policy and mark-and-sweep compaction of historic state.
+ */
+
+#include <libdevcore/Address.h>
+#include <libdevcore/DBImpl.h>
+#include <libdevcore/OverlayDB.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libdevcore/TrieDB.h>
+#include <libhistoric/HistoricStateCompactor.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+
+bytes const c_code = { 0x60, 0x00, 0x60, 0x00, 0xf3 };
+
+// state of block _block: every account changes its balance in every block, the first one has
+// storage, the second one has code
+h256 insertState( OverlayDB& _db, uint64_t _block ) {
+    GenericTrieDB< OverlayDB > storage( &_db );
+    storage.init();
+    storage.insert( rlp( 1 ), rlp( _block + 1 ) );
+    storage.insert( rlp( 2 ), rlp( 42 ) );
+    _db.insert( sha3( c_code ), &c_code );
+
+    GenericTrieDB< OverlayDB > accounts( &_db );
+    accounts.init();
+    for ( unsigned i = 0; i < 5; ++i ) {
+        RLPStream account( 4 );
+        account << i << _block * 10 + i << ( i == 0 ? storage.root() : EmptyTrie )
+                << ( i == 1 ? sha3( c_code ) : EmptySHA3 );
+        accounts.insert( Address( i + 1 ).asBytes(), account.out() );
+    }
+    return accounts.root();
+}
+
+h256 commitState( OverlayDB& _db, uint64_t _block ) {
+    h256 const root = insertState( _db, _block );
+    _db.commit();
+    return root;
+}
+
+// all nodes of the state of _block
+h256Hash stateNodes( uint64_t _block ) {
+    OverlayDB db;
+    insertState( db, _block );
+    return db.keys();
+}
+
+h256Hash storedNodes( db::DatabaseFace const& _db ) {
+    h256Hash ret;
+    _db.forEach( [&ret]( db::Slice _key, db::Slice ) {
+        if ( _key.size() == h256::size )
+            ret.insert( h256(
+                reinterpret_cast< _byte_ const* >( _key.data() ), h256::ConstructFromPointer ) );
+        return true;
+    } );
+    return ret;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( HistoricStateCompactorSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( retentionPolicy ) {
+    HistoricStateRetention archive;
+    BOOST_REQUIRE( !archive.enabled() );
+    BOOST_REQUIRE( archive.isRetained( 1, 1000 ) );
+
+    HistoricStateRetention retention;
+    retention.retainBlocks = 3;
+    retention.checkpointInterval = 4;
+    BOOST_REQUIRE( retention.enabled() );
+    // genesis is always kept
+    BOOST_REQUIRE( retention.isRetained( 0, 10 ) );
+    // last 3 blocks
+    BOOST_REQUIRE( retention.isRetained( 10, 10 ) );
+    BOOST_REQUIRE( retention.isRetained( 8, 10 ) );
+    BOOST_REQUIRE( !retention.isRetained( 7, 10 ) );
+    // checkpoints
+    BOOST_REQUIRE( retention.isRetained( 4, 10 ) );
+    BOOST_REQUIRE( !retention.isRetained( 5, 10 ) );
+
+    retention.checkpointInterval = 0;
+    BOOST_REQUIRE( !retention.isRetained( 4, 10 ) );
+}
+
+BOOST_AUTO_TEST_CASE( compactionKeepsOnlyRetainedStates ) {
+    // the 2nd run keeps at most 3 marks in memory, the rest go to the scratch database
+    for ( size_t maxMarkedInMemory : { size_t( 1000000 ), size_t( 3 ) } ) {
+        TransientDirectory td;
+        OverlayDB stateDB( make_unique< db::DBImpl >( td.path() + "/state" ) );
+        OverlayDB rootsDB( make_unique< db::DBImpl >( td.path() + "/roots" ) );
+
+        uint64_t const latest = 10;
+        for ( uint64_t block = 0; block <= latest; ++block ) {
+            h256 const root = commitState( stateDB, block );
+            rootsDB.insert( h256( block ), root.ref() );
+        }
+        rootsDB.commit();
+
+        HistoricStateRetention retention;
+        retention.retainBlocks = 3;
+        retention.checkpointInterval = 4;
+        HistoricStateCompactor compactor( stateDB, rootsDB, retention, td.path() + "/marks",
+            maxMarkedInMemory );
+
+        size_t const nodesBefore = storedNodes( *stateDB.backingDB() ).size();
+        compactor.onBlockImported( latest );
+        compactor.wait();
+        BOOST_REQUIRE( !compactor.isRunning() );
+        BOOST_REQUIRE_EQUAL( compactor.lastPassBlock(), latest );
+
+        h256Hash expected;
+        for ( uint64_t block : { 0, 4, 8, 9, 10 } ) {
+            h256Hash const nodes = stateNodes( block );
+            expected.insert( nodes.begin(), nodes.end() );
+        }
+        h256Hash const stored = storedNodes( *stateDB.backingDB() );
+        BOOST_REQUIRE( stored == expected );
+        BOOST_REQUIRE_EQUAL( compactor.lastPassDeletedNodes(), nodesBefore - stored.size() );
+        BOOST_REQUIRE_GT( compactor.lastPassDeletedNodes(), 0 );
+
+        // roots of pruned blocks are dropped
+        for ( uint64_t block = 0; block <= latest; ++block )
+            BOOST_REQUIRE_EQUAL(
+                rootsDB.exists( h256( block ) ), retention.isRetained( block, latest ) );
+        // scratch database is removed after the pass
+        BOOST_REQUIRE( !boost::filesystem::exists( td.path() + "/marks" ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( compactionWaitsForPeriod ) {
+    TransientDirectory td;
+    OverlayDB stateDB( make_unique< db::DBImpl >( td.path() + "/state" ) );
+    OverlayDB rootsDB( make_unique< db::DBImpl >( td.path() + "/roots" ) );
+    for ( uint64_t block = 0; block <= 5; ++block )
+        rootsDB.insert( h256( block ), commitState( stateDB, block ).ref() );
+    rootsDB.commit();
+
+    HistoricStateRetention retention;
+    retention.retainBlocks = 2;
+    retention.checkpointInterval = 8;
+    HistoricStateCompactor compactor( stateDB, rootsDB, retention, td.path() + "/marks" );
+
+    size_t const nodesBefore = storedNodes( *stateDB.backingDB() ).size();
+    // a pass starts once per checkpoint interval
+    compactor.onBlockImported( 5 );
+    compactor.wait();
+    BOOST_REQUIRE_EQUAL( compactor.lastPassBlock(), 0 );
+    BOOST_REQUIRE_EQUAL( storedNodes( *stateDB.backingDB() ).size(), nodesBefore );
+    BOOST_REQUIRE( rootsDB.exists( h256( 1 ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file MetricsExporter.cpp
+ * Prometheus text format of the metrics registry and its exporter.
+ */
+
+#include <libdevcore/Metrics.h>
+#include <libskale/MetricsExporter.h>
+#include <skutils/http.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace dev;
+using namespace dev::metrics;
+using namespace dev::test;
+
+namespace {
+
+// the registry is process-wide, so every test uses its own metric names
+bool contains( string const& _text, string const& _line ) {
+    return _text.find( _line ) != string::npos;
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( MetricsExporterSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( counterAndGaugeRendering ) {
+    Registry& registry = Registry::instance();
+    Counter& counter = registry.counter(
+        "test_render_requests_total", "Requests", { { "method", "a\"b\\c" } } );
+    counter.inc();
+    counter.inc( 2 );
+    // the same label set returns the same counter
+    BOOST_REQUIRE_EQUAL( &counter, &registry.counter( "test_render_requests_total", "Requests",
+                                       { { "method", "a\"b\\c" } } ) );
+
+    double value = 2.5;
+    registry.gauge( "test_render_temperature", "Temperature", {}, [&value]() { return value; } );
+
+    string text = registry.exposition();
+    BOOST_REQUIRE( contains( text, "# HELP test_render_requests_total Requests\n"
+                                   "# TYPE test_render_requests_total counter\n"
+                                   "test_render_requests_total{method=\"a\\\"b\\\\c\"} 3\n" ) );
+    BOOST_REQUIRE( contains( text, "# TYPE test_render_temperature gauge\n"
+                                   "test_render_temperature 2.5\n" ) );
+
+    // gauges are read on every scrape
+    value = 7;
+    BOOST_REQUIRE( contains( registry.exposition(), "\ntest_render_temperature 7\n" ) );
+
+    registry.removeGauge( "test_render_temperature" );
+    text = registry.exposition();
+    BOOST_REQUIRE( !contains( text, "test_render_temperature" ) );
+    BOOST_REQUIRE( contains( text, "test_render_requests_total{" ) );
+}
+
+BOOST_AUTO_TEST_CASE( histogramRendering ) {
+    Registry& registry = Registry::instance();
+    Histogram& histogram = registry.histogram(
+        "test_render_duration_seconds", "Duration", { { "protocol", "HTTP" } } );
+    histogram.observe( 0.0003 );
+    histogram.observe( 0.0004 );
+    // bounds are inclusive
+    histogram.observe( 0.001 );
+    histogram.observe( 3 );
+    histogram.observe( 100 );
+    BOOST_REQUIRE_EQUAL( histogram.count(), 5 );
+    BOOST_REQUIRE_CLOSE( histogram.sum(), 103.0017, 0.0001 );
+
+    string const text = registry.exposition();
+    string const bucket = "test_render_duration_seconds_bucket{protocol=\"HTTP\",le=";
+    BOOST_REQUIRE( contains( text, "# TYPE test_render_duration_seconds histogram\n" +
+                                       bucket + "\"5e-05\"} 0\n" ) );
+    // buckets are cumulative
+    BOOST_REQUIRE( contains( text, bucket + "\"0.0002\"} 0\n" + bucket + "\"0.0005\"} 2\n" ) );
+    BOOST_REQUIRE( contains( text, bucket + "\"0.001\"} 3\n" ) );
+    BOOST_REQUIRE( contains( text, bucket + "\"2\"} 3\n" + bucket + "\"5\"} 4\n" ) );
+    BOOST_REQUIRE( contains( text, bucket + "\"60\"} 4\n" + bucket + "\"+Inf\"} 5\n" ) );
+    BOOST_REQUIRE(
+        contains( text, "test_render_duration_seconds_sum{protocol=\"HTTP\"} 103.0017\n" ) );
+    BOOST_REQUIRE(
+        contains( text, "test_render_duration_seconds_count{protocol=\"HTTP\"} 5\n" ) );
+
+    // series without labels get only the le label
+    registry.histogram( "test_render_plain_seconds", "Plain" ).observe( 1 );
+    BOOST_REQUIRE(
+        contains( registry.exposition(), "test_render_plain_seconds_bucket{le=\"1\"} 1\n" ) );
+}
+
+BOOST_AUTO_TEST_CASE( seriesLimit ) {
+    Registry& registry = Registry::instance();
+    for ( size_t i = 0; i < Registry::c_maxSeriesPerMetric; ++i )
+        registry.counter( "test_limit_total", "Limited", { { "method", to_string( i ) } } );
+
+    // further label sets share one series
+    Counter& other =
+        registry.counter( "test_limit_total", "Limited", { { "method", "first_unknown" } } );
+    BOOST_REQUIRE_EQUAL( &other,
+        &registry.counter( "test_limit_total", "Limited", { { "method", "second_unknown" } } ) );
+    other.inc( 2 );
+
+    string const text = registry.exposition();
+    BOOST_REQUIRE( contains( text, "test_limit_total{method=\"other\"} 2\n" ) );
+    BOOST_REQUIRE( !contains( text, "first_unknown" ) );
+    // known label sets are kept
+    BOOST_REQUIRE( contains( text, "test_limit_total{method=\"0\"} 0\n" ) );
+}
+
+BOOST_AUTO_TEST_CASE( exporterServesRegistry ) {
+    Registry::instance().counter( "test_exporter_total", "Exported" ).inc( 5 );
+
+    int const port = 1024 + rand() % 64000;
+    skale::MetricsExporter exporter( "127.0.0.1", port );
+    BOOST_REQUIRE( exporter.start() );
+
+    skutils::http::client client( 4, "127.0.0.1", port );
+    auto response = client.Get( "/metrics" );
+    BOOST_REQUIRE( response );
+    BOOST_REQUIRE_EQUAL( response->status_, 200 );
+    BOOST_REQUIRE( response->get_header_value( "Content-Type" ).find( "text/plain" ) == 0 );
+    BOOST_REQUIRE( contains( response->body_, "# TYPE test_exporter_total counter\n"
+                                              "test_exporter_total 5\n" ) );
+    BOOST_REQUIRE_EQUAL( response->body_, Registry::instance().exposition() );
+
+    exporter.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,221 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RpcExecutor.cpp
+ * Routing and admission control of the RPC executor.
+ */
+
+#include <libskale/RpcExecutor.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace std;
+using namespace dev::test;
+using skale::RpcExecutor;
+
+namespace {
+
+RpcExecutor::Options singleThread() {
+    RpcExecutor::Options options;
+    options.threads = 1;
+    return options;
+}
+
+// keeps a worker busy with a call of _method until release()
+class BusyWorker {
+public:
+    explicit BusyWorker( RpcExecutor& _executor, string const& _method = "eth_call" ) {
+        std::promise< void > started;
+        m_call = std::async( std::launch::async, [this, &_executor, &started, _method]() {
+            return _executor.run( _method, [this, &started]() {
+                started.set_value();
+                m_release.get_future().wait();
+            } );
+        } );
+        started.get_future().wait();
+    }
+    ~BusyWorker() {
+        if ( !m_released )
+            release();
+    }
+
+    RpcExecutor::Status release() {
+        m_released = true;
+        m_release.set_value();
+        return m_call.get();
+    }
+
+private:
+    std::promise< void > m_release;
+    bool m_released = false;
+    std::future< RpcExecutor::Status > m_call;
+};
+
+void waitForQueueSize( RpcExecutor& _executor, size_t _size ) {
+    for ( int i = 0; i < 500 && _executor.queueSize() != _size; ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    BOOST_REQUIRE_EQUAL( _executor.queueSize(), _size );
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( RpcExecutorSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( routing ) {
+    RpcExecutor executor( singleThread() );
+    BOOST_REQUIRE( executor.handles( "eth_call" ) );
+    BOOST_REQUIRE( executor.handles( "eth_getLogs" ) );
+    BOOST_REQUIRE( executor.handles( "debug_traceBlockRange" ) );
+    BOOST_REQUIRE( !executor.handles( "eth_blockNumber" ) );
+
+    std::thread::id const caller = std::this_thread::get_id();
+    std::thread::id ranOn;
+    // other methods run on the calling thread
+    BOOST_REQUIRE( executor.run( "eth_blockNumber", [&]() {
+        ranOn = std::this_thread::get_id();
+    } ) == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( ranOn == caller );
+
+    BOOST_REQUIRE( executor.run( "eth_call", [&]() { ranOn = std::this_thread::get_id(); } ) ==
+                   RpcExecutor::Status::Done );
+    BOOST_REQUIRE( ranOn != caller );
+
+    // exceptions are passed to the caller
+    BOOST_REQUIRE_THROW(
+        executor.run( "eth_call", []() { throw std::runtime_error( "failed" ); } ),
+        std::runtime_error );
+
+    // without threads everything runs on the calling thread
+    RpcExecutor disabled( RpcExecutor::Options{} );
+    BOOST_REQUIRE( disabled.run( "eth_call", [&]() { ranOn = std::this_thread::get_id(); } ) ==
+                   RpcExecutor::Status::Done );
+    BOOST_REQUIRE( ranOn == caller );
+}
+
+BOOST_AUTO_TEST_CASE( optionsFromJson ) {
+    RpcExecutor::Options options = RpcExecutor::Options::fromJson( nlohmann::json::parse(
+        R"({"threads": 3, "maxQueueSize": 7, "maxQueueMilliseconds": 100,
+            "methods": {"eth_getBalance": {"priority": 5, "maxConcurrency": 2}}})" ) );
+    BOOST_REQUIRE_EQUAL( options.threads, 3 );
+    BOOST_REQUIRE_EQUAL( options.maxQueueSize, 7 );
+    BOOST_REQUIRE_EQUAL( options.maxQueueTime.count(), 100 );
+    // listed methods replace the default ones
+    BOOST_REQUIRE_EQUAL( options.methods.size(), 1 );
+    BOOST_REQUIRE_EQUAL( options.methods.at( "eth_getBalance" ).priority, 5 );
+    BOOST_REQUIRE_EQUAL( options.methods.at( "eth_getBalance" ).maxConcurrency, 2 );
+
+    RpcExecutor::Options const defaults = RpcExecutor::Options::fromJson( nlohmann::json() );
+    BOOST_REQUIRE_EQUAL( defaults.threads, 0 );
+    BOOST_REQUIRE( defaults.methods.count( "eth_call" ) );
+}
+
+BOOST_AUTO_TEST_CASE( queueFull ) {
+    RpcExecutor::Options options = singleThread();
+    options.maxQueueSize = 1;
+    options.maxQueueTime = std::chrono::seconds( 30 );
+    RpcExecutor executor( options );
+    BusyWorker busy( executor );
+
+    std::atomic< bool > queuedRan = false;
+    auto queued = std::async( std::launch::async, [&]() {
+        return executor.run( "eth_call", [&]() { queuedRan = true; } );
+    } );
+    waitForQueueSize( executor, 1 );
+
+    bool rejectedRan = false;
+    BOOST_REQUIRE( executor.run( "eth_call", [&]() { rejectedRan = true; } ) ==
+                   RpcExecutor::Status::Rejected );
+    BOOST_REQUIRE( !rejectedRan );
+
+    // methods not handled by the executor are not limited by its queue
+    bool otherRan = false;
+    BOOST_REQUIRE( executor.run( "eth_blockNumber", [&]() { otherRan = true; } ) ==
+                   RpcExecutor::Status::Done );
+    BOOST_REQUIRE( otherRan );
+
+    BOOST_REQUIRE( busy.release() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( queued.get() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( queuedRan );
+}
+
+BOOST_AUTO_TEST_CASE( expiredAndCancelled ) {
+    RpcExecutor::Options options = singleThread();
+    // longer than the interval of polling for cancellation
+    options.maxQueueTime = std::chrono::milliseconds( 300 );
+    RpcExecutor executor( options );
+    BusyWorker busy( executor );
+
+    bool ran = false;
+    BOOST_REQUIRE( executor.run( "eth_call", [&]() { ran = true; } ) ==
+                   RpcExecutor::Status::Expired );
+    BOOST_REQUIRE( executor.run(
+                       "eth_call", [&]() { ran = true; }, []() { return true; } ) ==
+                   RpcExecutor::Status::Cancelled );
+    BOOST_REQUIRE_EQUAL( executor.queueSize(), 0 );
+
+    BOOST_REQUIRE( busy.release() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( !ran );
+}
+
+BOOST_AUTO_TEST_CASE( priorityAndConcurrency ) {
+    RpcExecutor::Options options = singleThread();
+    options.threads = 2;
+    options.maxQueueTime = std::chrono::seconds( 30 );
+    options.methods = { { "low", { 0, 0 } }, { "high", { 1, 0 } }, { "trace", { 0, 1 } } };
+    RpcExecutor executor( options );
+
+    std::mutex mutex;
+    vector< string > order;
+    auto const call = [&]( string const& _method ) {
+        return std::async( std::launch::async, [&, _method]() {
+            return executor.run( _method, [&, _method]() {
+                std::lock_guard< std::mutex > lock( mutex );
+                order.push_back( _method );
+            } );
+        } );
+    };
+
+    // one trace runs at a time, so the second one waits though a worker is free
+    BusyWorker trace( executor, "trace" );
+    auto waitingTrace = call( "trace" );
+    waitForQueueSize( executor, 1 );
+    // and other methods take the free worker
+    BOOST_REQUIRE( call( "low" ).get() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE_EQUAL( executor.queueSize(), 1 );
+
+    // the other worker is busy too now
+    BusyWorker low( executor, "low" );
+    auto lowCall = call( "low" );
+    waitForQueueSize( executor, 2 );
+    auto highCall = call( "high" );
+    waitForQueueSize( executor, 3 );
+
+    BOOST_REQUIRE( low.release() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( lowCall.get() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( highCall.get() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( trace.release() == RpcExecutor::Status::Done );
+    BOOST_REQUIRE( waitingTrace.get() == RpcExecutor::Status::Done );
+    // the call of higher priority starts first though it was queued later
+    BOOST_REQUIRE( order == vector< string >( { "low", "high", "low", "trace" } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SubscriptionNotifications.cpp
+ * eth_subscription notifications made of results shared by all subscribers.
+ */
+
+#include <libdevcore/CommonJS.h>
+#include <libskale/httpserveroverride.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+using namespace skale::server::helper;
+
+namespace {
+
+// notification as every subscriber made it before results were shared
+string perSubscriberNotification( string const& _subscription, nlohmann::json const& _result ) {
+    nlohmann::json joParams = nlohmann::json::object();
+    joParams["subscription"] = _subscription;
+    joParams["result"] = _result;
+    nlohmann::json joNotification = nlohmann::json::object();
+    joNotification["jsonrpc"] = "2.0";
+    joNotification["method"] = "eth_subscription";
+    joNotification["params"] = joParams;
+    return joNotification.dump();
+}
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SubscriptionNotificationsSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( sharedResultIsByteIdentical ) {
+    LogEntry const log( Address( 0xabc ), { h256( 1 ), h256( 2 ) }, bytes{ 0x01, 0x02, 0xff } );
+    LocalisedLogEntry const entry( log, h256( 0x100 ), 42, h256( 0x200 ), 3, 7 );
+
+    nlohmann::json joLog = log_entry_to_json( entry );
+    joLog["blockHash"] = toJS( entry.blockHash );
+    joLog["blockNumber"] = toJS( entry.blockNumber );
+    string const strLog = joLog.dump();
+
+    // one serialized result is used for several subscriptions
+    for ( unsigned subscription : { 1u, 0x20000u, 0xffffffffu } ) {
+        string const strSubscription = toJS( subscription );
+        BOOST_REQUIRE_EQUAL( make_subscription_notification( strSubscription, strLog ),
+            perSubscriberNotification( strSubscription, joLog ) );
+    }
+
+    // results of other types, e.g. strings needing escapes and nested objects
+    nlohmann::json const joString = "0x\"quoted\"\n";
+    BOOST_REQUIRE_EQUAL( make_subscription_notification( "0x1", joString.dump() ),
+        perSubscriberNotification( "0x1", joString ) );
+    nlohmann::json const joHead = nlohmann::json::parse(
+        R"({"number":"0x2a","transactions":[],"uncles":[],"extraData":"0x"})" );
+    BOOST_REQUIRE_EQUAL( make_subscription_notification( "0x2", joHead.dump() ),
+        perSubscriberNotification( "0x2", joHead ) );
+}
+
+BOOST_AUTO_TEST_CASE( resultCacheSharesAndEvicts ) {
+    shared_result_cache cache( 3 );
+    int made = 0;
+    auto const make = [&made]( string const& _value ) {
+        return [&made, _value]() {
+            ++made;
+            return _value;
+        };
+    };
+
+    auto const first = cache.get( "a", make( "A" ) );
+    // the same event is serialized once
+    BOOST_REQUIRE_EQUAL( cache.get( "a", make( "other" ) ), first );
+    BOOST_REQUIRE_EQUAL( *first, "A" );
+    BOOST_REQUIRE_EQUAL( made, 1 );
+
+    cache.get( "b", make( "B" ) );
+    cache.get( "c", make( "C" ) );
+    BOOST_REQUIRE_EQUAL( cache.size(), 3 );
+    BOOST_REQUIRE_EQUAL( made, 3 );
+
+    // the oldest entry is evicted, a hit does not renew it
+    cache.get( "d", make( "D" ) );
+    BOOST_REQUIRE_EQUAL( cache.size(), 3 );
+    BOOST_REQUIRE_EQUAL( *cache.get( "b", make( "new B" ) ), "B" );
+    BOOST_REQUIRE_EQUAL( made, 4 );
+    auto const second = cache.get( "a", make( "new A" ) );
+    BOOST_REQUIRE_EQUAL( *second, "new A" );
+    BOOST_REQUIRE_EQUAL( made, 5 );
+    BOOST_REQUIRE_EQUAL( cache.size(), 3 );
+
+    // results given out before eviction stay valid
+    BOOST_REQUIRE_EQUAL( *first, "A" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
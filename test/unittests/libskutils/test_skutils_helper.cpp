@@ -623,7 +623,8 @@ test_server_proxygen::test_server_proxygen(
         : test_server( "proxygen", nListenPortHTTP4 )
 {
     skutils::http_pg::pg_on_request_handler_t fnHandler = [=]( const nlohmann::json& joIn,
-            const std::string& strOrigin, int ipVer, const std::string& strDstAddress, int nDstPort )
+            const std::string& /*strBody*/, const std::string& strOrigin, int ipVer,
+            const std::string& strDstAddress, int nDstPort )
             -> skutils::result_of_http_request {
         skutils::result_of_http_request rslt =
                 implHandleHttpRequest(
@@ -1,5 +1,6 @@
 #include <test/tools/libtesteth/TestHelper.h>
 #include "test_skutils_helper.h"
+#include <skutils/http_pg.h>
 #include <boost/test/unit_test.hpp>
 #include <test/tools/libtesteth/TestHelper.h>
 
@@ -120,3 +121,40 @@ BOOST_AUTO_TEST_CASE( https_busy_port ) {
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( proxygen_encoding )
+
+using skutils::http_pg::g_nCompressionMinSize;
+using skutils::http_pg::negotiate_encoding;
+
+BOOST_AUTO_TEST_CASE( compression_threshold ) {
+    BOOST_REQUIRE( negotiate_encoding( "gzip", g_nCompressionMinSize - 1 ).empty() );
+    BOOST_REQUIRE( negotiate_encoding( "gzip, zstd", 0 ).empty() );
+    BOOST_REQUIRE_EQUAL( negotiate_encoding( "gzip", g_nCompressionMinSize ), "gzip" );
+}
+
+BOOST_AUTO_TEST_CASE( zstd_over_gzip ) {
+    // zstd is used only if folly was built with it
+    bool const bZstd = !negotiate_encoding( "zstd", g_nCompressionMinSize ).empty();
+    std::string const strPreferred = bZstd ? "zstd" : "gzip";
+    BOOST_REQUIRE_EQUAL( negotiate_encoding( "gzip, zstd", g_nCompressionMinSize ), strPreferred );
+    BOOST_REQUIRE_EQUAL(
+        negotiate_encoding( "ZSTD;q=0.5, gzip;q=1.0", g_nCompressionMinSize ), strPreferred );
+    BOOST_REQUIRE_EQUAL( negotiate_encoding( "*", g_nCompressionMinSize ), "gzip" );
+}
+
+BOOST_AUTO_TEST_CASE( refused_encodings ) {
+    BOOST_REQUIRE_EQUAL( negotiate_encoding( "zstd;q=0, gzip", g_nCompressionMinSize ), "gzip" );
+    BOOST_REQUIRE( negotiate_encoding( "gzip;q=0", g_nCompressionMinSize ).empty() );
+    BOOST_REQUIRE( negotiate_encoding( "gzip; q=0.000, zstd;q=0", g_nCompressionMinSize ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( identity_only_client ) {
+    BOOST_REQUIRE( negotiate_encoding( "", g_nCompressionMinSize ).empty() );
+    BOOST_REQUIRE( negotiate_encoding( "identity", g_nCompressionMinSize ).empty() );
+    BOOST_REQUIRE( negotiate_encoding( "identity, br, deflate", g_nCompressionMinSize ).empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -31,6 +31,7 @@
 #include <libethereum/ClientTest.h>
 #include <libethereum/SchainPatch.h>
 #include <libethereum/TransactionQueue.h>
+#include <libevm/Instruction.h>
 #include <libp2p/Network.h>
 #include <libskale/httpserveroverride.h>
 #include <libweb3jsonrpc/AccountHolder.h>
@@ -42,6 +43,7 @@
 #include <libweb3jsonrpc/ModularServer.h>
 #include <libweb3jsonrpc/Net.h>
 #include <libweb3jsonrpc/Test.h>
+#include <libweb3jsonrpc/Tracing.h>
 #include <libweb3jsonrpc/Web3.h>
 #include <test/tools/libtesteth/TestHelper.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
@@ -4003,6 +4005,148 @@ BOOST_AUTO_TEST_CASE( skip_invalid_transactions ) {
 }
 
 
+#ifdef HISTORIC_STATE
+BOOST_AUTO_TEST_CASE( tracing_rlpFormat ) {
+    JsonRpcFixture fixture;
+    auto address = fixture.coinbase.address();
+    dev::eth::simulateMining( *( fixture.client ), 1 );
+
+    // contract creation, so that both tracers have something to report
+    Json::Value t;
+    t["from"] = toJS( address );
+    t["data"] = "0x60006000f3";  // returns empty code
+    t["gas"] = toJS( 100000 );
+    t["gasPrice"] = toJS( 10 * dev::eth::szabo );
+    string const txHash = fixture.rpcClient->eth_sendTransaction( t );
+    dev::eth::mineTransaction( *( fixture.client ), 1 );
+    string const blockNumber = toJS( fixture.client->number() );
+
+    rpc::Tracing tracing( *fixture.client );
+    for ( string const tracer : { "callTracer", "4byteTracer" } ) {
+        Json::Value config;
+        config["tracer"] = tracer;
+        config["format"] = "rlp";
+
+        // the block is a list of [txHash, trace] pairs
+        Json::Value const block = tracing.tracing_traceBlockByNumber( blockNumber, config );
+        BOOST_REQUIRE( block.isString() );
+        bytes const blockBytes = fromHex( block.asString() );
+        RLP const blockRLP( blockBytes );
+        BOOST_REQUIRE( blockRLP.isList() );
+        BOOST_REQUIRE_EQUAL( blockRLP.itemCount(), 1 );
+        BOOST_REQUIRE_EQUAL( blockRLP[0].itemCount(), 2 );
+        BOOST_REQUIRE( blockRLP[0][0].toHash< h256 >() == h256( txHash ) );
+
+        RLP const trace = blockRLP[0][1];
+        if ( tracer == "callTracer" ) {
+            BOOST_REQUIRE_EQUAL( trace.itemCount(), 12 );
+            BOOST_REQUIRE_EQUAL( trace[0].toInt< uint64_t >(), uint64_t( Instruction::CREATE ) );
+            BOOST_REQUIRE( trace[1].toHash< Address >() == address );
+        } else {
+            // [selector, argument data size, count]
+            BOOST_REQUIRE_EQUAL( trace.itemCount(), 1 );
+            BOOST_REQUIRE( trace[0][0].toBytes() == fromHex( "60006000" ) );
+            BOOST_REQUIRE_EQUAL( trace[0][1].toInt< uint64_t >(), 1 );
+            BOOST_REQUIRE_EQUAL( trace[0][2].toInt< uint64_t >(), 1 );
+        }
+
+        // the transaction trace is the entry of its block trace
+        Json::Value const transaction = tracing.tracing_traceTransaction( txHash, config );
+        BOOST_REQUIRE( transaction.isString() );
+        BOOST_REQUIRE( fromHex( transaction.asString() ) == trace.data().toBytes() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( tracing_prestateStorage ) {
+    JsonRpcFixture fixture;
+    auto address = fixture.coinbase.address();
+    dev::eth::simulateMining( *( fixture.client ), 1 );
+
+    auto deploy = [&]( string const& _initCode ) {
+        Json::Value t;
+        t["from"] = toJS( address );
+        t["data"] = _initCode;
+        t["gas"] = toJS( 1000000 );
+        t["gasPrice"] = toJS( 10 * dev::eth::szabo );
+        string const txHash = fixture.rpcClient->eth_sendTransaction( t );
+        dev::eth::mineTransaction( *( fixture.client ), 1 );
+        Json::Value const receipt = fixture.rpcClient->eth_getTransactionReceipt( txHash );
+        return receipt["contractAddress"].asString();
+    };
+
+    // storage 0 = 1, 1 = 2, 2 = 3, code:
+    //   sstore(0, 5) sstore(0, 1)
+    //   call(gas, calldataload(0), 0, 0, 0, 0, 0)
+    //   delegatecall(gas, calldataload(0x20), 0, 0, 0, 0)
+    string const store = deploy(
+        "0x6001600055600260015560036002556029601b60003960296000f36005600055600160005560006000"
+        "6000600060006000355af15060006000600060006020355af45000" );
+    // storage 0 = 4, code: sstore(0, 9) revert(0, 0)
+    string const reverter =
+        deploy( "0x6004600055600a6011600039600a6000f3600960005560006000fd" );
+    // code: sstore(1, 7)
+    string const library = deploy( "0x6006600c60003960066000f3600760015500" );
+
+    Json::Value t;
+    t["from"] = toJS( address );
+    t["to"] = store;
+    t["data"] = "0x" + toHex( h256( jsToAddress( reverter ), h256::AlignRight ) ) +
+                toHex( h256( jsToAddress( library ), h256::AlignRight ) );
+    t["gas"] = toJS( 1000000 );
+    t["gasPrice"] = toJS( 10 * dev::eth::szabo );
+    string const txHash = fixture.rpcClient->eth_sendTransaction( t );
+    dev::eth::mineTransaction( *( fixture.client ), 1 );
+    BOOST_REQUIRE_EQUAL(
+        fixture.rpcClient->eth_getTransactionReceipt( txHash )["status"], string( "0x1" ) );
+    string const blockBefore = toJS( fixture.client->number() - 1 );
+
+    auto slot = []( unsigned _key ) { return toHexPrefixed( u256( _key ) ); };
+    // pre values the tracer recorded are the values of the previous block
+    auto checkPre = [&]( string const& _address, Json::Value const& _storage ) {
+        for ( string const& key : _storage.getMemberNames() )
+            BOOST_CHECK_EQUAL( jsToU256( _storage[key].asString() ),
+                jsToU256( fixture.rpcClient->eth_getStorageAt( _address, key, blockBefore ) ) );
+    };
+
+    rpc::Tracing tracing( *fixture.client );
+    Json::Value config;
+    config["tracer"] = "prestateTracer";
+    Json::Value const prestate = tracing.tracing_traceTransaction( txHash, config );
+
+    // slot 0 was written and reset, slot 1 was written by the library in the store context,
+    // slot 2 was never accessed
+    Json::Value const& storeStorage = prestate[store]["storage"];
+    BOOST_REQUIRE_EQUAL( storeStorage.size(), 2 );
+    BOOST_CHECK_EQUAL( storeStorage[slot( 0 )].asString(), slot( 1 ) );
+    BOOST_CHECK_EQUAL( storeStorage[slot( 1 )].asString(), slot( 2 ) );
+    BOOST_CHECK( !storeStorage.isMember( slot( 2 ) ) );
+    checkPre( store, storeStorage );
+    // write of the reverted frame does not change the pre value
+    Json::Value const& reverterStorage = prestate[reverter]["storage"];
+    BOOST_REQUIRE_EQUAL( reverterStorage.size(), 1 );
+    BOOST_CHECK_EQUAL( reverterStorage[slot( 0 )].asString(), slot( 4 ) );
+    checkPre( reverter, reverterStorage );
+    // delegatecall storage belongs to the caller
+    BOOST_CHECK( !prestate[library].isMember( "storage" ) );
+
+    config["tracerConfig"]["diffMode"] = true;
+    Json::Value const diff = tracing.tracing_traceTransaction( txHash, config );
+    Json::Value const& pre = diff["pre"];
+    Json::Value const& post = diff["post"];
+
+    // only the slot changed by the library is in the diff
+    BOOST_REQUIRE_EQUAL( pre[store]["storage"].size(), 1 );
+    BOOST_CHECK_EQUAL( pre[store]["storage"][slot( 1 )].asString(), slot( 2 ) );
+    checkPre( store, pre[store]["storage"] );
+    BOOST_REQUIRE_EQUAL( post[store]["storage"].size(), 1 );
+    BOOST_CHECK_EQUAL( post[store]["storage"][slot( 1 )].asString(), slot( 7 ) );
+    for ( string const& account : { reverter, library } ) {
+        BOOST_CHECK( !pre[account].isMember( "storage" ) );
+        BOOST_CHECK( !post[account].isMember( "storage" ) );
+    }
+}
+#endif
+
 BOOST_FIXTURE_TEST_SUITE( RestrictedAddressSuite, RestrictedAddressFixture )
 
 BOOST_AUTO_TEST_CASE( direct_call ) {
@@ -4129,6 +4273,79 @@ BOOST_AUTO_TEST_CASE( delegate_call ) {
     BOOST_REQUIRE( !boost::filesystem::exists( path ) );
 }
 
+// HTTP request handling of the server, without listening
+class HttpRequestDispatcher : public SkaleServerOverride {
+public:
+    using SkaleServerOverride::SkaleServerOverride;
+
+    // the old path dispatched requests serialized again instead of as received
+    nlohmann::json answer( string const& _body, e_server_mode_t _esm, bool _asReceived ) {
+        nlohmann::json const joIn = nlohmann::json::parse( _body );
+        skutils::result_of_http_request const rslt = implHandleHttpRequest(
+            joIn, _asReceived ? _body : joIn.dump(), "HTTP", 0, "http://127.0.0.1", 4, 80, _esm );
+        BOOST_REQUIRE( !rslt.isBinary_ );
+        return nlohmann::json::parse( rslt.strOut_ );
+    }
+};
+
+BOOST_AUTO_TEST_CASE( http_requests_as_received ) {
+    JsonRpcFixture fixture;
+    dev::eth::simulateMining( *( fixture.client ), 1 );
+    string const address = toJS( fixture.coinbase.address() );
+
+    rpc::Eth eth( "", *fixture.client, *fixture.accountHolder );
+    SkaleServerOverride::opts_t opts;
+    inject_rapidjson_handlers( opts, &eth );
+    auto dispatcher = new HttpRequestDispatcher( fixture.chainParams, fixture.client.get(), opts );
+    fixture.rpcServer->addConnector( dispatcher );
+
+    // protocol specific, informational and generic methods, formatted unlike dump() does
+    vector< string > const requests = {
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"eth_getBalance\", \"params\": [ \"" + address +
+            "\", \"latest\" ], \"id\": 1 }",
+        "{ \"method\": \"eth_getTransactionCount\", \"jsonrpc\": \"2.0\", \"id\": 2,\n"
+        "  \"params\": [ \"" + address + "\", \"latest\" ] }",
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"eth_getCode\", \"params\": [ \"" + address +
+            "\", \"latest\" ], \"id\": \"three\" }",
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"eth_call\", \"params\": [ { \"to\": \"" + address +
+            "\", \"data\": \"0x\" }, \"latest\" ], \"id\": 4 }",
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"eth_blockNumber\", \"params\": [], \"id\": 5 }",
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"web3_clientVersion\", \"params\": [], \"id\": 6 }",
+        "{ \"jsonrpc\": \"2.0\", \"method\": \"eth_noSuchMethod\", \"params\": [], \"id\": 7 }" };
+
+    for ( e_server_mode_t esm :
+        { e_server_mode_t::esm_standard, e_server_mode_t::esm_informational } ) {
+        nlohmann::json jarrOld = nlohmann::json::array();
+        string strBatch;
+        for ( string const& request : requests ) {
+            nlohmann::json const joAnswer = dispatcher->answer( request, esm, true );
+            BOOST_CHECK( joAnswer.count( "result" ) > 0 || joAnswer.count( "error" ) > 0 );
+            BOOST_CHECK_EQUAL( joAnswer, dispatcher->answer( request, esm, false ) );
+            jarrOld.push_back( joAnswer );
+            strBatch += ( strBatch.empty() ? "[ " : ",\n" ) + request;
+        }
+        // batch answer is assembled as text from the answers of items
+        BOOST_CHECK_EQUAL( dispatcher->answer( strBatch + " ]", esm, true ), jarrOld );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( stats_method_names ) {
+    JsonRpcFixture fixture;
+    SkaleServerOverride::opts_t opts;
+    opts.setKnownMethods_ = fixture.rpcServer->methodNames();
+    auto dispatcher = new HttpRequestDispatcher( fixture.chainParams, fixture.client.get(), opts );
+    fixture.rpcServer->addConnector( dispatcher );
+
+    // methods of the handler and of the server's own tables keep their names
+    for ( string const& method : { "eth_blockNumber", "eth_getBalance", "web3_clientVersion" } )
+        BOOST_CHECK_EQUAL( dispatcher->statsMethodName( method ), method );
+    // names clients make up never get records of their own, however many were seen before
+    for ( size_t i = 0; i < 5000; ++i )
+        BOOST_CHECK_EQUAL(
+            dispatcher->statsMethodName( "junk_" + to_string( i ) ), string( "<other>" ) );
+    BOOST_CHECK_EQUAL( dispatcher->statsMethodName( "eth_getCode" ), string( "eth_getCode" ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( FilestorageCacheSuite )
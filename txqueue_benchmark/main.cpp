@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2023-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file main.cpp
+ * Measures import, proposal and drop throughput of TransactionQueue with many pending
+ * transactions.
+ * Usage: txqueue_benchmark [transactions = 100000] [senders = 1000] [proposal size = 1000]
+ */
+
+#include <libdevcrypto/Common.h>
+#include <libethereum/TransactionQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace {
+
+double seconds_since( chrono::steady_clock::time_point _start ) {
+    return chrono::duration< double >( chrono::steady_clock::now() - _start ).count();
+}
+
+void report( char const* _what, size_t _count, double _seconds ) {
+    cout << _what << ": " << _count << " in " << _seconds << " s, " << _count / _seconds
+         << " per second" << endl;
+}
+
+}  // namespace
+
+int main( int argc, char** argv ) {
+    size_t const transactionCount = argc > 1 ? stoul( argv[1] ) : 100000;
+    size_t const senderCount = argc > 2 ? stoul( argv[2] ) : 1000;
+    size_t const proposalSize = argc > 3 ? stoul( argv[3] ) : 1000;
+
+    cout << "Signing " << transactionCount << " transactions of " << senderCount << " senders"
+         << endl;
+    vector< KeyPair > senders;
+    for ( size_t i = 0; i < senderCount; ++i )
+        senders.push_back( KeyPair::create() );
+
+    // nonces of each sender go in order, gas prices vary so that the ordering has work to do
+    mt19937 random( 13 );
+    uniform_int_distribution< unsigned > gasPrices( 1, 100 );
+    vector< u256 > nonces( senderCount );
+    Transactions transactions;
+    transactions.reserve( transactionCount );
+    for ( size_t i = 0; i < transactionCount; ++i ) {
+        size_t const sender = i % senderCount;
+        transactions.emplace_back( 0, gasPrices( random ) * szabo, 21000,
+            Address( unsigned( sender + 1 ) ), bytes(), nonces[sender]++, senders[sender].secret() );
+        // recover sender now to measure the queue rather than ECDSA
+        transactions.back().sender();
+    }
+
+    TransactionQueue tq( transactionCount, transactionCount, 1u << 30, 1u << 30 );
+
+    // readers of pending nonces run all the time, as RPC does under load
+    atomic_bool stop{ false };
+    atomic< size_t > nonceReads{ 0 };
+    thread reader( [&]() {
+        size_t i = 0;
+        while ( !stop ) {
+            tq.maxNonce( senders[i++ % senderCount].address() );
+            ++nonceReads;
+        }
+    } );
+
+    auto start = chrono::steady_clock::now();
+    for ( Transaction const& t : transactions )
+        tq.import( t );
+    report( "Import", transactionCount, seconds_since( start ) );
+
+    size_t const proposals = 100;
+    start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < proposals; ++i )
+        tq.topTransactions( proposalSize );
+    report( "Proposal", proposals, seconds_since( start ) );
+
+    // blocks take top transactions and drop them until the queue is empty
+    size_t dropped = 0;
+    start = chrono::steady_clock::now();
+    for ( ;; ) {
+        Transactions block = tq.topTransactions( proposalSize );
+        if ( block.empty() )
+            break;
+        for ( Transaction const& t : block )
+            tq.dropGood( t );
+        dropped += block.size();
+    }
+    report( "Drop", dropped, seconds_since( start ) );
+
+    stop = true;
+    reader.join();
+    cout << "Pending nonce reads during the run: " << nonceReads << endl;
+    return 0;
+}